@@ -0,0 +1,110 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include "alloc_counter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<uint64_t> allocations{0};
+std::atomic<uint64_t> allocated_bytes{0};
+
+void* counted_alloc(std::size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+  if (auto* ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void* counted_aligned_alloc(std::size_t size, std::align_val_t align) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+  auto const alignment = static_cast<std::size_t>(align);
+  // aligned_alloc requires the size to be a multiple of the alignment.
+  auto const rounded = (size + alignment - 1) / alignment * alignment;
+  if (auto* ptr = std::aligned_alloc(alignment, rounded == 0 ? alignment
+                                                             : rounded)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+}  // namespace
+
+// Replace the global allocation functions so every heap allocation made by
+// the library (and by Boost, Poco and the standard library) is counted.
+void* operator new(std::size_t size) {
+  return counted_alloc(size);
+}
+
+void* operator new[](std::size_t size) {
+  return counted_alloc(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t align) {
+  return counted_aligned_alloc(size, align);
+}
+
+void* operator new[](std::size_t size, std::align_val_t align) {
+  return counted_aligned_alloc(size, align);
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t /*size*/) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t /*align*/) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t /*align*/) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t /*size*/,
+                     std::align_val_t /*align*/) noexcept {
+  std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t /*size*/,
+                       std::align_val_t /*align*/) noexcept {
+  std::free(ptr);
+}
+
+namespace taktile::bench {
+
+AllocationCount allocation_count() {
+  return {allocations.load(std::memory_order_relaxed),
+          allocated_bytes.load(std::memory_order_relaxed)};
+}
+
+AllocationReporter::AllocationReporter(benchmark::State& state)
+    : state_{state}, start_{allocation_count()} {}
+
+AllocationReporter::~AllocationReporter() {
+  auto const end = allocation_count();
+  state_.counters["allocs/op"] = benchmark::Counter(
+      static_cast<double>(end.allocations - start_.allocations),
+      benchmark::Counter::kAvgIterations);
+  state_.counters["bytes/op"] =
+      benchmark::Counter(static_cast<double>(end.bytes - start_.bytes),
+                         benchmark::Counter::kAvgIterations);
+}
+
+}  // namespace taktile::bench
@@ -0,0 +1,38 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+namespace taktile::bench {
+
+/// @brief Heap allocation totals seen by the counting operator new
+struct AllocationCount {
+  uint64_t allocations{0};
+  uint64_t bytes{0};
+};
+
+/// @brief Totals since process start, across all threads
+AllocationCount allocation_count();
+
+/// @brief Report ns/op alongside heap allocations and bytes per iteration
+/// @details Construct after setup and before the benchmark loop; the counters
+///          are attached to the state on destruction.
+class AllocationReporter {
+ public:
+  explicit AllocationReporter(benchmark::State &state);
+  ~AllocationReporter();
+
+  AllocationReporter(AllocationReporter const &) = delete;
+  AllocationReporter(AllocationReporter &&) = delete;
+  AllocationReporter &operator=(AllocationReporter const &) = delete;
+  AllocationReporter &operator=(AllocationReporter &&) = delete;
+
+ private:
+  benchmark::State &state_;
+  AllocationCount start_;
+};
+
+}  // namespace taktile::bench
@@ -0,0 +1,604 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include <benchmark/benchmark.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <optional>
+#include <simpleio/messages/xml.hpp>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "alloc_counter.hpp"
+#include "taktile/bulk_load.hpp"
+#include "taktile/capture.hpp"
+#include "taktile/compact_cot.hpp"
+#include "taktile/cot_batch.hpp"
+#include "taktile/cot_template.hpp"
+#include "taktile/cot_view.hpp"
+#include "taktile/datetime.hpp"
+#include "taktile/functions.hpp"
+#include "taktile/metrics.hpp"
+#include "taktile/pipeline.hpp"
+#include "taktile/relay.hpp"
+#include "taktile/spatial_index.hpp"
+#include "taktile/suppression.hpp"
+#include "taktile/tak_proto.hpp"
+#include "taktile/track_store.hpp"
+#include "taktile/xml_parser.hpp"
+#include "taktile/xml_writer.hpp"
+
+namespace {
+
+using taktile::bench::AllocationReporter;
+
+// A device-style uid, as ATAK clients send; too long for the small-string
+// buffer, so every std::string copy of it allocates.
+std::string const LONG_UID{"ANDROID-589520ccfcd20f01"};
+
+taktile::CotType sample_cot(std::string uid = "bench_uid") {
+  auto cot = taktile::CotType(std::move(uid));
+  cot.lat = 37.7749;
+  cot.lon = -122.4194;
+  cot.le = 10;
+  cot.hae = 100;
+  cot.ce = 5;
+  cot.cot_type = "a-f-G-U-C";
+  return cot;
+}
+
+std::vector<std::byte> sample_blob(std::string uid = "bench_uid") {
+  auto serializer = taktile::CotDirectXmlSerializer();
+  return serializer.serialize(sample_cot(std::move(uid)));
+}
+
+taktile::CotBatch sample_batch(std::size_t rows) {
+  taktile::CotBatch batch;
+  for (std::size_t i = 0; i < rows; ++i) {
+    auto cot = sample_cot("track-" + std::to_string(i));
+    cot.lat += static_cast<double>(i % 100) * 0.001;
+    batch.push_back(cot);
+  }
+  return batch;
+}
+
+std::shared_ptr<taktile::CotXmlSerializer> dom_serializer() {
+  return std::make_shared<taktile::CotXmlSerializer>(
+      std::make_shared<simpleio::messages::XmlSerializer>());
+}
+
+}  // namespace
+
+static void BM_URL_parse(benchmark::State& state, std::string const& url) {
+  AllocationReporter const reporter{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(taktile::URL(url));
+  }
+}
+BENCHMARK_CAPTURE(BM_URL_parse, https, std::string("https://example.com:8443"));
+BENCHMARK_CAPTURE(BM_URL_parse, tls, std::string("tls://example.com:8089"));
+BENCHMARK_CAPTURE(BM_URL_parse, tcp, std::string("tcp://example.com:8087"));
+BENCHMARK_CAPTURE(BM_URL_parse, udp, std::string("udp://239.2.3.1:6969"));
+BENCHMARK_CAPTURE(BM_URL_parse, udp_broadcast,
+                  std::string("udp+broadcast://255.255.255.255"));
+BENCHMARK_CAPTURE(BM_URL_parse, udp_write_only,
+                  std::string("udp+wo://239.2.3.1"));
+BENCHMARK_CAPTURE(BM_URL_parse, log, std::string("log://localhost"));
+
+static void BM_CotType_validate(benchmark::State& state) {
+  auto const cot = sample_cot();
+  AllocationReporter const reporter{state};
+  for (auto _ : state) {
+    taktile::CotType::validate(cot);
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_CotType_validate);
+
+static void BM_CotBatch_validate(benchmark::State& state) {
+  auto const batch = sample_batch(static_cast<std::size_t>(state.range(0)));
+  AllocationReporter const reporter{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(batch.validate());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CotBatch_validate)->Arg(4096);
+
+// Baseline for BM_CotBatch_serialize: the same rows written one CotType at a
+// time, each reading the clock.
+static void BM_CotType_serialize_each(benchmark::State& state) {
+  std::vector<taktile::CotType> cots;
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    cots.push_back(sample_cot("track-" + std::to_string(i)));
+  }
+  std::vector<std::byte> out(cots.size() * taktile::MAX_UDP_BLOB_SIZE);
+  AllocationReporter const reporter{state};
+  for (auto _ : state) {
+    std::size_t used = 0;
+    for (auto const& cot : cots) {
+      used += taktile::write_cot_xml(cot, out.data() + used,
+                                     taktile::MAX_UDP_BLOB_SIZE);
+    }
+    benchmark::DoNotOptimize(used);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CotType_serialize_each)->Arg(4096);
+
+static void BM_CotBatch_serialize(benchmark::State& state) {
+  auto const batch = sample_batch(static_cast<std::size_t>(state.range(0)));
+  std::vector<std::byte> out;
+  std::vector<std::size_t> ends;
+  AllocationReporter const reporter{state};
+  for (auto _ : state) {
+    taktile::write_cot_xml(batch, out, ends);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_CotBatch_serialize)->Arg(4096);
+
+static void BM_CotType_get_time(benchmark::State& state) {
+  AllocationReporter const reporter{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(taktile::CotType::get_time());
+  }
+}
+BENCHMARK(BM_CotType_get_time);
+
+static void BM_Cot2Xml_convert_to_xml(benchmark::State& state) {
+  auto const cot = sample_cot();
+  AllocationReporter const reporter{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(taktile::Cot2Xml::convert(cot));
+  }
+}
+BENCHMARK(BM_Cot2Xml_convert_to_xml);
+
+static void BM_Cot2Xml_convert_from_xml(benchmark::State& state) {
+  auto const xml =
+      simpleio::messages::XmlSerializer().deserialize(sample_blob());
+  AllocationReporter const reporter{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(taktile::Cot2Xml::convert(xml));
+  }
+}
+BENCHMARK(BM_Cot2Xml_convert_from_xml);
+
+static void BM_CotXmlSerializer_serialize(benchmark::State& state) {
+  auto serializer = dom_serializer();
+  auto const cot = sample_cot();
+  AllocationReporter const reporter{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(serializer->serialize(cot));
+  }
+}
+BENCHMARK(BM_CotXmlSerializer_serialize);
+
+static void BM_CotXmlSerializer_deserialize(benchmark::State& state) {
+  auto serializer = dom_serializer();
+  auto const blob = sample_blob();
+  AllocationReporter const reporter{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(serializer->deserialize(blob));
+  }
+}
+BENCHMARK(BM_CotXmlSerializer_deserialize);
+
+static void BM_CotDirectXmlSerializer_serialize(benchmark::State& state) {
+  auto serializer = taktile::CotDirectXmlSerializer();
+  auto const cot = sample_cot();
+  AllocationReporter const reporter{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(serializer.serialize(cot));
+  }
+}
+BENCHMARK(BM_CotDirectXmlSerializer_serialize);
+
+static void BM_CotDirectXmlSerializer_deserialize(benchmark::State& state,
+                                                  std::string const& uid) {
+  auto serializer = taktile::CotDirectXmlSerializer();
+  auto const blob = sample_blob(uid);
+  AllocationReporter const reporter{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(serializer.deserialize(blob));
+  }
+}
+BENCHMARK_CAPTURE(BM_CotDirectXmlSerializer_deserialize, short_uid,
+                  std::string("bench_uid"));
+BENCHMARK_CAPTURE(BM_CotDirectXmlSerializer_deserialize, long_uid, LONG_UID);
+
+static void BM_CotProtoSerializer_serialize(benchmark::State& state) {
+  auto serializer = taktile::CotProtoSerializer();
+  auto const cot = sample_cot(LONG_UID);
+  AllocationReporter const reporter{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(serializer.serialize(cot));
+  }
+  state.counters["bytes"] =
+      static_cast<double>(serializer.serialize(cot).size());
+}
+BENCHMARK(BM_CotProtoSerializer_serialize);
+
+static void BM_CotProtoSerializer_deserialize(benchmark::State& state) {
+  auto serializer = taktile::CotProtoSerializer();
+  auto const blob = serializer.serialize(sample_cot(LONG_UID));
+  AllocationReporter const reporter{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(serializer.deserialize(blob));
+  }
+}
+BENCHMARK(BM_CotProtoSerializer_deserialize);
+
+static void BM_CotMessage_from_cot(benchmark::State& state) {
+  auto serializer = dom_serializer();
+  auto const cot = sample_cot();
+  AllocationReporter const reporter{state};
+  for (auto _ : state) {
+    // The message takes ownership, so the copy is part of the cost per op.
+    auto message = taktile::CotMessage<taktile::MAX_UDP_BLOB_SIZE>(
+        taktile::CotType(cot), serializer);
+    benchmark::DoNotOptimize(message);
+  }
+}
+BENCHMARK(BM_CotMessage_from_cot);
+
+static void BM_CotMessage_from_blob(benchmark::State& state) {
+  auto serializer = dom_serializer();
+  auto const blob = sample_blob();
+  AllocationReporter const reporter{state};
+  for (auto _ : state) {
+    // The message takes ownership, so the copy is part of the cost per op.
+    auto message = taktile::CotMessage<taktile::MAX_UDP_BLOB_SIZE>(
+        std::vector<std::byte>(blob), serializer);
+    benchmark::DoNotOptimize(message);
+  }
+}
+BENCHMARK(BM_CotMessage_from_blob);
+
+static void BM_InlineCotMessage_from_cot(benchmark::State& state) {
+  auto serializer = taktile::CotDirectXmlSerializer();
+  auto const cot = sample_cot();
+  // Reused across iterations, as a sender's staging message would be.
+  auto message = std::make_unique<
+      taktile::InlineCotMessage<taktile::MAX_UDP_BLOB_SIZE>>();
+  AllocationReporter const reporter{state};
+  for (auto _ : state) {
+    message->assign(cot, serializer);
+    benchmark::DoNotOptimize(message->data());
+  }
+}
+BENCHMARK(BM_InlineCotMessage_from_cot);
+
+static void BM_CotFilter_reject(benchmark::State& state) {
+  // sample_cot() is "a-f-G-U-C"; a hostile-only feed rejects it.
+  taktile::CotFilter filter;
+  filter.allow_type("a-h");
+  auto const blob = sample_blob();
+  AllocationReporter const reporter{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(filter.matches(taktile::CotView(blob)));
+  }
+}
+BENCHMARK(BM_CotFilter_reject);
+
+static void BM_CotRelayEvent_forward(benchmark::State& state) {
+  // An ATAK position report with the usual detail children.
+  std::string const xml =
+      "<event version=\"2.0\" uid=\"ANDROID-589520ccfcd20f01\" "
+      "type=\"a-f-G-U-C\" how=\"h-e\" time=\"2025-01-01T00:00:00.000Z\" "
+      "start=\"2025-01-01T00:00:00.000Z\" "
+      "stale=\"2025-01-01T00:02:00.000Z\"><point lat=\"37.7749\" "
+      "lon=\"-122.4194\" hae=\"12.0\" ce=\"9.9\" le=\"9999999.0\"/>"
+      "<detail><takv os=\"30\" version=\"4.8.1\" device=\"PIXEL 6\" "
+      "platform=\"ATAK-CIV\"/><contact endpoint=\"*:-1:stcp\" "
+      "callsign=\"TACO-1\"/><uid Droid=\"TACO-1\"/><precisionlocation "
+      "altsrc=\"GPS\" geopointsrc=\"GPS\"/><__group role=\"Team Member\" "
+      "name=\"Cyan\"/><status battery=\"88\"/><track course=\"90.0\" "
+      "speed=\"1.5\"/><_flow-tags_ "
+      "TAK-Server-1=\"2025-01-01T00:00:00.100Z\"/></detail></event>";
+  std::array<std::byte, taktile::MAX_UDP_BLOB_SIZE> buffer{};
+  AllocationReporter const reporter{state};
+  for (auto _ : state) {
+    taktile::CotRelayEvent const event{xml};
+    benchmark::DoNotOptimize(
+        event.write(taktile::now_ms(), buffer.data(), buffer.size()));
+  }
+}
+BENCHMARK(BM_CotRelayEvent_forward);
+
+static void BM_CotTemplate_emit(benchmark::State& state) {
+  taktile::CotTemplate const periodic{sample_cot(),
+                                      taktile::MAX_UDP_BLOB_SIZE};
+  std::array<std::byte, taktile::MAX_UDP_BLOB_SIZE> buffer{};
+  AllocationReporter const reporter{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(periodic.emit(taktile::now_ms(), 37.7749,
+                                           -122.4194, buffer.data(),
+                                           buffer.size()));
+  }
+}
+BENCHMARK(BM_CotTemplate_emit);
+
+static void BM_CompactCot_read(benchmark::State& state,
+                               std::string const& uid) {
+  taktile::StringInterner interner;
+  auto const blob = sample_blob(uid);
+  auto const xml =
+      std::string_view(reinterpret_cast<char const*>(blob.data()), blob.size());
+  AllocationReporter const reporter{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(taktile::read_compact_cot_xml(xml, interner));
+  }
+}
+BENCHMARK_CAPTURE(BM_CompactCot_read, short_uid, std::string("bench_uid"));
+BENCHMARK_CAPTURE(BM_CompactCot_read, long_uid, LONG_UID);
+
+static void BM_CompactCot_write(benchmark::State& state) {
+  taktile::StringInterner interner;
+  auto const cot = taktile::compact(sample_cot(), interner);
+  std::vector<std::byte> buffer(taktile::MAX_UDP_BLOB_SIZE);
+  AllocationReporter const reporter{state};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        taktile::write_cot_xml(cot, interner, buffer.data(), buffer.size()));
+  }
+}
+BENCHMARK(BM_CompactCot_write);
+
+// Threads share one registry, as they would taktile::metrics().
+static taktile::MetricsRegistry& bench_registry() {
+  static taktile::MetricsRegistry registry;
+  return registry;
+}
+
+static void BM_Counter_add(benchmark::State& state) {
+  auto& counter = bench_registry().counter("bench_total");
+  for (auto _ : state) {
+    counter.add();
+  }
+  benchmark::DoNotOptimize(counter.value());
+}
+BENCHMARK(BM_Counter_add)->Threads(1)->Threads(4);
+
+static void BM_LatencyHistogram_record(benchmark::State& state) {
+  auto& histogram = bench_registry().histogram("bench_seconds");
+  uint64_t sample{1000};
+  for (auto _ : state) {
+    histogram.record(sample);
+    sample = sample * 33 % 1000003;
+  }
+}
+BENCHMARK(BM_LatencyHistogram_record)->Threads(1)->Threads(4);
+
+static void BM_StageQueue_handoff(benchmark::State& state) {
+  // One batch of decoded messages through an SPSC (0) or MPMC (1) queue.
+  taktile::StageQueue<taktile::CotType> queue{1024, state.range(0) != 0};
+  std::vector<taktile::CotType> batch(64, sample_cot());
+  AllocationReporter const reporter{state};
+  for (auto _ : state) {
+    queue.push(batch.data(), batch.size());
+    batch.clear();
+    queue.pop(batch, 64);
+    benchmark::DoNotOptimize(batch.data());
+  }
+  state.SetItemsProcessed(state.iterations() * 64);
+}
+BENCHMARK(BM_StageQueue_handoff)->Arg(0)->Arg(1);
+
+static void BM_CaptureWriter_append(benchmark::State& state) {
+  // The per-datagram cost of always-on recording in CotUdpReceiver.
+  auto const path = "/tmp/bench_taktile_" + std::to_string(::getpid());
+  auto const blob = sample_blob(LONG_UID);
+  std::optional<taktile::CaptureWriter> writer;
+  writer.emplace(path);
+  int64_t time{0};
+  for (auto _ : state) {
+    if (!writer->append(++time, "udp://239.2.3.1:6969", blob.data(),
+                        blob.size())) {
+      state.PauseTiming();
+      writer.emplace(path);
+      state.ResumeTiming();
+    }
+  }
+  writer.reset();
+  ::unlink(path.c_str());
+  ::unlink((path + ".idx").c_str());
+  state.SetBytesProcessed(state.iterations() *
+                          static_cast<int64_t>(blob.size()));
+}
+BENCHMARK(BM_CaptureWriter_append);
+
+static void BM_Capture_replay_decode(benchmark::State& state) {
+  // Maximum-speed replay into the decoder: the decode path's throughput on
+  // recorded traffic.
+  auto const path = "/tmp/bench_taktile_" + std::to_string(::getpid());
+  constexpr int64_t RECORDS{10000};
+  {
+    taktile::CaptureWriter writer{path};
+    auto serializer = taktile::CotDirectXmlSerializer();
+    for (int64_t i = 0; i < RECORDS; ++i) {
+      auto const blob = serializer.serialize(
+          sample_cot("ANDROID-" + std::to_string(1000000 + i)));
+      writer.append(i, "udp://239.2.3.1:6969", blob.data(), blob.size());
+    }
+  }
+  taktile::CaptureReader reader{path};
+  auto serializer = taktile::CotDirectXmlSerializer();
+  taktile::ReplayOptions options;
+  options.speed = 0.0;
+  // Decoded from a reused buffer, as CotUdpReceiver decodes from its slots.
+  std::vector<std::byte> slot;
+  int64_t bytes{0};
+  for (auto _ : state) {
+    reader.rewind();
+    auto const stats = taktile::replay(
+        reader, options,
+        [&serializer, &slot](taktile::CaptureRecord const& record) {
+          slot.assign(record.data, record.data + record.size);
+          benchmark::DoNotOptimize(serializer.deserialize(slot));
+        });
+    bytes += static_cast<int64_t>(stats.bytes);
+  }
+  ::unlink(path.c_str());
+  ::unlink((path + ".idx").c_str());
+  state.SetItemsProcessed(state.iterations() * RECORDS);
+  state.SetBytesProcessed(bytes);
+}
+BENCHMARK(BM_Capture_replay_decode)->Unit(benchmark::kMillisecond);
+
+static void BM_bulk_load(benchmark::State& state) {
+  // Scaling of a parallel archive load with the number of workers.
+  auto const path = "/tmp/bench_taktile_" + std::to_string(::getpid());
+  constexpr int64_t EVENTS{100000};
+  {
+    std::ofstream out{path, std::ios::binary | std::ios::trunc};
+    auto serializer = taktile::CotDirectXmlSerializer();
+    for (int64_t i = 0; i < EVENTS; ++i) {
+      auto const blob = serializer.serialize(
+          sample_cot("ANDROID-" + std::to_string(1000000 + i % 1000)));
+      out.write(reinterpret_cast<char const*>(blob.data()),
+                static_cast<std::streamsize>(blob.size()));
+      out << '\n';
+    }
+  }
+  taktile::BulkLoadOptions options;
+  options.workers = static_cast<std::size_t>(state.range(0));
+  options.chunk_size = std::size_t{1} << 20;
+  uint64_t bytes{0};
+  for (auto _ : state) {
+    std::vector<taktile::CotType> events;
+    bytes += taktile::bulk_load(path, options, events).bytes;
+    benchmark::DoNotOptimize(events.data());
+  }
+  ::unlink(path.c_str());
+  state.SetItemsProcessed(state.iterations() * EVENTS);
+  state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+BENCHMARK(BM_bulk_load)
+    ->Arg(1)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+static void BM_TrackStore_upsert(benchmark::State& state) {
+  constexpr int TRACKS{100000};
+  auto const readers = state.range(0);
+  taktile::TrackStore store;
+  auto const now = taktile::now_ms();
+  std::vector<taktile::CotType> updates;
+  updates.reserve(TRACKS);
+  for (int i = 0; i < TRACKS; ++i) {
+    updates.push_back(sample_cot());
+    updates.back().uid = "track-" + std::to_string(i);
+    store.upsert(updates.back());
+  }
+  store.expire(now);
+
+  std::atomic<bool> done{false};
+  std::vector<std::thread> threads;
+  for (int64_t r = 0; r < readers; ++r) {
+    threads.emplace_back([&store, &done] {
+      while (!done.load(std::memory_order_relaxed)) {
+        benchmark::DoNotOptimize(store.snapshot().size());
+      }
+    });
+  }
+
+  std::size_t next{0};
+  int64_t time{now};
+  for (auto _ : state) {
+    // The copy of the update is part of the cost per op, as it is for a
+    // caller handing over a freshly decoded event.
+    auto cot = updates[next];
+    cot.time = ++time;
+    store.upsert(std::move(cot));
+    if (++next == updates.size()) {
+      next = 0;
+      // Republish snapshots the way a periodic expiry would.
+      state.PauseTiming();
+      store.expire(now);
+      state.ResumeTiming();
+    }
+  }
+  done = true;
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TrackStore_upsert)->Arg(0)->Arg(1)->Arg(4)->UseRealTime();
+
+static void BM_CotSuppressor_admit(benchmark::State& state) {
+  // Sensors reporting jitter well inside their error radius.
+  constexpr int TRACKS{10000};
+  static taktile::CotSuppressor suppressor;
+  std::vector<taktile::CotType> updates;
+  for (int i = 0; i < TRACKS; ++i) {
+    updates.push_back(sample_cot("sensor-" + std::to_string(i)));
+    updates.back().lat += (i % 7) * 1.0e-6;
+  }
+  std::size_t next{0};
+  int64_t passed{0};
+  auto const now = taktile::now_ms();
+  for (auto _ : state) {
+    passed += suppressor.admit(updates[next], now) ? 1 : 0;
+    next = next + 1 == updates.size() ? 0 : next + 1;
+  }
+  state.counters["passed"] = benchmark::Counter(
+      static_cast<double>(passed), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_CotSuppressor_admit)->Threads(1)->Threads(4);
+
+static void BM_SpatialIndex_move(benchmark::State& state) {
+  constexpr int TRACKS{100000};
+  taktile::SpatialIndex index;
+  std::vector<std::string> uids;
+  for (int i = 0; i < TRACKS; ++i) {
+    uids.push_back("track-" + std::to_string(i));
+    index.update(uids.back(), (i % 1000) * 0.1 - 50.0, (i / 1000) * 0.1);
+  }
+  std::size_t next{0};
+  double offset{0.0};
+  AllocationReporter const reporter{state};
+  for (auto _ : state) {
+    // Every update crosses into a neighbouring cell.
+    auto const i = static_cast<int>(next);
+    index.update(uids[next], (i % 1000) * 0.1 - 50.0 + offset,
+                 (i / 1000) * 0.1);
+    if (++next == uids.size()) {
+      next = 0;
+      offset = offset == 0.0 ? 0.1 : 0.0;
+    }
+  }
+}
+BENCHMARK(BM_SpatialIndex_move);
+
+static void BM_SpatialIndex_radius(benchmark::State& state) {
+  taktile::SpatialIndex index;
+  for (int i = 0; i < 100000; ++i) {
+    index.update("track-" + std::to_string(i), (i % 1000) * 0.01 + 30.0,
+                 (i / 1000) * 0.01 - 120.0);
+  }
+  std::size_t found{0};
+  AllocationReporter const reporter{state};
+  for (auto _ : state) {
+    index.for_each_within(
+        35.0, -119.5, 10000.0,
+        [&found](std::string const&, double, double) { ++found; });
+  }
+  benchmark::DoNotOptimize(found);
+}
+BENCHMARK(BM_SpatialIndex_radius);
+
+BENCHMARK_MAIN();
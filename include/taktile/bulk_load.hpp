@@ -0,0 +1,82 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "taktile/functions.hpp"
+#include "taktile/track_store.hpp"
+
+namespace taktile {
+
+/// @brief Threads and chunking of a bulk load
+struct BulkLoadOptions {
+  /// @brief Decoding threads, counting the calling thread; 0 uses one per
+  ///        core
+  std::size_t workers{0};
+  /// @brief Approximate bytes per chunk; each chunk ends after an </event>
+  std::size_t chunk_size{std::size_t{4} << 20};
+  /// @brief Streams of events the handler is called on concurrently
+  /// @details Events are assigned to a partition by a hash of their uid, so
+  ///          every event of a uid goes to the same partition.  1 hands the
+  ///          whole archive over in file order.
+  std::size_t partitions{1};
+};
+
+/// @brief Outcome of a bulk load
+struct BulkLoadStats {
+  uint64_t events{0};
+  /// @brief Records that could not be decoded and were skipped
+  uint64_t malformed{0};
+  uint64_t bytes{0};
+  uint64_t chunks{0};
+  /// @brief Wall-clock time the load took
+  double seconds{0.0};
+
+  [[nodiscard]] double events_per_second() const {
+    return seconds > 0.0 ? static_cast<double>(events) / seconds : 0.0;
+  }
+};
+
+/// @brief Called with the next decoded events of a partition
+/// @details Calls for one partition are made one at a time and in file
+///          order; calls for different partitions may run concurrently on
+///          any of the workers.
+using BulkLoadHandler =
+    std::function<void(std::size_t partition, std::vector<CotType> &&events)>;
+
+/// @brief Decode an archive of concatenated <event> documents in parallel
+/// @details The file is memory-mapped and split into chunks that end after
+///          an </event>, the way CotEventFramer splits a stream.  Workers
+///          take chunks in file order and decode each event in place with
+///          read_cot_xml.  A record that fails to decode is counted as
+///          malformed and skipped, as is trailing data without an </event>.
+/// @param path
+/// @param options
+/// @param handler
+/// @return counts for this load
+/// @throws std::system_error if the file cannot be opened or mapped
+/// @throws whatever the handler throws, after the workers have stopped
+BulkLoadStats bulk_load(std::string const &path,
+                        BulkLoadOptions const &options,
+                        BulkLoadHandler const &handler);
+
+/// @brief Append every event of an archive to events, in file order
+/// @details options.partitions is ignored.
+BulkLoadStats bulk_load(std::string const &path,
+                        BulkLoadOptions const &options,
+                        std::vector<CotType> &events);
+
+/// @brief Upsert every event of an archive into a track store
+/// @details Upserts run on the workers, one partition per worker unless
+///          options.partitions asks for more.  The events of a uid are
+///          still upserted in file order, so the store ends up as it would
+///          after a sequential load.
+BulkLoadStats bulk_load(std::string const &path,
+                        BulkLoadOptions const &options, TrackStore &store);
+
+}  // namespace taktile
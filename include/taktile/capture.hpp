@@ -0,0 +1,207 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace taktile {
+
+class CotStream;
+class CotUdpSender;
+
+/// @brief Sizes of a capture file
+struct CaptureOptions {
+  /// @brief Most bytes the file may hold
+  /// @details The whole size is mapped up front as a sparse file, so only
+  ///          pages that are written take up disk space.
+  std::size_t max_size{std::size_t{1} << 30};
+  /// @brief Bytes between index entries
+  std::size_t index_interval{std::size_t{1} << 16};
+};
+
+/// @brief One recorded event, pointing into the reader's mapping
+struct CaptureRecord {
+  /// @brief Receive time in nanoseconds since the Unix epoch
+  int64_t time{0};
+  /// @brief URL the event arrived on, as written by to_string(URL)
+  std::string_view source;
+  std::byte const *data{nullptr};
+  std::size_t size{0};
+};
+
+/// @brief Running totals of a CaptureWriter
+struct CaptureStats {
+  uint64_t records{0};
+  uint64_t bytes{0};
+  uint64_t dropped{0};
+};
+
+/// @brief Append-only, memory-mapped recorder of serialized CoT events
+/// @details Each record is a length-prefixed header (receive time, source
+///          URL) followed by the serialized event.  append() reserves space
+///          with a single atomic add and copies the record into the mapping,
+///          so any number of threads may record concurrently without a lock.
+///          The length is stored last, so a reader of a file whose writer
+///          died stops at the first incomplete record.  Every
+///          index_interval bytes the (time, offset) of a record is noted and
+///          written to path + ".idx" by close(), for CaptureReader::seek.
+class CaptureWriter {
+ public:
+  /// @brief Create (or truncate) a capture file
+  /// @throws std::invalid_argument if max_size is too small for the header
+  ///         or index_interval is 0
+  /// @throws std::system_error if the file cannot be created or mapped
+  explicit CaptureWriter(std::string path, CaptureOptions options = {});
+
+  /// @brief close()s the file
+  ~CaptureWriter();
+
+  CaptureWriter(CaptureWriter const &) = delete;
+  CaptureWriter(CaptureWriter &&) = delete;
+  CaptureWriter &operator=(CaptureWriter const &) = delete;
+  CaptureWriter &operator=(CaptureWriter &&) = delete;
+
+  /// @brief Record one serialized event; safe to call from many threads
+  /// @param time receive time in nanoseconds since the Unix epoch
+  /// @param source URL the event arrived on
+  /// @param data
+  /// @param size
+  /// @return false (counted as dropped) if the file is full or closed
+  bool append(int64_t time, std::string_view source, std::byte const *data,
+              std::size_t size);
+
+  /// @brief Trim the file to what was written and write the index
+  /// @details Must not race with append(); later appends are dropped.
+  void close();
+
+  [[nodiscard]] CaptureStats stats() const;
+
+  [[nodiscard]] std::string const &path() const {
+    return path_;
+  }
+
+ private:
+  std::string path_;
+  CaptureOptions options_;
+  int fd_{-1};
+  std::byte *map_{nullptr};
+  std::atomic<std::size_t> end_{0};
+  std::atomic<bool> closed_{false};
+  std::atomic<uint64_t> records_{0};
+  std::atomic<uint64_t> bytes_{0};
+  std::atomic<uint64_t> dropped_{0};
+  std::mutex index_mutex_;
+  // (time, offset) pairs, in the order their records were reserved.
+  std::vector<std::pair<int64_t, uint64_t>> index_;
+};
+
+/// @brief Sequential reader of a capture file, with seeking by time
+/// @details The file is mapped read-only and records are handed out as views
+///          into the mapping.  Not thread-safe.
+class CaptureReader {
+ public:
+  /// @brief Map a capture file and load its index
+  /// @details If there is no index file, as when the writer did not close
+  ///          cleanly, the index is rebuilt by walking the record headers.
+  /// @throws std::invalid_argument if the file is not a capture file
+  /// @throws std::system_error if the file cannot be opened or mapped
+  explicit CaptureReader(std::string const &path);
+
+  ~CaptureReader();
+
+  CaptureReader(CaptureReader const &) = delete;
+  CaptureReader(CaptureReader &&) = delete;
+  CaptureReader &operator=(CaptureReader const &) = delete;
+  CaptureReader &operator=(CaptureReader &&) = delete;
+
+  /// @brief The record at the current position, then advance past it
+  /// @return nothing at the end of the file
+  std::optional<CaptureRecord> next();
+
+  /// @brief Move to the first record received at or after time
+  /// @details Uses the index, then scans forward from the nearest earlier
+  ///          entry.  Records from concurrent writers may be out of order by
+  ///          the time it takes to copy one record, so this is only exact
+  ///          to within that.
+  /// @param time nanoseconds since the Unix epoch
+  void seek(int64_t time);
+
+  /// @brief Move back to the first record
+  void rewind();
+
+  /// @brief Bytes of records in the file
+  [[nodiscard]] std::size_t size() const {
+    return end_;
+  }
+
+ private:
+  void build_index();
+
+  int fd_{-1};
+  std::byte const *map_{nullptr};
+  std::size_t mapped_{0};
+  std::size_t end_{0};
+  std::size_t position_{0};
+  std::vector<std::pair<int64_t, uint64_t>> index_;
+};
+
+/// @brief Pacing and range of a replay
+struct ReplayOptions {
+  /// @brief Multiple of the recorded rate; 0 replays as fast as possible
+  double speed{1.0};
+  /// @brief First receive time replayed, in nanoseconds since the Unix epoch
+  int64_t from{0};
+  /// @brief Last receive time replayed
+  int64_t to{std::numeric_limits<int64_t>::max()};
+};
+
+/// @brief Outcome of a replay
+struct ReplayStats {
+  uint64_t records{0};
+  uint64_t bytes{0};
+  /// @brief Wall-clock time the replay took
+  double seconds{0.0};
+};
+
+/// @brief Called with each replayed record
+using ReplayHandler = std::function<void(CaptureRecord const &)>;
+
+/// @brief Re-emit records, keeping their recorded spacing divided by speed
+/// @details Starts from options.from (seeking if it is set) and stops at the
+///          end of the file or the first record after options.to.
+/// @param reader
+/// @param options
+/// @param emit called with each record, on the calling thread
+/// @param flush if set, called before every wait and at the end, so a
+///        batching transport sends what emit() queued
+/// @return counts for this replay
+/// @throws std::invalid_argument if speed is negative
+ReplayStats replay(CaptureReader &reader, ReplayOptions const &options,
+                   ReplayHandler const &emit,
+                   std::function<void()> const &flush = {});
+
+/// @brief Replay through a UDP sender
+/// @details Flushes every 64 records and before every wait.  Records the
+///          sender drops are counted in its stats as usual.
+ReplayStats replay(CaptureReader &reader, ReplayOptions const &options,
+                   CotUdpSender &sender);
+
+/// @brief Replay through a TCP or TLS stream
+/// @details Flushes every 64 records and before every wait.  When the
+///          stream's queue is full, the record is retried for up to a second
+///          before it is given up on; refusals count in its stats as usual.
+/// @throws std::system_error if the connection fails
+ReplayStats replay(CaptureReader &reader, ReplayOptions const &options,
+                   CotStream &stream);
+
+}  // namespace taktile
@@ -0,0 +1,93 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "taktile/functions.hpp"
+
+namespace taktile {
+
+/// @brief Compact handle of an interned string
+using InternId = uint32_t;
+
+/// @brief Append-only table that stores each distinct string once
+/// @details Strings are copied into large arena chunks and never move, so
+///          the views handed out stay valid for the interner's lifetime.
+///          There is no eviction: it is meant for the bounded vocabulary of
+///          uids and type codes a feed repeats.  Thread-safe: interning a
+///          string already present takes a shared lock only, and view()
+///          takes no lock at all.
+class StringInterner {
+ public:
+  StringInterner() = default;
+
+  StringInterner(StringInterner const &) = delete;
+  StringInterner(StringInterner &&) = delete;
+  StringInterner &operator=(StringInterner const &) = delete;
+  StringInterner &operator=(StringInterner &&) = delete;
+
+  /// @brief Id of text, storing it on first sight
+  InternId intern(std::string_view text);
+
+  /// @brief Id of text if it has been interned
+  [[nodiscard]] std::optional<InternId> find(std::string_view text) const;
+
+  /// @brief Text of an id
+  /// @throws std::out_of_range if the id was not issued by this interner
+  [[nodiscard]] std::string_view view(InternId id) const;
+
+  /// @brief Number of distinct strings
+  [[nodiscard]] std::size_t size() const {
+    return size_.load(std::memory_order_acquire);
+  }
+
+ private:
+  static constexpr std::size_t CHUNK_SIZE{64 * 1024};
+  // Segment k holds FIRST_SEGMENT << k views; together they cover every id.
+  static constexpr std::size_t FIRST_SEGMENT_BITS{10};
+  static constexpr std::size_t SEGMENTS{32 - FIRST_SEGMENT_BITS + 1};
+
+  mutable std::shared_mutex mutex_;
+  std::vector<std::unique_ptr<char[]>> chunks_;
+  std::size_t chunk_used_{CHUNK_SIZE};
+  std::unordered_map<std::string_view, InternId> ids_;
+  // Views by id, in segments that never move once published.
+  std::array<std::unique_ptr<std::string_view[]>, SEGMENTS> owned_;
+  std::array<std::atomic<std::string_view const *>, SEGMENTS> segments_{};
+  std::atomic<std::size_t> size_{0};
+};
+
+/// @brief CotType with its uid and type held as interned ids
+/// @details Trivially copyable and allocation-free; the strings live in the
+///          StringInterner the ids came from.
+struct CompactCot {
+  double lat{0.0};
+  double lon{0.0};
+  double ce{DEFAULT_COT_VAL};
+  double hae{DEFAULT_COT_VAL};
+  double le{DEFAULT_COT_VAL};
+  InternId uid{0};
+  InternId cot_type{0};
+  int64_t time{0};
+  int64_t start{0};
+  int64_t stale{0};
+};
+
+/// @brief Intern a CotType's strings
+CompactCot compact(CotType const &cot, StringInterner &interner);
+
+/// @brief Rebuild a CotType from its compact form
+/// @throws std::out_of_range if an id was not issued by interner
+CotType expand(CompactCot const &cot, StringInterner const &interner);
+
+}  // namespace taktile
@@ -3,44 +3,62 @@
 #pragma once
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
+#include <optional>
 #include <string>
 #include <string_view>
-#include <unordered_map>
 
 namespace taktile {
 static constexpr std::string_view VERSION = "0.0.0";
 
 enum class Scheme { HTTPS, TLS, TCP, UDP, UDP_BROADCAST, UDP_WRITE_ONLY, LOG };
 
-static const std::unordered_map<Scheme, std::string> SCHEME_FWD_MAP{
-    {Scheme::HTTPS, "https"},
-    {Scheme::TLS, "tls"},
-    {Scheme::TCP, "tcp"},
-    {Scheme::UDP, "udp"},
-    {Scheme::UDP_BROADCAST, "udp+broadcast"},
-    {Scheme::UDP_WRITE_ONLY, "udp+wo"},
-    {Scheme::LOG, "log"}};  // NOLINT[whitespace/indent_namespace]
-
-static const std::unordered_map<std::string, Scheme> SCHEME_INV_MAP{
-    {"https", Scheme::HTTPS},
-    {"tls", Scheme::TLS},
-    {"tcp", Scheme::TCP},
-    {"udp", Scheme::UDP},
-    {"udp+broadcast", Scheme::UDP_BROADCAST},
-    {"udp+wo", Scheme::UDP_WRITE_ONLY},
-    {"log", Scheme::LOG}};  // NOLINT[whitespace/indent_namespace]
+/// @brief Name of each Scheme in URLs, indexed by its value
+static constexpr std::array<std::string_view, 7> SCHEME_NAMES{
+    "https", "tls", "tcp", "udp", "udp+broadcast", "udp+wo", "log"};
+
+/// @brief Name of a scheme in URLs
+constexpr std::string_view scheme_name(Scheme scheme) {
+  return SCHEME_NAMES[static_cast<std::size_t>(scheme)];
+}
+
+/// @brief Scheme with a given name in URLs
+/// @return std::nullopt if no scheme has that name
+constexpr std::optional<Scheme> parse_scheme(std::string_view name) {
+  for (std::size_t i = 0; i < SCHEME_NAMES.size(); ++i) {
+    if (SCHEME_NAMES[i] == name) {
+      return static_cast<Scheme>(i);
+    }
+  }
+  return std::nullopt;
+}
+
+static_assert(SCHEME_NAMES.size() == static_cast<std::size_t>(Scheme::LOG) + 1);
+static_assert(scheme_name(Scheme::LOG) == "log");
+static_assert(parse_scheme("udp+wo") == Scheme::UDP_WRITE_ONLY);
 
 static const char* const DEFAULT_IPV4_ADDRESS{"239.2.3.1"};
 static constexpr uint16_t DEFAULT_BROADCAST_PORT{6969};
 static constexpr uint16_t DEFAULT_COT_PORT{8087};
 static constexpr uint32_t DEFAULT_COT_STALE{120};
 static constexpr double DEFAULT_COT_VAL{9999999.0};
-extern const std::string DEFAULT_HOST_ID;
 static const char* const DEFAULT_COT_TYPE{"a-u-G"};
-static const char* const W3C_XML_DATETIME{"{:%Y-%m-%dT%H:%M:%S}.{:03d}Z"};
+static constexpr size_t W3C_DATETIME_LENGTH{24};  // YYYY-MM-DDTHH:MM:SS.mmmZ
 static constexpr size_t MAX_UDP_BLOB_SIZE{1400};  // # of bytes
 static constexpr size_t MAX_TCP_BLOB_SIZE{64000};  // # of bytes
 static constexpr double LATITUDE_BOUND{90.0};  // degrees
 static constexpr double LONGITUDE_BOUND{180.0};  // degrees
+
+/// @brief Identity of this host, "taktile@<hostname>", used as the default
+///        uid and in flow tags
+/// @details The hostname is looked up on first use rather than when the
+///          library loads.  The reference stays valid for the life of the
+///          process, even after set_default_host_id().
+std::string const &default_host_id();
+
+/// @brief Override default_host_id(), for hosts whose name means nothing to
+///        receivers, such as containers
+/// @details Events created and flow tags written afterwards use the new id.
+void set_default_host_id(std::string host_id);
 }  // namespace taktile
@@ -0,0 +1,129 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "taktile/functions.hpp"
+
+namespace taktile {
+
+/// @brief Many CoT events stored column by column
+/// @details Each field of CotType is a contiguous column, so a producer that
+///          moves thousands of tracks per tick can update positions in place
+///          and validate or serialize them in one pass.  Rows are added with
+///          push_back() or resize() and edited through the column pointers,
+///          which stay valid until the batch is next resized.
+class CotBatch {
+ public:
+  /// @brief Append an event as a new row
+  void push_back(CotType const &cot);
+
+  /// @brief Grow or shrink to count rows
+  /// @details New rows hold CotType's defaults, but with an empty uid and
+  ///          zero timestamps; fill them in and restamp() before use.
+  void resize(std::size_t count);
+
+  void reserve(std::size_t count);
+
+  void clear() {
+    resize(0);
+  }
+
+  [[nodiscard]] std::size_t size() const {
+    return lat_.size();
+  }
+
+  /// @brief Copy a row out as a CotType
+  [[nodiscard]] CotType row(std::size_t i) const;
+
+  /// @brief Check every row as CotType::validate would
+  /// @details The numeric columns are checked several rows at a time with
+  ///          AVX2 or SSE2 when the CPU has them, and with scalar code
+  ///          otherwise.
+  /// @return one bit per row, set if the row is invalid; bit i of the result
+  ///         is bit i % 64 of word i / 64
+  [[nodiscard]] std::vector<uint64_t> validate() const;
+
+  [[nodiscard]] double *lat() {
+    return lat_.data();
+  }
+  [[nodiscard]] double const *lat() const {
+    return lat_.data();
+  }
+  [[nodiscard]] double *lon() {
+    return lon_.data();
+  }
+  [[nodiscard]] double const *lon() const {
+    return lon_.data();
+  }
+  [[nodiscard]] double *ce() {
+    return ce_.data();
+  }
+  [[nodiscard]] double const *ce() const {
+    return ce_.data();
+  }
+  [[nodiscard]] double *hae() {
+    return hae_.data();
+  }
+  [[nodiscard]] double const *hae() const {
+    return hae_.data();
+  }
+  [[nodiscard]] double *le() {
+    return le_.data();
+  }
+  [[nodiscard]] double const *le() const {
+    return le_.data();
+  }
+  [[nodiscard]] int64_t *time() {
+    return time_.data();
+  }
+  [[nodiscard]] int64_t const *time() const {
+    return time_.data();
+  }
+  [[nodiscard]] int64_t *start() {
+    return start_.data();
+  }
+  [[nodiscard]] int64_t const *start() const {
+    return start_.data();
+  }
+  [[nodiscard]] int64_t *stale() {
+    return stale_.data();
+  }
+  [[nodiscard]] int64_t const *stale() const {
+    return stale_.data();
+  }
+  [[nodiscard]] std::string *uid() {
+    return uid_.data();
+  }
+  [[nodiscard]] std::string const *uid() const {
+    return uid_.data();
+  }
+  [[nodiscard]] std::string *cot_type() {
+    return cot_type_.data();
+  }
+  [[nodiscard]] std::string const *cot_type() const {
+    return cot_type_.data();
+  }
+
+  /// @brief CotType::restamp every row from one clock reading
+  /// @param now milliseconds since the Unix epoch
+  void restamp(int64_t now);
+
+ private:
+  std::vector<double> lat_;
+  std::vector<double> lon_;
+  std::vector<double> ce_;
+  std::vector<double> hae_;
+  std::vector<double> le_;
+  std::vector<int64_t> time_;
+  std::vector<int64_t> start_;
+  std::vector<int64_t> stale_;
+  std::vector<std::string> uid_;
+  std::vector<std::string> cot_type_;
+};
+
+}  // namespace taktile
@@ -0,0 +1,55 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "taktile/functions.hpp"
+#include "taktile/xml_writer.hpp"
+
+namespace taktile {
+
+/// @brief A CoT event serialized once and re-emitted with new timestamps
+/// @details The event is written once, with lat and lon zero-padded to a
+///          fixed width, and the offsets of time, start, stale, lat, lon and
+///          the flow-tag are kept.  Each emission is a copy of the bytes plus
+///          fixed-width overwrites of those values; nothing is parsed,
+///          escaped or allocated.  Suited to heartbeats (hello_event) and to
+///          entities that re-send their position on a period.
+class CotTemplate {
+ public:
+  /// @param cot entity to emit; its time-to-stale is kept on each emission
+  /// @param max_blob_size bound on the serialized event
+  /// @throws std::invalid_argument if cot is not valid
+  /// @throws std::length_error if the event exceeds max_blob_size
+  explicit CotTemplate(CotType const &cot,
+                       std::size_t max_blob_size = MAX_TCP_BLOB_SIZE);
+
+  /// @brief Write the event, stamped at now, into buffer
+  /// @param now milliseconds since the Unix epoch
+  /// @param buffer destination
+  /// @param capacity size of the destination in bytes
+  /// @return number of bytes written
+  /// @throws std::length_error if capacity is less than size()
+  std::size_t emit(int64_t now, std::byte *buffer, std::size_t capacity) const;
+
+  /// @brief Write the event, stamped at now and moved to lat, lon
+  /// @throws std::invalid_argument if lat or lon is out of range
+  /// @throws std::length_error if capacity is less than size()
+  std::size_t emit(int64_t now, double lat, double lon, std::byte *buffer,
+                   std::size_t capacity) const;
+
+  /// @brief Size in bytes of every emitted event
+  [[nodiscard]] std::size_t size() const {
+    return blob_.size();
+  }
+
+ private:
+  std::vector<std::byte> blob_;
+  CotXmlLayout layout_;
+  int64_t time_to_stale_;
+};
+
+}  // namespace taktile
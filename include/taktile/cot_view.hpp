@@ -0,0 +1,111 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "taktile/functions.hpp"
+#include "taktile/xml_parser.hpp"
+
+namespace taktile {
+
+/// @brief Read-only view of a serialized CoT event that decodes on demand
+/// @details Holds only a view of the bytes, which must outlive it.  The
+///          first call to uid() or cot_type() scans the <event> start tag
+///          and nothing else; decode() does the full parse.
+class CotView {
+ public:
+  CotView(std::byte const *data, std::size_t size)
+      : xml_{reinterpret_cast<char const *>(data), size} {}
+
+  explicit CotView(std::vector<std::byte> const &blob)
+      : CotView(blob.data(), blob.size()) {}
+
+  /// @brief Raw uid attribute, still XML-escaped
+  /// @throws std::invalid_argument if the event tag is malformed
+  [[nodiscard]] std::string_view uid() const {
+    return fields().uid;
+  }
+
+  /// @brief Raw type attribute, still XML-escaped
+  /// @throws std::invalid_argument if the event tag is malformed
+  [[nodiscard]] std::string_view cot_type() const {
+    return fields().cot_type;
+  }
+
+  /// @brief Parse and validate the whole event
+  /// @throws std::invalid_argument if the event is malformed or invalid
+  [[nodiscard]] CotType decode() const {
+    return read_cot_xml(xml_);
+  }
+
+  [[nodiscard]] std::string_view xml() const {
+    return xml_;
+  }
+
+ private:
+  CotXmlFields const &fields() const {
+    if (!fields_) {
+      fields_ = scan_cot_event_xml(xml_);
+    }
+    return *fields_;
+  }
+
+  std::string_view xml_;
+  mutable std::optional<CotXmlFields> fields_;
+};
+
+/// @brief Accept or reject events by type and uid before decoding them
+/// @details Type patterns are compiled into a trie over the '-'-separated
+///          levels of the CoT type hierarchy.  A pattern matches its own
+///          type and everything below it, so "a-f" (or "a-f-*") accepts
+///          "a-f" and "a-f-G-U-C" but not "a-h-G".  A "*" level matches
+///          any single level, as in "a-*-A" for aircraft of every
+///          affiliation.  An event passes if its type matches a pattern and
+///          its uid is followed; with no patterns or no uids, that half of
+///          the test accepts everything.  Immutable once built, so one
+///          filter can be shared by many threads.
+class CotFilter {
+ public:
+  CotFilter();
+
+  /// @brief Accept types at or below pattern
+  /// @throws std::invalid_argument if the pattern is empty
+  void allow_type(std::string_view pattern);
+
+  /// @brief Accept events from uid
+  void follow_uid(std::string_view uid);
+
+  /// @brief Whether an event passes, judged from its event tag only
+  /// @return false if the event tag is malformed
+  [[nodiscard]] bool matches(CotView const &view) const;
+
+  /// @brief Whether decoded (unescaped) values pass
+  [[nodiscard]] bool matches(std::string_view cot_type,
+                             std::string_view uid) const;
+
+ private:
+  struct Node {
+    std::vector<std::pair<std::string, std::size_t>> children;
+    std::optional<std::size_t> any;
+    bool accept{false};
+  };
+
+  [[nodiscard]] bool type_matches(std::size_t node,
+                                  std::string_view cot_type) const;
+
+  std::vector<Node> nodes_;
+  bool any_type_{true};
+  // Views into owned_, which never moves its elements.
+  std::deque<std::string> owned_;
+  std::unordered_set<std::string_view> uids_;
+};
+
+}  // namespace taktile
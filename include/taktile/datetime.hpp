@@ -0,0 +1,37 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "taktile/constants.hpp"
+
+namespace taktile {
+
+/// @brief Current wall-clock time in milliseconds since the Unix epoch
+int64_t now_ms();
+
+/// @brief Format epoch milliseconds as YYYY-MM-DDTHH:MM:SS.mmmZ
+/// @details Writes exactly W3C_DATETIME_LENGTH characters.  The calendar
+///          math is done at most once per second per thread: the formatted
+///          date/second prefix is cached and only the milliseconds change.
+/// @param epoch_ms milliseconds since the Unix epoch (years 0000-9999)
+/// @param out destination for W3C_DATETIME_LENGTH characters
+void format_w3c_datetime(int64_t epoch_ms, char *out) noexcept;
+
+/// @brief Format epoch milliseconds as YYYY-MM-DDTHH:MM:SS.mmmZ
+/// @param epoch_ms
+/// @return datetime
+std::string format_w3c_datetime(int64_t epoch_ms);
+
+/// @brief Parse a W3C XML datetime into epoch milliseconds
+/// @details Accepts any number of fractional-second digits (truncated to
+///          milliseconds) and either a Z or a +HH:MM/-HH:MM zone suffix.
+/// @param text
+/// @return epoch_ms
+/// @throws std::invalid_argument if text is not a W3C XML datetime
+int64_t parse_w3c_datetime(std::string_view text);
+
+}  // namespace taktile
@@ -2,12 +2,17 @@
 // SPDX-License-Identifier: Apache-2.0
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <optional>
 #include <simpleio/message.hpp>
 #include <simpleio/messages/xml.hpp>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
@@ -15,8 +20,18 @@
 
 namespace taktile {
 
+/// @brief Log BOOST_LOG_TRIVIAL records of debug level and above to
+///        std::clog, synchronously
+/// @details See init_logger(LoggerOptions const &) in taktile/logging.hpp
+///          for asynchronous and file logging.
 void init_logger();
 
+/// @brief Count a message that does not fit its buffer, then throw
+/// @details Counted in the taktile_oversize_total metric.
+/// @param capacity size of the buffer in bytes
+/// @throws std::length_error always
+[[noreturn]] void throw_oversize(std::size_t capacity);
+
 /// @brief A URL structure - see RFC-1808
 ///        https://datatracker.ietf.org/doc/html/rfc1808.html
 /// @note The default constructor initializes the URL object as DEFAULT_COT_URL.
@@ -52,18 +67,31 @@ class URL {
   static URL parse_url(std::string const &inp);
 };
 
+/// @brief Format a URL as "scheme://net_loc:port", which URL() parses back
+/// @param url
+/// @return url string
+std::string to_string(URL const &url);
+
 /// @brief Cursor-on-Target (CoT) message structure
+/// @details time, start and stale are milliseconds since the Unix epoch.  A
+///          new message is stamped with the current time and goes stale
+///          DEFAULT_COT_STALE seconds later.  The stamps are fixed at that
+///          point: a message kept and re-sent, such as a heartbeat, must be
+///          restamp()ed (e.g. restamp(now_ms())) before every send, or
+///          receivers will see it go stale and drop it.
 struct CotType {
   double lat{0.0};
   double lon{0.0};
   double ce{DEFAULT_COT_VAL};
   double hae{DEFAULT_COT_VAL};
   double le{DEFAULT_COT_VAL};
-  std::string uid{DEFAULT_HOST_ID};
-  uint32_t stale{DEFAULT_COT_STALE};
+  std::string uid{default_host_id()};
+  int64_t time{0};
+  int64_t start{0};
+  int64_t stale{0};
   std::string cot_type{DEFAULT_COT_TYPE};
 
-  CotType() = default;
+  CotType();
   ~CotType() = default;
 
   CotType(CotType const &) = default;
@@ -73,6 +101,10 @@ struct CotType {
 
   explicit CotType(std::string _uid);
 
+  /// @brief Move time and start to now, keeping the same time-to-stale
+  /// @param now milliseconds since the Unix epoch
+  void restamp(int64_t now);
+
   /// @brief Get the current time in W3C XML datetime format
   /// @details Comparable to cot_time
   /// @param cot_stale time in seconds before the message is considered stale
@@ -81,6 +113,11 @@ struct CotType {
   static std::string get_time(std::optional<int32_t> cot_stale = std::nullopt);
 
   static void validate(CotType const &cot);
+
+  /// @brief The position checks of validate(), for callers without a CotType
+  /// @throws std::invalid_argument if a value is out of range
+  static void validate_point(double lat, double lon, double ce, double hae,
+                             double le);
 };
 
 class Cot2Xml {
@@ -93,11 +130,34 @@ class Cot2Xml {
   static CotType convert(simpleio::messages::XmlMessageType const &xml);
 };
 
+/// @brief Serialized message shared, read-only, by several consumers
+using SharedBlob = std::shared_ptr<std::vector<std::byte> const>;
+
 class CotSerializer : public simpleio::SerializationStrategy<CotType> {
  public:
   std::vector<std::byte> serialize(CotType const &cot) override = 0;
 
   CotType deserialize(std::vector<std::byte> const &xml) override = 0;
+
+  /// @brief Serialize a CoT message into a caller-supplied buffer
+  /// @details The default implementation serializes to a vector and copies;
+  ///          implementations that can write in place should override it.
+  /// @param cot
+  /// @param buffer destination
+  /// @param capacity size of the destination in bytes
+  /// @return number of bytes written
+  /// @throws std::length_error if the message does not fit in capacity bytes
+  virtual std::size_t serialize_into(CotType const &cot, std::byte *buffer,
+                                     std::size_t capacity);
+
+  /// @brief Deserialize a CoT message from a caller-owned buffer
+  /// @details The default implementation copies into a vector for
+  ///          deserialize(); implementations that can read in place should
+  ///          override it.
+  /// @param data serialized message
+  /// @param size number of bytes at data
+  /// @return cot
+  virtual CotType deserialize_from(std::byte const *data, std::size_t size);
 };
 
 class CotXmlSerializer : public CotSerializer {
@@ -113,6 +173,34 @@ class CotXmlSerializer : public CotSerializer {
   std::shared_ptr<simpleio::messages::XmlSerializer> xml_serializer_;
 };
 
+/// @brief XML serializer that never builds an intermediate DOM
+/// @details Encodes by writing straight into the output buffer and decodes
+///          with a single-pass pull parser.  Output is byte-compatible with
+///          CotXmlSerializer and malformed input raises the same errors.
+class CotDirectXmlSerializer : public CotSerializer {
+ public:
+  /// @brief Construct a serializer bounded by max_blob_size bytes per message
+  /// @param max_blob_size typically MAX_UDP_BLOB_SIZE or MAX_TCP_BLOB_SIZE
+  explicit CotDirectXmlSerializer(
+      std::size_t max_blob_size = MAX_TCP_BLOB_SIZE);
+
+  /// @throws std::length_error if the message exceeds max_blob_size bytes
+  std::vector<std::byte> serialize(CotType const &entity) override;
+
+  /// @throws std::invalid_argument if the event is malformed or invalid
+  CotType deserialize(std::vector<std::byte> const &_blob) override;
+
+  /// @throws std::length_error if the message exceeds capacity bytes
+  std::size_t serialize_into(CotType const &entity, std::byte *buffer,
+                             std::size_t capacity) override;
+
+  /// @throws std::invalid_argument if the event is malformed or invalid
+  CotType deserialize_from(std::byte const *data, std::size_t size) override;
+
+ private:
+  std::size_t max_blob_size_;
+};
+
 template <size_t N>
 class CotMessage : public simpleio::Message<CotType, N> {
  public:
@@ -129,6 +217,86 @@ class CotMessage : public simpleio::Message<CotType, N> {
       : simpleio::Message<CotType, N>(std::move(_blob), strategy) {}
 };
 
+/// @brief CoT message serialized into inline storage of N bytes
+/// @details Unlike CotMessage, which keeps its payload in a heap vector, the
+///          serializer writes straight into a std::array, so building and
+///          sending a message allocates nothing.  Only the payload is kept;
+///          deserialize it to get the CotType back.  Mind the footprint:
+///          the object is N bytes, so large ones belong on the heap or in a
+///          pool rather than on the stack.
+template <size_t N>
+class InlineCotMessage {
+ public:
+  static_assert(N > 0, "InlineCotMessage needs a nonzero capacity");
+
+  InlineCotMessage() = default;
+
+  ~InlineCotMessage() = default;
+
+  /// @brief Serialize a CoT message into the inline storage
+  /// @throws std::length_error if the message does not fit in N bytes
+  InlineCotMessage(CotType const &cot, CotSerializer &serializer) {
+    assign(cot, serializer);
+  }
+
+  /// @brief Copy only the bytes in use
+  InlineCotMessage(InlineCotMessage const &other) : size_{other.size_} {
+    std::copy_n(other.storage_.data(), size_, storage_.data());
+  }
+
+  InlineCotMessage &operator=(InlineCotMessage const &other) {
+    if (this != &other) {
+      size_ = other.size_;
+      std::copy_n(other.storage_.data(), size_, storage_.data());
+    }
+    return *this;
+  }
+
+  /// @brief Replace the payload with a newly serialized CoT message
+  /// @throws std::length_error if the message does not fit in N bytes
+  void assign(CotType const &cot, CotSerializer &serializer) {
+    size_ = 0;
+    size_ = serializer.serialize_into(cot, storage_.data(), N);
+  }
+
+  /// @brief Replace the payload with a copy of serialized bytes
+  /// @throws std::length_error if size is larger than N
+  void assign(std::byte const *data, std::size_t size) {
+    if (size > N) {
+      throw_oversize(N);
+    }
+    std::copy_n(data, size, storage_.data());
+    size_ = size;
+  }
+
+  [[nodiscard]] std::byte const *data() const {
+    return storage_.data();
+  }
+
+  [[nodiscard]] std::size_t size() const {
+    return size_;
+  }
+
+  [[nodiscard]] static constexpr std::size_t capacity() {
+    return N;
+  }
+
+  /// @brief The payload as text
+  [[nodiscard]] std::string_view view() const {
+    return {reinterpret_cast<char const *>(storage_.data()), size_};
+  }
+
+ private:
+  std::array<std::byte, N> storage_;
+  std::size_t size_{0};
+};
+
+/// @brief A "t-x-d-d" ping announcing uid, stamped at the time of the call
+/// @details Call restamp(now_ms()) on the event before each send when it is
+///          reused; a ping re-sent with its original stamps goes stale.
+///          CotTemplate::emit stamps on every call and avoids this.
+/// @param uid sender uid; "takPing" if empty
+/// @return the event
 CotType hello_event(std::optional<std::string> const &uid);
 
 }  // namespace taktile
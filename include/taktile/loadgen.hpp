@@ -0,0 +1,160 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "taktile/functions.hpp"
+#include "taktile/metrics.hpp"
+
+namespace taktile {
+
+/// @brief Prefix of the uids of synthetic tracks, followed by their index
+static constexpr std::string_view LOAD_UID_PREFIX{"loadgen-"};
+
+/// @brief Seeded random-walk tracks for load generation
+/// @details Each track walks from a start point near (lat, lon) by up to
+///          step_m meters north and east per update, with its own
+///          generator, so a track's path depends only on the seed and its
+///          index.  Updates are stamped for LoadMonitor: ce holds the
+///          track's sequence number and le the send time in milliseconds
+///          since the run started.  Both encodings write these exactly (XML
+///          to the nanosecond), so receivers see what was sent.
+class SyntheticTracks {
+ public:
+  /// @param tracks number of tracks, with uids LOAD_UID_PREFIX + index
+  /// @param seed
+  /// @param step_m largest move per update in each of north and east
+  /// @param lat latitude the tracks start around
+  /// @param lon longitude the tracks start around
+  SyntheticTracks(std::size_t tracks, uint64_t seed, double step_m = 10.0,
+                  double lat = 37.7749, double lon = -122.4194);
+
+  /// @brief Move a track one step and stamp it
+  /// @param track index below size()
+  /// @param sent_ms send time, in milliseconds since the run started
+  /// @return the update, valid until the track's next update
+  CotType const &next(std::size_t track, double sent_ms);
+
+  [[nodiscard]] std::size_t size() const {
+    return tracks_.size();
+  }
+
+ private:
+  struct Track {
+    CotType cot;
+    uint64_t state{0};
+    uint64_t sequence{0};
+  };
+
+  double step_m_;
+  std::vector<Track> tracks_;
+};
+
+/// @brief What a load run sent and received
+struct LoadReport {
+  uint64_t sent{0};
+  uint64_t received{0};
+  /// @brief Sent but never received
+  uint64_t lost{0};
+  /// @brief Received after a later update of the same track
+  uint64_t reordered{0};
+  /// @brief Received but not from this run's tracks
+  uint64_t foreign{0};
+  /// @brief Refused by the sender's queue or the kernel
+  uint64_t send_drops{0};
+  /// @brief Dropped by the receiving kernel for want of buffer space
+  uint64_t kernel_drops{0};
+  /// @brief How long sending took
+  double seconds{0.0};
+  /// @brief End-to-end latency quantiles in nanoseconds, each within 12.5%
+  uint64_t p50_ns{0};
+  uint64_t p99_ns{0};
+  uint64_t p999_ns{0};
+
+  [[nodiscard]] double events_per_second() const {
+    return seconds > 0.0 ? static_cast<double>(received) / seconds : 0.0;
+  }
+};
+
+/// @brief Receive side of a load run: latency, loss and reordering of
+///        updates stamped by SyntheticTracks
+/// @details record() is safe to call from many receiver workers at once.
+class LoadMonitor {
+ public:
+  /// @param tracks number of tracks sent
+  /// @param epoch when the run started, as passed to SyntheticTracks
+  LoadMonitor(std::size_t tracks, std::chrono::steady_clock::time_point epoch);
+
+  /// @brief Account for a received update at the current time
+  void record(CotType const &cot);
+
+  /// @brief Account for a received update
+  /// @param cot
+  /// @param received_ms receive time, in milliseconds since the run started
+  void record(CotType const &cot, double received_ms);
+
+  /// @brief Milliseconds since the run started
+  [[nodiscard]] double elapsed_ms() const;
+
+  /// @brief Updates recorded from this run's tracks
+  [[nodiscard]] uint64_t received() const {
+    return received_.load(std::memory_order_relaxed);
+  }
+
+  /// @brief Totals, given how many updates were sent
+  /// @details Only the receive-side fields and sent, lost and latencies are
+  ///          filled in.
+  [[nodiscard]] LoadReport report(uint64_t sent) const;
+
+ private:
+  std::chrono::steady_clock::time_point epoch_;
+  // One past the highest sequence seen per track; 0 before the first.
+  std::unique_ptr<std::atomic<uint64_t>[]> next_;
+  std::size_t tracks_;
+  std::atomic<uint64_t> received_{0};
+  std::atomic<uint64_t> reordered_{0};
+  std::atomic<uint64_t> foreign_{0};
+  LatencyHistogram latency_;
+};
+
+/// @brief Parameters of a load run
+struct LoadOptions {
+  std::size_t tracks{100};
+  /// @brief Updates per track per second
+  double rate_hz{1.0};
+  /// @brief How long to send for
+  double seconds{10.0};
+  uint64_t seed{1};
+  /// @brief Largest move per update in each of north and east, in meters
+  double step_m{10.0};
+  /// @brief Where to receive; port 0 picks a free port
+  URL url{Scheme::UDP, "127.0.0.1", 0};
+  /// @brief Encoder and decoder; CotDirectXmlSerializer if unset
+  std::shared_ptr<CotSerializer> serializer;
+  /// @brief Receiver worker threads
+  std::size_t workers{1};
+  /// @brief Longest wait for stragglers once sending ends
+  std::chrono::milliseconds drain{500};
+};
+
+/// @brief Send synthetic tracks through the library's serialize, UDP send,
+///        receive and decode path on this host and measure what arrives
+/// @details Updates go out round-robin over the tracks at an even
+///          tracks * rate_hz per second, serialized straight into
+///          CotUdpSender's queue and flushed whenever the sender is ahead
+///          of schedule.  A CotUdpReceiver on url decodes them and feeds a
+///          LoadMonitor.
+/// @throws std::invalid_argument if url is not a receivable UDP URL or the
+///         rate is not positive
+/// @throws std::system_error if a socket cannot be set up
+LoadReport run_load(LoadOptions const &options);
+
+}  // namespace taktile
@@ -0,0 +1,51 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <boost/log/trivial.hpp>
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+namespace taktile {
+
+/// @brief Where, what and how init_logger() logs
+struct LoggerOptions {
+  /// @brief Least severe level that is logged
+  boost::log::trivial::severity_level severity{boost::log::trivial::debug};
+  /// @brief Log to std::clog
+  bool console{true};
+  /// @brief Log file name, which may contain a %N rotation counter as in
+  ///        "taktile_%N.log"; empty for no log file
+  std::string file;
+  /// @brief Size in bytes at which the log file is rotated
+  std::size_t rotation_size{std::size_t{10} * 1024 * 1024};
+  /// @brief Most rotated log files kept in the log file's directory; 0
+  ///        keeps them all
+  std::size_t max_files{0};
+  /// @brief Write records from a background thread
+  /// @details The logging thread only pushes each record into a lock-free
+  ///          ring; formatting and I/O happen on the background thread.  If
+  ///          the ring is full, the record is dropped and counted in the
+  ///          taktile_log_dropped_total metric, so logging never blocks.
+  bool asynchronous{false};
+  /// @brief Records the ring holds, rounded up to a power of two
+  std::size_t queue_capacity{8192};
+  /// @brief How long the background thread sleeps when the ring is empty
+  std::chrono::milliseconds flush_interval{10};
+};
+
+/// @brief Add Boost.Log sinks for BOOST_LOG_TRIVIAL records
+/// @details Records are formatted as "[TimeStamp] [Severity] Message".  Only
+///          one asynchronous logger runs at a time; setting up another
+///          stops the previous one first.
+/// @throws std::invalid_argument if queue_capacity is 0
+void init_logger(LoggerOptions const &options);
+
+/// @brief Write out everything the asynchronous logger has queued, then
+///        stop it
+/// @details Runs at exit as well; does nothing if no asynchronous logger is
+///          running.
+void stop_logger();
+
+}  // namespace taktile
@@ -0,0 +1,292 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <signal.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "taktile/functions.hpp"
+
+namespace taktile {
+
+/// @brief Number of stripes every metric is split into
+/// @details Each of the first METRIC_STRIPES - 1 threads to record a metric
+///          owns a stripe and updates it with a plain load and store.  Any
+///          further threads share the last stripe and use atomic adds.  A
+///          thread's stripe is handed on when it exits.
+inline constexpr std::size_t METRIC_STRIPES{16};
+inline constexpr std::size_t SHARED_METRIC_STRIPE{METRIC_STRIPES - 1};
+
+/// @brief Claim a stripe for the calling thread; use metric_stripe()
+std::size_t acquire_metric_stripe();
+
+// METRIC_STRIPES until the thread first records a metric.
+inline thread_local std::size_t current_metric_stripe{METRIC_STRIPES};
+
+/// @brief Stripe the calling thread records metrics in
+inline std::size_t metric_stripe() {
+  if (current_metric_stripe == METRIC_STRIPES) {
+    current_metric_stripe = acquire_metric_stripe();
+  }
+  return current_metric_stripe;
+}
+
+/// @brief Add n to a stripe owned by stripe's thread or shared by many
+inline void add_to_stripe(std::atomic<uint64_t> &value, std::size_t stripe,
+                          uint64_t n) {
+  if (stripe == SHARED_METRIC_STRIPE) {
+    value.fetch_add(n, std::memory_order_relaxed);
+  } else {
+    value.store(value.load(std::memory_order_relaxed) + n,
+                std::memory_order_relaxed);
+  }
+}
+
+/// @brief Monotonic count, cheap to increment from many threads
+class Counter {
+ public:
+  void add(uint64_t n = 1) {
+    auto const stripe = metric_stripe();
+    add_to_stripe(stripes_[stripe].value, stripe, n);
+  }
+
+  /// @brief Sum over all threads
+  [[nodiscard]] uint64_t value() const;
+
+ private:
+  struct alignas(64) Stripe {
+    std::atomic<uint64_t> value{0};
+  };
+
+  std::array<Stripe, METRIC_STRIPES> stripes_;
+};
+
+/// @brief Bucket layout of LatencyHistogram
+/// @details Log-linear, as in HdrHistogram: values below 16 get a bucket
+///          each, and every power of two above that is split into 8
+///          buckets, so a bucket is never wider than 12.5% of its values.
+struct HistogramBuckets {
+  static constexpr unsigned SUB_BUCKET_BITS{3};
+  static constexpr std::size_t SUB_BUCKETS{std::size_t{1} << SUB_BUCKET_BITS};
+  static constexpr std::size_t COUNT{(65 - SUB_BUCKET_BITS) * SUB_BUCKETS};
+
+  static std::size_t of(uint64_t value) {
+    if (value < 2 * SUB_BUCKETS) {
+      return static_cast<std::size_t>(value);
+    }
+    auto const shift = 63U - static_cast<unsigned>(__builtin_clzll(value)) -
+                       SUB_BUCKET_BITS;
+    return shift * SUB_BUCKETS + static_cast<std::size_t>(value >> shift);
+  }
+
+  /// @brief Smallest value in bucket
+  static uint64_t lowest(std::size_t bucket) {
+    if (bucket < 2 * SUB_BUCKETS) {
+      return bucket;
+    }
+    auto const shift = bucket / SUB_BUCKETS - 1;
+    return (bucket % SUB_BUCKETS + SUB_BUCKETS) << shift;
+  }
+
+  /// @brief Largest value in bucket
+  static uint64_t highest(std::size_t bucket) {
+    return bucket + 1 == COUNT ? UINT64_MAX : lowest(bucket + 1) - 1;
+  }
+};
+
+/// @brief Aggregated contents of a LatencyHistogram
+struct HistogramSnapshot {
+  /// @brief Samples per bucket, indexed as HistogramBuckets
+  std::vector<uint64_t> counts;
+  uint64_t count{0};
+  /// @brief Sum of all samples in nanoseconds
+  uint64_t sum{0};
+
+  /// @brief Upper bound of the bucket holding the q-th quantile, so within
+  ///        12.5% of the true value
+  /// @param q between 0 and 1
+  /// @return nanoseconds, or 0 if there are no samples
+  [[nodiscard]] uint64_t percentile(double q) const;
+};
+
+/// @brief Latency distribution in nanoseconds, cheap to record into from
+///        many threads
+class LatencyHistogram {
+ public:
+  LatencyHistogram();
+
+  void record(uint64_t nanoseconds) {
+    auto const stripe = metric_stripe();
+    auto &counts = stripes_[stripe];
+    add_to_stripe(counts.buckets[HistogramBuckets::of(nanoseconds)], stripe,
+                  1);
+    add_to_stripe(counts.sum, stripe, nanoseconds);
+  }
+
+  /// @brief Record the time elapsed since start
+  void record_since(std::chrono::steady_clock::time_point start) {
+    auto const elapsed = std::chrono::steady_clock::now() - start;
+    record(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+            .count()));
+  }
+
+  /// @brief Sum over all threads
+  [[nodiscard]] HistogramSnapshot snapshot() const;
+
+ private:
+  struct alignas(64) Stripe {
+    std::array<std::atomic<uint64_t>, HistogramBuckets::COUNT> buckets{};
+    std::atomic<uint64_t> sum{0};
+  };
+
+  std::unique_ptr<Stripe[]> stripes_;
+};
+
+/// @brief Values of every metric in a registry at one point in time
+struct MetricsSnapshot {
+  std::map<std::string, uint64_t> counters;
+  std::map<std::string, HistogramSnapshot> histograms;
+};
+
+/// @brief Named counters and histograms
+/// @details Lookups take a lock, so hot paths should look their metrics up
+///          once and keep the reference, which stays valid for the lifetime
+///          of the registry.
+class MetricsRegistry {
+ public:
+  /// @brief The counter called name, created on first use
+  /// @param name a Prometheus metric name, by convention ending in _total
+  /// @param help description for the exposition; the first one given wins
+  /// @throws std::invalid_argument if the name is not a valid metric name
+  ///         or is already used by a histogram
+  Counter &counter(std::string const &name, std::string const &help = {});
+
+  /// @brief The histogram called name, created on first use
+  /// @param name a Prometheus metric name, by convention ending in _seconds
+  /// @param help description for the exposition; the first one given wins
+  /// @throws std::invalid_argument if the name is not a valid metric name
+  ///         or is already used by a counter
+  LatencyHistogram &histogram(std::string const &name,
+                              std::string const &help = {});
+
+  [[nodiscard]] MetricsSnapshot snapshot() const;
+
+  /// @brief Every metric in the Prometheus text exposition format (0.0.4)
+  /// @details Histograms are reported in seconds, with cumulative buckets
+  ///          at powers of two nanoseconds from 64 ns to about 17 s.
+  [[nodiscard]] std::string prometheus() const;
+
+ private:
+  template <typename Metric>
+  struct Entry {
+    std::string help;
+    std::unique_ptr<Metric> metric;
+  };
+
+  mutable std::mutex mutex_;
+  std::map<std::string, Entry<Counter>, std::less<>> counters_;
+  std::map<std::string, Entry<LatencyHistogram>, std::less<>> histograms_;
+};
+
+/// @brief The process-wide registry taktile records its own metrics in
+/// @details Never destroyed, so metrics can be recorded during shutdown.
+MetricsRegistry &metrics();
+
+/// @brief Where MetricsExporter serves and dumps metrics
+struct MetricsExporterOptions {
+  /// @brief IPv4 address to serve GET /metrics on; empty for no endpoint
+  std::string address{"127.0.0.1"};
+  /// @brief Port to serve on; 0 picks a free port
+  uint16_t port{0};
+  /// @brief Signal that dumps the metrics to dump_fd, such as SIGUSR1; 0
+  ///        for none
+  int dump_signal{0};
+  int dump_fd{STDERR_FILENO};
+};
+
+/// @brief Serves a registry over HTTP for scraping and dumps it on a signal
+/// @details A single background thread handles both, one request at a
+///          time, so nothing runs on the threads that record metrics.  Only
+///          one exporter at a time may handle a dump signal.
+class MetricsExporter {
+ public:
+  /// @throws std::invalid_argument if the address is not an IPv4 address or
+  ///         another exporter already handles a dump signal
+  /// @throws std::system_error if a socket or the signal handler cannot be
+  ///         set up
+  explicit MetricsExporter(MetricsRegistry &registry = metrics(),
+                           MetricsExporterOptions options = {});
+
+  /// @brief Stops serving and restores the previous signal handler
+  ~MetricsExporter();
+
+  MetricsExporter(MetricsExporter const &) = delete;
+  MetricsExporter(MetricsExporter &&) = delete;
+  MetricsExporter &operator=(MetricsExporter const &) = delete;
+  MetricsExporter &operator=(MetricsExporter &&) = delete;
+
+  /// @brief Port the endpoint is bound to, or 0 if there is none
+  [[nodiscard]] uint16_t port() const {
+    return port_;
+  }
+
+ private:
+  void run();
+
+  void serve(int client);
+
+  void close_all();
+
+  MetricsRegistry &registry_;
+  MetricsExporterOptions options_;
+  int listen_fd_{-1};
+  std::array<int, 2> signal_pipe_{-1, -1};
+  struct sigaction previous_action_ {};
+  uint16_t port_{0};
+  std::atomic<bool> running_{true};
+  std::thread thread_;
+};
+
+/// @brief CotSerializer decorator that records latencies and failures
+/// @details Times every call into taktile_serialize_seconds or
+///          taktile_deserialize_seconds and counts calls that throw in
+///          taktile_serialize_failures_total or
+///          taktile_deserialize_failures_total.  Timing costs two clock
+///          reads per call on top of the wrapped serializer.
+class MeteredCotSerializer : public CotSerializer {
+ public:
+  explicit MeteredCotSerializer(std::shared_ptr<CotSerializer> serializer,
+                                MetricsRegistry &registry = metrics());
+
+  std::vector<std::byte> serialize(CotType const &cot) override;
+
+  CotType deserialize(std::vector<std::byte> const &blob) override;
+
+  std::size_t serialize_into(CotType const &cot, std::byte *buffer,
+                             std::size_t capacity) override;
+
+  CotType deserialize_from(std::byte const *data, std::size_t size) override;
+
+ private:
+  std::shared_ptr<CotSerializer> serializer_;
+  LatencyHistogram &serialize_latency_;
+  LatencyHistogram &deserialize_latency_;
+  Counter &serialize_failures_;
+  Counter &deserialize_failures_;
+};
+
+}  // namespace taktile
@@ -0,0 +1,584 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "taktile/functions.hpp"
+
+namespace taktile {
+
+/// @brief Smallest power of two holding capacity values
+/// @throws std::invalid_argument if capacity is 0
+inline std::size_t ring_capacity(std::size_t capacity) {
+  if (capacity == 0) {
+    throw std::invalid_argument("Ring capacity must be positive");
+  }
+  std::size_t rounded{1};
+  while (rounded < capacity) {
+    rounded <<= 1;
+  }
+  return rounded;
+}
+
+/// @brief Bounded single-producer, single-consumer ring buffer
+/// @details Lock-free; each side keeps a cached copy of the other side's
+///          index, so the shared cache lines are only read when the ring
+///          looks full or empty.  Capacity is rounded up to a power of two.
+template <typename T>
+class SpscRing {
+ public:
+  /// @throws std::invalid_argument if capacity is 0
+  explicit SpscRing(std::size_t capacity)
+      : mask_{ring_capacity(capacity) - 1}, slots_(mask_ + 1) {}
+
+  SpscRing(SpscRing const &) = delete;
+  SpscRing &operator=(SpscRing const &) = delete;
+
+  /// @brief Move as many of values[0, count) in as there is room for
+  /// @return number of values moved in, taken from the front
+  std::size_t push(T *values, std::size_t count) {
+    auto const tail = tail_.load(std::memory_order_relaxed);
+    if (capacity() - (tail - cached_head_) < count) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+    }
+    auto const n = std::min(count, capacity() - (tail - cached_head_));
+    for (std::size_t i = 0; i < n; ++i) {
+      slots_[(tail + i) & mask_] = std::move(values[i]);
+    }
+    tail_.store(tail + n, std::memory_order_release);
+    return n;
+  }
+
+  /// @brief Move one value in
+  /// @return false, leaving value untouched, if the ring is full
+  bool push(T &&value) {
+    return push(&value, 1) == 1;
+  }
+
+  /// @brief Move up to max values out, appending them to out
+  /// @return number of values moved out
+  std::size_t pop(std::vector<T> &out, std::size_t max) {
+    auto const head = head_.load(std::memory_order_relaxed);
+    if (cached_tail_ - head < max) {
+      cached_tail_ = tail_.load(std::memory_order_acquire);
+    }
+    auto const n = std::min(max, cached_tail_ - head);
+    for (std::size_t i = 0; i < n; ++i) {
+      out.push_back(std::move(slots_[(head + i) & mask_]));
+    }
+    head_.store(head + n, std::memory_order_release);
+    return n;
+  }
+
+  /// @brief Number of values queued; exact only when both sides are idle
+  [[nodiscard]] std::size_t size() const {
+    auto const head = head_.load(std::memory_order_acquire);
+    return tail_.load(std::memory_order_acquire) - head;
+  }
+
+  [[nodiscard]] std::size_t capacity() const {
+    return mask_ + 1;
+  }
+
+ private:
+  std::size_t const mask_;
+  std::vector<T> slots_;
+  // Consumer side.
+  alignas(64) std::atomic<std::size_t> head_{0};
+  std::size_t cached_tail_{0};
+  // Producer side.
+  alignas(64) std::atomic<std::size_t> tail_{0};
+  std::size_t cached_head_{0};
+};
+
+/// @brief Bounded multi-producer, multi-consumer ring buffer
+/// @details Lock-free, after Vyukov: every slot carries a sequence number
+///          that tells producers and consumers whose turn it is, so each
+///          side claims a slot with one compare-and-swap and never waits on
+///          a lock.  Capacity is rounded up to a power of two.
+template <typename T>
+class MpmcRing {
+ public:
+  /// @throws std::invalid_argument if capacity is 0
+  explicit MpmcRing(std::size_t capacity)
+      : mask_{ring_capacity(capacity) - 1},
+        slots_{std::make_unique<Slot[]>(mask_ + 1)} {
+    for (std::size_t i = 0; i <= mask_; ++i) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MpmcRing(MpmcRing const &) = delete;
+  MpmcRing &operator=(MpmcRing const &) = delete;
+
+  /// @brief Move one value in
+  /// @return false, leaving value untouched, if the ring is full
+  bool push(T &&value) {
+    auto position = tail_.load(std::memory_order_relaxed);
+    while (true) {
+      auto &slot = slots_[position & mask_];
+      auto const sequence = slot.sequence.load(std::memory_order_acquire);
+      auto const lag = static_cast<std::ptrdiff_t>(sequence - position);
+      if (lag == 0) {
+        if (tail_.compare_exchange_weak(position, position + 1,
+                                        std::memory_order_relaxed)) {
+          slot.value = std::move(value);
+          slot.sequence.store(position + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (lag < 0) {
+        return false;
+      } else {
+        position = tail_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// @brief Move as many of values[0, count) in as there is room for
+  /// @return number of values moved in, taken from the front
+  std::size_t push(T *values, std::size_t count) {
+    std::size_t n{0};
+    while (n < count && push(std::move(values[n]))) {
+      ++n;
+    }
+    return n;
+  }
+
+  /// @brief Move up to max values out, appending them to out
+  /// @return number of values moved out
+  std::size_t pop(std::vector<T> &out, std::size_t max) {
+    std::size_t n{0};
+    auto position = head_.load(std::memory_order_relaxed);
+    while (n < max) {
+      auto &slot = slots_[position & mask_];
+      auto const sequence = slot.sequence.load(std::memory_order_acquire);
+      auto const lag = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+      if (lag == 0) {
+        if (head_.compare_exchange_weak(position, position + 1,
+                                        std::memory_order_relaxed)) {
+          out.push_back(std::move(slot.value));
+          slot.sequence.store(position + mask_ + 1, std::memory_order_release);
+          ++n;
+          ++position;
+        }
+      } else if (lag < 0) {
+        break;
+      } else {
+        position = head_.load(std::memory_order_relaxed);
+      }
+    }
+    return n;
+  }
+
+  /// @brief Number of values queued; exact only when both sides are idle
+  [[nodiscard]] std::size_t size() const {
+    auto const head = head_.load(std::memory_order_acquire);
+    auto const tail = tail_.load(std::memory_order_acquire);
+    return tail > head ? tail - head : 0;
+  }
+
+  [[nodiscard]] std::size_t capacity() const {
+    return mask_ + 1;
+  }
+
+ private:
+  struct Slot {
+    std::atomic<std::size_t> sequence;
+    T value;
+  };
+
+  std::size_t const mask_;
+  std::unique_ptr<Slot[]> slots_;
+  alignas(64) std::atomic<std::size_t> head_{0};
+  alignas(64) std::atomic<std::size_t> tail_{0};
+};
+
+/// @brief Bounded queue between two pipeline stages
+/// @details An SpscRing when one thread feeds one thread, otherwise an
+///          MpmcRing.
+template <typename T>
+class StageQueue {
+ public:
+  /// @param capacity rounded up to a power of two
+  /// @param shared whether more than one thread pushes or pops
+  StageQueue(std::size_t capacity, bool shared) {
+    if (shared) {
+      mpmc_ = std::make_unique<MpmcRing<T>>(capacity);
+    } else {
+      spsc_ = std::make_unique<SpscRing<T>>(capacity);
+    }
+  }
+
+  std::size_t push(T *values, std::size_t count) {
+    return spsc_ ? spsc_->push(values, count) : mpmc_->push(values, count);
+  }
+
+  std::size_t pop(std::vector<T> &out, std::size_t max) {
+    return spsc_ ? spsc_->pop(out, max) : mpmc_->pop(out, max);
+  }
+
+  [[nodiscard]] std::size_t size() const {
+    return spsc_ ? spsc_->size() : mpmc_->size();
+  }
+
+  [[nodiscard]] std::size_t capacity() const {
+    return spsc_ ? spsc_->capacity() : mpmc_->capacity();
+  }
+
+ private:
+  std::unique_ptr<SpscRing<T>> spsc_;
+  std::unique_ptr<MpmcRing<T>> mpmc_;
+};
+
+/// @brief Threading and queueing options for one pipeline stage
+struct StageOptions {
+  /// @brief Name reported in Pipeline::stats()
+  std::string name;
+  /// @brief Number of worker threads running the stage
+  std::size_t threads{1};
+  /// @brief CPUs to pin workers to, round-robin; empty leaves them unpinned
+  std::vector<int> cpus;
+  /// @brief Most items a worker takes from its queue at once
+  std::size_t batch_size{64};
+  /// @brief Capacity of the queue feeding the stage, rounded up to a power
+  ///        of two; unused by sources
+  std::size_t queue_capacity{1024};
+  /// @brief How long an idle or blocked worker sleeps once spinning has not
+  ///        helped
+  std::chrono::microseconds idle_sleep{50};
+};
+
+/// @brief Load and running totals of one pipeline stage
+/// @details A stage whose queue stays near capacity is slower than the one
+///          feeding it; stalls count how often a stage waited for room in
+///          the next one's queue.
+struct StageStats {
+  std::string name;
+  /// @brief Items waiting in the queue feeding the stage
+  std::size_t queue_depth{0};
+  std::size_t queue_capacity{0};
+  /// @brief Items produced (sources) or consumed without error
+  uint64_t processed{0};
+  /// @brief Items, or source calls, that threw
+  uint64_t failures{0};
+  uint64_t stalls{0};
+  /// @brief processed per second since start()
+  double throughput{0.0};
+};
+
+/// @brief Output of a pipeline stage, to be consumed by exactly one other
+template <typename T>
+class Port {
+ private:
+  friend class Pipeline;
+
+  struct Link {
+    std::unique_ptr<StageQueue<T>> queue;
+    std::size_t producers{1};
+  };
+
+  explicit Port(std::shared_ptr<Link> link) : link_{std::move(link)} {}
+
+  std::shared_ptr<Link> link_;
+};
+
+/// @brief Runs stages on their own threads, connected by bounded queues
+/// @details Stages hand items on in batches of up to batch_size.  A stage
+///          whose downstream queue is full waits for room, so a slow stage
+///          holds back the ones before it instead of dropping their output.
+///          Each worker calls its own copy of the stage function, so
+///          functions may keep per-thread state; state they share (such as a
+///          serializer) must be safe to use concurrently.  Items a stage
+///          function throws on are counted as failures and dropped.
+///
+///          @code
+///          taktile::Pipeline pipeline;
+///          auto blobs = pipeline.source<std::vector<std::byte>>({"recv"},
+///                                                              receive);
+///          auto cots = pipeline.stage<taktile::CotType>(
+///              blobs, {"decode", 4}, taktile::decode_stage(serializer));
+///          pipeline.sink(cots, {"process"}, process);
+///          pipeline.start();
+///          @endcode
+class Pipeline {
+ public:
+  Pipeline() = default;
+
+  /// @brief Stops the pipeline
+  ~Pipeline();
+
+  Pipeline(Pipeline const &) = delete;
+  Pipeline(Pipeline &&) = delete;
+  Pipeline &operator=(Pipeline const &) = delete;
+  Pipeline &operator=(Pipeline &&) = delete;
+
+  /// @brief Add a stage that produces items
+  /// @param options
+  /// @param produce called as produce(std::vector<Out> &out, std::size_t
+  ///        max) to append up to max items; it may block briefly, since
+  ///        workers only check whether to stop between calls
+  /// @throws std::invalid_argument if the options are invalid or the
+  ///         pipeline is running
+  template <typename Out, typename Produce>
+  Port<Out> source(StageOptions options, Produce produce) {
+    auto &stage = add(std::move(options));
+    auto output = make_output<Out>(stage);
+    stage.run = [&stage, output, produce](std::size_t worker) {
+      auto fn = produce;
+      auto &queue = *output->queue;
+      auto &counters = stage.counters[worker];
+      std::vector<Out> items;
+      items.reserve(stage.options.batch_size);
+      Backoff backoff{stage.options.idle_sleep};
+      while (!stage.stopping.load(std::memory_order_acquire)) {
+        try {
+          fn(items, stage.options.batch_size);
+        } catch (std::exception const &) {
+          counters.failures.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (items.empty()) {
+          backoff.pause();
+          continue;
+        }
+        backoff.reset();
+        counters.processed.fetch_add(items.size(), std::memory_order_relaxed);
+        forward(queue, items, stage, counters);
+      }
+    };
+    return Port<Out>{output};
+  }
+
+  /// @brief Add a stage that turns each input item into zero or more
+  ///        outputs
+  /// @param input
+  /// @param options
+  /// @param transform called as transform(In &&item, std::vector<Out> &out)
+  /// @throws std::invalid_argument if the options are invalid, the pipeline
+  ///         is running or input is already consumed
+  template <typename Out, typename In, typename Transform>
+  Port<Out> stage(Port<In> const &input, StageOptions options,
+                  Transform transform) {
+    check_unconnected(input);
+    auto &stage = add(std::move(options));
+    auto inlet = connect(input, stage);
+    auto output = make_output<Out>(stage);
+    stage.run = [&stage, inlet, output, transform](std::size_t worker) {
+      auto fn = transform;
+      auto &queue = *output->queue;
+      auto &counters = stage.counters[worker];
+      std::vector<Out> items;
+      items.reserve(stage.options.batch_size);
+      drain(stage, *inlet->queue, [&](std::vector<In> &batch) {
+        uint64_t failures{0};
+        for (auto &item : batch) {
+          try {
+            fn(std::move(item), items);
+          } catch (std::exception const &) {
+            ++failures;
+          }
+        }
+        counters.processed.fetch_add(batch.size() - failures,
+                                     std::memory_order_relaxed);
+        counters.failures.fetch_add(failures, std::memory_order_relaxed);
+        forward(queue, items, stage, counters);
+      });
+    };
+    return Port<Out>{output};
+  }
+
+  /// @brief Add a stage that consumes items
+  /// @param input
+  /// @param options
+  /// @param consume called as consume(std::vector<In> &batch) with each
+  ///        batch taken from the queue, so it can, for example, enqueue them
+  ///        on a CotUdpSender and flush once; if it throws, the whole batch
+  ///        counts as failed
+  /// @throws std::invalid_argument if the options are invalid, the pipeline
+  ///         is running or input is already consumed
+  template <typename In, typename Consume>
+  void sink(Port<In> const &input, StageOptions options, Consume consume) {
+    check_unconnected(input);
+    auto &stage = add(std::move(options));
+    auto inlet = connect(input, stage);
+    stage.run = [&stage, inlet, consume](std::size_t worker) {
+      auto fn = consume;
+      auto &counters = stage.counters[worker];
+      drain(stage, *inlet->queue, [&](std::vector<In> &batch) {
+        try {
+          fn(batch);
+          counters.processed.fetch_add(batch.size(),
+                                       std::memory_order_relaxed);
+        } catch (std::exception const &) {
+          counters.failures.fetch_add(batch.size(),
+                                      std::memory_order_relaxed);
+        }
+      });
+    };
+  }
+
+  /// @brief Start every stage's workers
+  /// @throws std::invalid_argument if a stage's output is not consumed
+  void start();
+
+  /// @brief Stop the stages in the order they were added
+  /// @details Sources stop producing; each later stage then drains its
+  ///          queue before its workers are joined, so nothing already
+  ///          produced is lost.
+  void stop();
+
+  /// @brief Per-stage totals, in the order the stages were added
+  [[nodiscard]] std::vector<StageStats> stats() const;
+
+ private:
+  struct alignas(64) WorkerCounters {
+    std::atomic<uint64_t> processed{0};
+    std::atomic<uint64_t> failures{0};
+    std::atomic<uint64_t> stalls{0};
+  };
+
+  struct Stage {
+    explicit Stage(StageOptions stage_options)
+        : options{std::move(stage_options)}, counters(options.threads) {}
+
+    StageOptions options;
+    std::vector<WorkerCounters> counters;
+    std::function<void(std::size_t)> run;
+    std::function<std::size_t()> depth;
+    std::size_t capacity{0};
+    std::function<bool()> connected;
+    std::atomic<bool> stopping{false};
+    std::vector<std::thread> threads;
+  };
+
+  /// @brief Spin, then yield, then sleep while there is nothing to do
+  class Backoff {
+   public:
+    explicit Backoff(std::chrono::microseconds sleep) : sleep_{sleep} {}
+
+    void pause();
+
+    void reset() {
+      spins_ = 0;
+    }
+
+   private:
+    std::chrono::microseconds sleep_;
+    unsigned spins_{0};
+  };
+
+  Stage &add(StageOptions options);
+
+  template <typename T>
+  static void check_unconnected(Port<T> const &input) {
+    if (input.link_->queue) {
+      throw std::invalid_argument("Pipeline port is already consumed");
+    }
+  }
+
+  template <typename Out>
+  static std::shared_ptr<typename Port<Out>::Link> make_output(Stage &stage) {
+    auto output = std::make_shared<typename Port<Out>::Link>();
+    output->producers = stage.options.threads;
+    stage.connected = [output] { return output->queue != nullptr; };
+    return output;
+  }
+
+  template <typename In>
+  static std::shared_ptr<typename Port<In>::Link> connect(
+      Port<In> const &input, Stage &stage) {
+    auto inlet = input.link_;
+    inlet->queue = std::make_unique<StageQueue<In>>(
+        stage.options.queue_capacity,
+        inlet->producers > 1 || stage.options.threads > 1);
+    auto const *queue = inlet->queue.get();
+    stage.depth = [queue] { return queue->size(); };
+    stage.capacity = queue->capacity();
+    return inlet;
+  }
+
+  template <typename In, typename Consume>
+  static void drain(Stage &stage, StageQueue<In> &queue, Consume &&consume) {
+    auto const batch_size = stage.options.batch_size;
+    std::vector<In> batch;
+    batch.reserve(batch_size);
+    Backoff backoff{stage.options.idle_sleep};
+    while (true) {
+      batch.clear();
+      if (queue.pop(batch, batch_size) == 0) {
+        // Earlier stages are joined before this one is told to stop, so an
+        // empty queue after that stays empty.
+        if (stage.stopping.load(std::memory_order_acquire) &&
+            queue.pop(batch, batch_size) == 0) {
+          return;
+        }
+        if (batch.empty()) {
+          backoff.pause();
+          continue;
+        }
+      }
+      backoff.reset();
+      consume(batch);
+    }
+  }
+
+  template <typename T>
+  static void forward(StageQueue<T> &queue, std::vector<T> &items,
+                      Stage &stage, WorkerCounters &counters) {
+    Backoff backoff{stage.options.idle_sleep};
+    std::size_t sent{0};
+    while (true) {
+      sent += queue.push(items.data() + sent, items.size() - sent);
+      if (sent == items.size()) {
+        break;
+      }
+      counters.stalls.fetch_add(1, std::memory_order_relaxed);
+      backoff.pause();
+    }
+    items.clear();
+  }
+
+  std::vector<std::unique_ptr<Stage>> stages_;
+  bool running_{false};
+  std::chrono::steady_clock::time_point started_;
+  std::chrono::steady_clock::time_point stopped_;
+};
+
+/// @brief Stage function that decodes serialized CoT messages
+/// @details Messages the serializer rejects are counted as stage failures.
+/// @param serializer shared by the stage's workers, so it must be safe to
+///        call concurrently (CotDirectXmlSerializer is)
+inline auto decode_stage(std::shared_ptr<CotSerializer> serializer) {
+  return [serializer = std::move(serializer)](std::vector<std::byte> &&blob,
+                                              std::vector<CotType> &out) {
+    out.push_back(serializer->deserialize(blob));
+  };
+}
+
+/// @brief Stage function that serializes CoT messages into shared blobs
+/// @details The blobs can be handed to CotUdpSender::enqueue(SharedBlob)
+///          without another copy.  Messages the serializer rejects are
+///          counted as stage failures.
+/// @param serializer shared by the stage's workers, so it must be safe to
+///        call concurrently (CotDirectXmlSerializer is)
+inline auto encode_stage(std::shared_ptr<CotSerializer> serializer) {
+  return [serializer = std::move(serializer)](CotType &&cot,
+                                              std::vector<SharedBlob> &out) {
+    out.push_back(std::make_shared<std::vector<std::byte> const>(
+        serializer->serialize(cot)));
+  };
+}
+
+}  // namespace taktile
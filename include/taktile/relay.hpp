@@ -0,0 +1,74 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "taktile/functions.hpp"
+#include "taktile/xml_parser.hpp"
+
+namespace taktile {
+
+/// @brief A received CoT event, forwarded with its original bytes
+/// @details Cot2Xml and the direct decoder keep only the fields of CotType,
+///          so anything else an event carries (contacts, groups and the
+///          rest of <detail>) is lost when it is decoded and re-encoded.  A
+///          relay event instead keeps views of the received bytes, which
+///          must outlive it, and write() copies them through with only the
+///          event's time and this node's flow-tag changed.
+class CotRelayEvent {
+ public:
+  /// @throws std::invalid_argument if the event is malformed or has no time
+  ///         attribute or <point>
+  explicit CotRelayEvent(std::string_view xml);
+
+  CotRelayEvent(std::byte const *data, std::size_t size)
+      : CotRelayEvent(
+            std::string_view{reinterpret_cast<char const *>(data), size}) {}
+
+  explicit CotRelayEvent(std::vector<std::byte> const &blob)
+      : CotRelayEvent(blob.data(), blob.size()) {}
+
+  /// @brief Raw content of <detail>, a view into the received bytes
+  [[nodiscard]] std::string_view detail() const {
+    return xml_.substr(spans_.detail_begin,
+                       spans_.detail_end - spans_.detail_begin);
+  }
+
+  /// @brief Whether this node has already relayed the event
+  /// @details True if its flow-tags carry this node's attribute; forwarding
+  ///          it again would loop.
+  [[nodiscard]] bool looped() const {
+    return spans_.looped;
+  }
+
+  /// @brief Parse and validate the fields of CotType
+  /// @throws std::invalid_argument if the event is malformed or invalid
+  [[nodiscard]] CotType decode() const {
+    return read_cot_xml(xml_);
+  }
+
+  /// @brief Size in bytes of what write() produces
+  [[nodiscard]] std::size_t size() const;
+
+  /// @brief Write the event with time set to now and this node's flow-tag
+  ///        added
+  /// @details A looped event keeps one flow-tag from this node, rewritten
+  ///          to now, so the output stays well-formed.
+  /// @param now milliseconds since the Unix epoch
+  /// @param buffer destination
+  /// @param capacity size of the destination in bytes
+  /// @return number of bytes written
+  /// @throws std::length_error if capacity is less than size()
+  std::size_t write(int64_t now, std::byte *buffer,
+                    std::size_t capacity) const;
+
+ private:
+  std::string_view xml_;
+  CotRelaySpans spans_;
+};
+
+}  // namespace taktile
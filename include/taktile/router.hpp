@@ -0,0 +1,104 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "taktile/functions.hpp"
+#include "taktile/stream.hpp"
+#include "taktile/udp.hpp"
+
+namespace taktile {
+
+/// @brief Which message a full route queue gives up
+enum class DropPolicy {
+  /// @brief Refuse the message being routed
+  NEWEST,
+  /// @brief Discard the oldest queued message to make room
+  OLDEST
+};
+
+/// @brief Per-destination options for CotRouter
+struct RouteOptions {
+  /// @brief Most messages queued for this destination between flushes
+  std::size_t queue_capacity{1024};
+  /// @brief What to drop once queue_capacity is reached; for track updates
+  ///        the newest position is the one worth keeping
+  DropPolicy drop_policy{DropPolicy::OLDEST};
+  /// @brief Socket options, used by udp URLs
+  UdpSenderOptions udp;
+  /// @brief Connection options, used by tcp and tls URLs
+  StreamOptions stream;
+};
+
+/// @brief Running totals of one CotRouter destination
+struct RouteStats {
+  uint64_t routed{0};
+  uint64_t sent{0};
+  uint64_t dropped{0};
+  /// @brief Set once the destination's connection has failed; everything
+  ///        routed to it afterwards is dropped
+  bool failed{false};
+};
+
+/// @brief Sends each CoT event to several destinations, serializing it once
+/// @details Every routed event is serialized into one immutable SharedBlob
+///          whose reference is queued on each destination, so fan-out costs
+///          no copies.  Destinations have their own bounded queue and drop
+///          policy, and flush() never blocks, so a slow TCP peer only drops
+///          its own messages instead of stalling the others.  Not
+///          thread-safe.
+class CotRouter {
+ public:
+  class Route;
+
+  /// @brief Construct a router with the same options for every destination
+  /// @param serializer
+  /// @param urls udp, udp+broadcast, udp+wo, tcp, tls or log URLs
+  /// @param options
+  /// @throws std::invalid_argument if a URL cannot be routed to
+  /// @throws std::system_error if a socket or connection cannot be set up
+  explicit CotRouter(std::shared_ptr<CotSerializer> serializer,
+                     std::vector<URL> const &urls = {},
+                     RouteOptions const &options = {});
+
+  ~CotRouter();
+
+  CotRouter(CotRouter const &) = delete;
+  CotRouter(CotRouter &&) = delete;
+  CotRouter &operator=(CotRouter const &) = delete;
+  CotRouter &operator=(CotRouter &&) = delete;
+
+  /// @brief Add a destination
+  /// @return index of the destination, for stats()
+  /// @throws std::invalid_argument if the URL cannot be routed to
+  /// @throws std::system_error if a socket or connection cannot be set up
+  std::size_t add_route(URL const &url, RouteOptions const &options = {});
+
+  /// @brief Serialize an event once and queue it on every destination
+  /// @return number of destinations that queued it
+  std::size_t route(CotType const &cot);
+
+  /// @brief Queue an already serialized event on every destination
+  /// @return number of destinations that queued it
+  std::size_t route(SharedBlob const &blob);
+
+  /// @brief Hand queued messages to every destination without blocking
+  void flush();
+
+  [[nodiscard]] std::size_t size() const {
+    return routes_.size();
+  }
+
+  /// @brief Totals of the destination at index
+  [[nodiscard]] RouteStats const &stats(std::size_t index) const;
+
+ private:
+  std::shared_ptr<CotSerializer> serializer_;
+  std::vector<std::unique_ptr<Route>> routes_;
+};
+
+}  // namespace taktile
@@ -0,0 +1,165 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "taktile/functions.hpp"
+
+namespace taktile {
+
+/// @brief Mean Earth radius (IUGG), used for great-circle distances
+static constexpr double EARTH_RADIUS_M{6371008.8};
+
+/// @brief Great-circle distance between two points, by the haversine formula
+/// @return meters
+double haversine_m(double lat1, double lon1, double lat2, double lon2);
+
+/// @brief Latitude/longitude box in degrees
+/// @details A box whose min_lon is greater than its max_lon crosses the
+///          antimeridian.
+struct GeoBox {
+  double min_lat{-90.0};
+  double min_lon{-180.0};
+  double max_lat{90.0};
+  double max_lon{180.0};
+};
+
+/// @brief Grid index of track positions for box and radius queries
+/// @details The globe is cut into square cells of cell_degrees.  Each track
+///          is stored once, and each cell lists the tracks in it.  Moving a
+///          track to another cell swaps it out of the old cell's list and
+///          appends it to the new one, so a moving track costs no allocation
+///          once the cells have grown to size.  Emptied cells keep their
+///          capacity for the next track to arrive.  Not thread-safe.
+class SpatialIndex {
+ public:
+  /// @param cell_degrees cell size; about the radius of typical queries
+  /// @throws std::invalid_argument if cell_degrees is not in (0, 180]
+  explicit SpatialIndex(double cell_degrees = 0.1);
+
+  /// @brief Insert a track, or move it if the uid is already indexed
+  /// @throws std::invalid_argument if lat or lon is out of range
+  void update(std::string const &uid, double lat, double lon);
+
+  /// @brief Insert or move a track to a CoT event's position
+  void update(CotType const &cot) {
+    update(cot.uid, cot.lat, cot.lon);
+  }
+
+  /// @return false if the uid is not indexed
+  bool remove(std::string const &uid);
+
+  [[nodiscard]] std::size_t size() const {
+    return entries_.size();
+  }
+
+  /// @brief Call f(uid, lat, lon) for every track inside a box
+  template <typename F>
+  void for_each_within(GeoBox const &box, F &&f) const {
+    if (box.min_lon > box.max_lon) {
+      for_each_within({box.min_lat, box.min_lon, box.max_lat, 180.0}, f);
+      for_each_within({box.min_lat, -180.0, box.max_lat, box.max_lon}, f);
+      return;
+    }
+    for_each_cell(box, [&box, &f](Entry const &entry) {
+      if (entry.lat >= box.min_lat && entry.lat <= box.max_lat &&
+          entry.lon >= box.min_lon && entry.lon <= box.max_lon) {
+        f(entry.uid, entry.lat, entry.lon);
+      }
+    });
+  }
+
+  /// @brief Call f(uid, lat, lon) for every track within radius_m meters
+  ///        (great-circle) of a point
+  template <typename F>
+  void for_each_within(double lat, double lon, double radius_m, F &&f) const {
+    std::array<GeoBox, 2> boxes;
+    auto const count = radius_boxes(lat, lon, radius_m, boxes);
+    for (std::size_t i = 0; i < count; ++i) {
+      for_each_cell(boxes[i], [&](Entry const &entry) {
+        if (haversine_m(lat, lon, entry.lat, entry.lon) <= radius_m) {
+          f(entry.uid, entry.lat, entry.lon);
+        }
+      });
+    }
+  }
+
+  /// @brief uids of the tracks inside a box
+  [[nodiscard]] std::vector<std::string> within(GeoBox const &box) const;
+
+  /// @brief uids of the tracks within radius_m meters of a point
+  [[nodiscard]] std::vector<std::string> within(double lat, double lon,
+                                                double radius_m) const;
+
+ private:
+  struct Entry {
+    std::string uid;
+    double lat;
+    double lon;
+    int64_t cell;
+    // Position of this entry in its cell's list.
+    std::size_t slot;
+  };
+
+  [[nodiscard]] int64_t row(double lat) const;
+  [[nodiscard]] int64_t column(double lon) const;
+
+  /// @brief Boxes, none crossing the antimeridian, that cover a circle
+  /// @return number of boxes written
+  static std::size_t radius_boxes(double lat, double lon, double radius_m,
+                                  std::array<GeoBox, 2> &boxes);
+
+  /// @brief Call f(entry) for every entry in a cell overlapping the box
+  template <typename F>
+  void for_each_cell(GeoBox const &box, F &&f) const {
+    auto const row_begin = row(box.min_lat);
+    auto const row_end = row(box.max_lat);
+    auto const column_begin = column(box.min_lon);
+    auto const column_end = column(box.max_lon);
+    if (row_end < row_begin || column_end < column_begin) {
+      return;
+    }
+    auto const visit = [this, &f](std::vector<std::size_t> const &ids) {
+      for (auto const id : ids) {
+        f(entries_[id]);
+      }
+    };
+    auto const area =
+        (row_end - row_begin + 1) * (column_end - column_begin + 1);
+    if (static_cast<std::size_t>(area) > cells_.size()) {
+      // A large box: fewer cells are occupied than covered.
+      for (auto const &[cell, ids] : cells_) {
+        auto const r = cell / columns_;
+        auto const c = cell % columns_;
+        if (r >= row_begin && r <= row_end && c >= column_begin &&
+            c <= column_end) {
+          visit(ids);
+        }
+      }
+      return;
+    }
+    for (auto r = row_begin; r <= row_end; ++r) {
+      for (auto c = column_begin; c <= column_end; ++c) {
+        auto const it = cells_.find(r * columns_ + c);
+        if (it != cells_.end()) {
+          visit(it->second);
+        }
+      }
+    }
+  }
+
+  double cell_degrees_;
+  int64_t rows_;
+  int64_t columns_;
+  std::vector<Entry> entries_;
+  std::unordered_map<std::string, std::size_t> ids_;
+  std::unordered_map<int64_t, std::vector<std::size_t>> cells_;
+};
+
+}  // namespace taktile
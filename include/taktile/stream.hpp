@@ -0,0 +1,193 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <sys/uio.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "taktile/constants.hpp"
+#include "taktile/functions.hpp"
+
+namespace taktile {
+
+/// @brief Splits a byte stream of back-to-back <event>...</event> documents
+/// @details Bytes are appended as they arrive and complete events are handed
+///          out in order.  The search for </event> resumes where the last one
+///          stopped, so a partial read is never re-scanned from the start.
+class CotEventFramer {
+ public:
+  /// @param max_event_size largest event accepted before the stream is
+  ///        considered corrupt
+  explicit CotEventFramer(std::size_t max_event_size = MAX_TCP_BLOB_SIZE);
+
+  /// @brief Writable space for at least min_size more bytes
+  /// @details Read into the returned buffer, then call commit().
+  std::byte *prepare(std::size_t min_size);
+
+  /// @brief Mark size bytes written into the prepare() buffer as received
+  void commit(std::size_t size);
+
+  /// @brief Append received bytes
+  void append(std::byte const *data, std::size_t size);
+
+  /// @brief Next complete event, if one has been received
+  /// @details The view is valid until the next prepare() or append().
+  /// @throws std::length_error if more than max_event_size bytes have been
+  ///         buffered without an </event>
+  std::optional<std::string_view> next();
+
+  /// @brief Bytes received but not yet handed out as events
+  [[nodiscard]] std::size_t buffered() const {
+    return end_ - begin_;
+  }
+
+  /// @brief Largest event accepted
+  [[nodiscard]] std::size_t max_event_size() const {
+    return max_event_size_;
+  }
+
+ private:
+  std::size_t max_event_size_;
+  std::vector<char> buffer_;
+  std::size_t begin_{0};
+  std::size_t scan_{0};
+  std::size_t end_{0};
+};
+
+/// @brief Options for CotStream
+struct StreamOptions {
+  /// @brief Bytes queued for sending before enqueue() refuses more
+  std::size_t max_queued_bytes{1 << 20};
+  /// @brief Most queued messages coalesced into one writev
+  std::size_t max_batch{64};
+  /// @brief Connect (and TLS handshake) timeout
+  int connect_timeout_ms{5000};
+  /// @brief TLS only: PEM file of trusted CAs; empty uses the system store
+  std::string ca_file;
+  /// @brief TLS only: PEM client certificate and key, for mutual TLS
+  std::string cert_file;
+  std::string key_file;
+  /// @brief TLS only: verify the server certificate and host name
+  bool verify_peer{true};
+};
+
+/// @brief Running totals of a CotStream
+struct StreamStats {
+  uint64_t messages_sent{0};
+  uint64_t bytes_sent{0};
+  uint64_t write_calls{0};
+  uint64_t events_received{0};
+  uint64_t bytes_received{0};
+  uint64_t refused{0};
+};
+
+/// @brief Persistent TCP or TLS connection carrying CoT events
+/// @details Outgoing messages are queued and written with as few syscalls
+///          as possible: writev over up to max_batch messages for TCP, or a
+///          single coalesced TLS record for TLS.  The queue is bounded, so a
+///          slow peer pushes back on the producer instead of growing memory.
+///          Incoming bytes are split into events by a CotEventFramer.  Not
+///          thread-safe.
+class CotStream {
+ public:
+  /// @brief Called with the raw bytes of each received event
+  using Handler = std::function<void(std::string_view)>;
+
+  class Transport;
+
+  /// @brief Connect to a TAK server
+  /// @param url a TCP or TLS URL
+  /// @param options
+  /// @throws std::invalid_argument if the URL is not a TCP or TLS URL
+  /// @throws std::system_error if the connection or handshake fails
+  explicit CotStream(URL const &url, StreamOptions options = {});
+
+  ~CotStream();
+
+  CotStream(CotStream const &) = delete;
+  CotStream(CotStream &&) = delete;
+  CotStream &operator=(CotStream const &) = delete;
+  CotStream &operator=(CotStream &&) = delete;
+
+  /// @brief Queue a message without blocking
+  /// @return false if the payload is empty, or (counted as refused) if the
+  ///         queue is full
+  bool enqueue(std::vector<std::byte> &&payload);
+
+  /// @brief Queue a shared message without blocking or copying it
+  /// @return false if the payload is null or empty, or (counted as refused)
+  ///         if the queue is full
+  bool enqueue(SharedBlob blob);
+
+  /// @brief Queue a copy of a serialized message without blocking
+  /// @return as enqueue(std::vector<std::byte> &&)
+  bool enqueue(std::byte const *data, std::size_t size);
+
+  /// @brief Queue the payload of a CoT message without blocking
+  template <size_t N>
+  bool enqueue(CotMessage<N> const &message) {
+    auto const &blob = message.blob();
+    return enqueue(blob.data(), blob.size());
+  }
+
+  /// @brief Queue a copy of the payload of an inline CoT message
+  template <size_t N>
+  bool enqueue(InlineCotMessage<N> const &message) {
+    static_assert(N <= MAX_TCP_BLOB_SIZE,
+                  "InlineCotMessage capacity exceeds MAX_TCP_BLOB_SIZE");
+    return enqueue(message.data(), message.size());
+  }
+
+  /// @brief Queue a message, flushing and waiting for room if needed
+  /// @return false if there was still no room after timeout_ms
+  bool send(std::vector<std::byte> &&payload, int timeout_ms);
+
+  /// @brief Write as much of the queue as the socket accepts right now
+  /// @return bytes written
+  /// @throws std::system_error if the connection fails
+  std::size_t flush();
+
+  /// @brief Keep flushing until the queue is empty
+  /// @return false if data was still queued after timeout_ms
+  bool drain(int timeout_ms);
+
+  /// @brief Read what is available and hand out every complete event
+  /// @param on_event
+  /// @param timeout_ms how long to wait for a complete event
+  /// @return number of events handed out; 0 on timeout
+  /// @throws std::system_error if the connection fails or is closed
+  /// @throws std::length_error if the peer sends an oversize event
+  std::size_t receive(Handler const &on_event, int timeout_ms);
+
+  [[nodiscard]] std::size_t queued_bytes() const {
+    return queued_bytes_;
+  }
+
+  [[nodiscard]] StreamStats const &stats() const {
+    return stats_;
+  }
+
+ private:
+  bool wait_writable(int timeout_ms);
+
+  StreamOptions options_;
+  std::unique_ptr<Transport> transport_;
+  std::deque<SharedBlob> queue_;
+  std::size_t queued_bytes_{0};
+  // Bytes of the front message already written by a partial write.
+  std::size_t front_offset_{0};
+  std::vector<iovec> iovecs_;
+  CotEventFramer framer_;
+  StreamStats stats_;
+};
+
+}  // namespace taktile
@@ -0,0 +1,135 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "taktile/functions.hpp"
+#include "taktile/metrics.hpp"
+
+namespace taktile {
+
+/// @brief When CotSuppressor lets an update through
+struct SuppressionOptions {
+  /// @brief Least movement in meters that counts as a change
+  double min_distance_m{5.0};
+  /// @brief Least movement, as a fraction of the event's ce, that counts as
+  ///        a change; the larger of the two applies.  Ignored while ce is
+  ///        unknown (DEFAULT_COT_VAL).
+  double ce_fraction{0.5};
+  /// @brief Longest gap between updates sent for a uid, in milliseconds
+  int64_t max_interval_ms{30000};
+  /// @brief Send an update at least this long before the last one sent goes
+  ///        stale, in milliseconds
+  int64_t stale_margin_ms{5000};
+  /// @brief Shortest gap between updates sent for a uid, in milliseconds,
+  ///        even if they changed; 0 for no limit
+  int64_t min_interval_ms{100};
+  /// @brief Uids tracked at once, rounded up to a power of two
+  std::size_t capacity{16384};
+};
+
+/// @brief Running totals of a CotSuppressor
+struct SuppressionStats {
+  /// @brief Updates let through
+  uint64_t passed{0};
+  /// @brief Updates dropped as unchanged since the last one sent
+  uint64_t suppressed{0};
+  /// @brief Updates dropped by min_interval_ms although they changed
+  uint64_t rate_limited{0};
+  /// @brief Updates let through unjudged because the table was full
+  uint64_t untracked{0};
+};
+
+/// @brief What CotSuppressor last let through for a uid
+struct SuppressedState {
+  double lat{0.0};
+  double lon{0.0};
+  double hae{DEFAULT_COT_VAL};
+  /// @brief When it was let through, in milliseconds since the Unix epoch
+  int64_t sent{0};
+  /// @brief Its stale time, in milliseconds since the Unix epoch
+  int64_t stale{0};
+};
+
+/// @brief Drops CoT updates that tell receivers nothing new, before they are
+///        serialized
+/// @details An update for a uid is let through if it is the first, if its
+///          cot_type changed, if it moved further than the larger of
+///          min_distance_m and ce_fraction * ce from the last update let
+///          through, or if max_interval_ms has passed or the last update is
+///          about to go stale.  Regardless, at most one update per
+///          min_interval_ms is let through for each uid.
+///
+///          State is one cache line per uid in a fixed open-addressed table,
+///          keyed by a 64-bit hash of the uid, so nothing is allocated after
+///          construction.  Each line is guarded by a sequence lock: admit()
+///          holds it only while judging one update, and last_sent() reads
+///          without locking.  Lines of uids that went stale are reused once
+///          the table fills.  Thread-safe.
+class CotSuppressor {
+ public:
+  explicit CotSuppressor(SuppressionOptions options = {});
+
+  ~CotSuppressor();
+
+  CotSuppressor(CotSuppressor const &) = delete;
+  CotSuppressor &operator=(CotSuppressor const &) = delete;
+
+  /// @brief Judge an update at the current time
+  /// @return true if it should be sent
+  bool admit(CotType const &cot);
+
+  /// @brief Judge an update
+  /// @param cot
+  /// @param now milliseconds since the Unix epoch
+  /// @return true if it should be sent
+  bool admit(CotType const &cot, int64_t now);
+
+  /// @brief The last update let through for uid, read without locking
+  [[nodiscard]] std::optional<SuppressedState> last_sent(
+      std::string_view uid) const;
+
+  /// @brief Totals since construction
+  /// @details Also added up over all suppressors in the
+  ///          taktile_suppressed_total and taktile_rate_limited_total
+  ///          metrics.
+  [[nodiscard]] SuppressionStats stats() const;
+
+ private:
+  struct Slot;
+
+  [[nodiscard]] Slot *find(uint64_t key) const;
+
+  [[nodiscard]] Slot *claim(uint64_t key, int64_t now);
+
+  SuppressionOptions options_;
+  std::size_t mask_;
+  std::unique_ptr<Slot[]> slots_;
+  Counter passed_;
+  Counter suppressed_;
+  Counter rate_limited_;
+  Counter untracked_;
+  Counter &suppressed_metric_;
+  Counter &rate_limited_metric_;
+};
+
+/// @brief Stage function that drops updates a suppressor rejects
+/// @details Sits in front of encode_stage(), so suppressed updates are never
+///          serialized.
+inline auto suppress_stage(std::shared_ptr<CotSuppressor> suppressor) {
+  return [suppressor = std::move(suppressor)](CotType &&cot,
+                                              std::vector<CotType> &out) {
+    if (suppressor->admit(cot)) {
+      out.push_back(std::move(cot));
+    }
+  };
+}
+
+}  // namespace taktile
@@ -0,0 +1,172 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "taktile/constants.hpp"
+#include "taktile/functions.hpp"
+
+namespace taktile {
+
+/// @brief First byte of every TAK protocol frame
+static constexpr std::byte TAK_MAGIC{0xbf};
+/// @brief The TAK protocol version this library speaks
+static constexpr uint8_t TAK_PROTOCOL_VERSION{1};
+
+/// @brief Wire encoding of CoT events
+enum class TakProtocol {
+  /// @brief <event> XML documents (TAK protocol version 0)
+  XML,
+  /// @brief TakMessage protobufs (TAK protocol version 1)
+  PROTOBUF,
+};
+
+/// @brief How a TakMessage is framed
+enum class TakFraming {
+  /// @brief 0xbf, version, 0xbf, then the message; one per UDP datagram
+  MESH,
+  /// @brief 0xbf, varint message length, then the message; back to back on
+  ///        a TCP or TLS stream
+  STREAM,
+};
+
+/// @brief Framing that TAK protocol v1 uses on a URL
+/// @return STREAM for TCP and TLS URLs, MESH otherwise
+TakFraming tak_framing(URL const &url);
+
+/// @brief Encoding of a received message, from its first byte
+TakProtocol detect_protocol(std::byte const *data, std::size_t size);
+
+/// @brief Encode a CoT event as a framed TAK protocol v1 TakMessage
+/// @details The protobuf wire format is written directly, with no protobuf
+///          runtime.  Fields are those of CotEvent in cotevent.proto; the
+///          event carries no <detail>, as CotType has none.
+/// @param cot
+/// @param framing
+/// @param buffer destination
+/// @param capacity size of the destination in bytes
+/// @return number of bytes written
+/// @throws std::length_error if the frame does not fit in capacity bytes
+std::size_t write_cot_proto(CotType const &cot, TakFraming framing,
+                            std::byte *buffer, std::size_t capacity);
+
+/// @brief Decode a framed TAK protocol v1 TakMessage
+/// @details Unknown fields, including CotEvent's detail, are skipped.
+///          Decoded events are validated as read_cot_xml validates them.
+/// @param frame one complete frame
+/// @param framing
+/// @return cot
+/// @throws std::invalid_argument if the frame or message is malformed, has
+///         no cotEvent or fails validation
+CotType read_cot_proto(std::string_view frame, TakFraming framing);
+
+/// @brief TAK protocol v1 serializer, a compact alternative to XML
+/// @details deserialize() also accepts XML events, since peers move to
+///          protobuf one at a time and a mesh can carry both at once.
+class CotProtoSerializer : public CotSerializer {
+ public:
+  /// @brief Construct a serializer bounded by the usual size for framing
+  /// @param framing MESH for UDP, bounded by MAX_UDP_BLOB_SIZE, or STREAM
+  ///        for TCP and TLS, bounded by MAX_TCP_BLOB_SIZE
+  explicit CotProtoSerializer(TakFraming framing = TakFraming::MESH);
+
+  /// @param framing MESH for UDP, STREAM for TCP and TLS
+  /// @param max_blob_size largest message in bytes, framing included
+  CotProtoSerializer(TakFraming framing, std::size_t max_blob_size);
+
+  /// @throws std::length_error if the message exceeds max_blob_size bytes
+  std::vector<std::byte> serialize(CotType const &entity) override;
+
+  /// @throws std::invalid_argument if the message is malformed or invalid
+  CotType deserialize(std::vector<std::byte> const &_blob) override;
+
+  /// @throws std::length_error if the message exceeds capacity bytes
+  std::size_t serialize_into(CotType const &entity, std::byte *buffer,
+                             std::size_t capacity) override;
+
+  /// @throws std::invalid_argument if the message is malformed or invalid
+  CotType deserialize_from(std::byte const *data, std::size_t size) override;
+
+ private:
+  TakFraming framing_;
+  std::size_t max_blob_size_;
+};
+
+/// @brief Splits a TAK protocol v1 byte stream into frames
+/// @details The stream counterpart of CotEventFramer: bytes are appended as
+///          they arrive and each complete frame is handed out in order,
+///          ready for read_cot_proto with TakFraming::STREAM.
+class TakStreamFramer {
+ public:
+  /// @param max_message_size largest message accepted before the stream is
+  ///        considered corrupt
+  explicit TakStreamFramer(std::size_t max_message_size = MAX_TCP_BLOB_SIZE);
+
+  /// @brief Append received bytes
+  void append(std::byte const *data, std::size_t size);
+
+  /// @brief Next complete frame, if one has been received
+  /// @details The view is valid until the next append().
+  /// @throws std::invalid_argument if the stream is not TAK protocol v1
+  /// @throws std::length_error if a frame declares more than
+  ///         max_message_size bytes
+  std::optional<std::string_view> next();
+
+  /// @brief Bytes received but not yet handed out as frames
+  [[nodiscard]] std::size_t buffered() const {
+    return buffer_.size() - begin_;
+  }
+
+ private:
+  std::size_t max_message_size_;
+  std::vector<char> buffer_;
+  std::size_t begin_{0};
+};
+
+/// @brief Chooses XML or protobuf for each peer
+/// @details As TAK clients do, every peer starts on XML and moves to
+///          protobuf once it has shown it speaks TAK protocol v1: by sending
+///          a protobuf message, or, for a TAK server, by advertising
+///          <TakProtocolSupport version="1"/> in an XML event.  Thread-safe.
+class TakProtocolNegotiator {
+ public:
+  /// @param preferred PROTOBUF to upgrade peers that support it; XML to
+  ///        stay on XML regardless
+  explicit TakProtocolNegotiator(
+      TakProtocol preferred = TakProtocol::PROTOBUF);
+
+  /// @brief Protocol to send to url in
+  [[nodiscard]] TakProtocol protocol(URL const &url) const;
+
+  /// @brief Serializer for sending to url, framed for its scheme
+  [[nodiscard]] std::shared_ptr<CotSerializer> serializer(
+      URL const &url) const;
+
+  /// @brief Note a message received from url, upgrading it if it shows
+  ///        support for protobuf
+  /// @return the protocol the message is in
+  TakProtocol observe(URL const &url, std::byte const *data,
+                      std::size_t size);
+
+  /// @brief Set the protocol for url, as after an explicit negotiation
+  void set(URL const &url, TakProtocol protocol);
+
+ private:
+  TakProtocol preferred_;
+  std::shared_ptr<CotSerializer> xml_;
+  std::shared_ptr<CotSerializer> mesh_;
+  std::shared_ptr<CotSerializer> stream_;
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, TakProtocol> peers_;
+};
+
+}  // namespace taktile
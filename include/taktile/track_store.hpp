@@ -0,0 +1,111 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "taktile/functions.hpp"
+
+namespace taktile {
+
+/// @brief Immutable latest state of one track, shared with snapshots
+using Track = std::shared_ptr<CotType const>;
+
+/// @brief Options for TrackStore
+struct TrackStoreOptions {
+  /// @brief Independently locked partitions; more shards, less contention
+  std::size_t shards{16};
+  /// @brief Expiry resolution; tracks expire at most this late
+  int64_t tick_ms{100};
+};
+
+/// @brief Read-only view of every track as of the last TrackStore::expire
+class TrackSnapshot {
+ public:
+  /// @brief A run of one shard's tracks, shared by every snapshot published
+  ///        while none of them changed
+  using Chunk = std::shared_ptr<std::vector<Track> const>;
+  /// @brief The chunks of one shard
+  using Shard = std::shared_ptr<std::vector<Chunk> const>;
+
+  TrackSnapshot() = default;
+
+  explicit TrackSnapshot(std::vector<Shard> shards);
+
+  /// @brief Number of tracks
+  [[nodiscard]] std::size_t size() const;
+
+  /// @brief Call f(Track const&) for every track, in no particular order
+  template <typename F>
+  void for_each(F &&f) const {
+    for (auto const &shard : shards_) {
+      for (auto const &chunk : *shard) {
+        for (auto const &track : *chunk) {
+          f(track);
+        }
+      }
+    }
+  }
+
+ private:
+  std::vector<Shard> shards_;
+};
+
+/// @brief Concurrent map of uid to the newest CotType, expired at stale
+/// @details Updates lock one of several shards.  Each shard keeps its
+///          tracks on a hierarchical timer wheel (4 levels of 64 slots),
+///          so expiry only visits tracks that are due and an update is O(1).
+///          Snapshots are immutable and published by atomically swapping a
+///          shared_ptr, so readers never take a shard lock or wait on
+///          updates.  A changed shard republishes on the next expire(), so
+///          snapshots lag by at most one call to it.  Publishing is
+///          copy-on-write per chunk of 256 tracks: only chunks holding a
+///          changed track are copied, plus one pointer per chunk, so a call
+///          costs O(changed chunks * 256 + tracks / 256) under the shard
+///          lock rather than a copy of every track.
+class TrackStore {
+ public:
+  class Shard;
+
+  explicit TrackStore(TrackStoreOptions options = {});
+
+  ~TrackStore();
+
+  TrackStore(TrackStore const &) = delete;
+  TrackStore(TrackStore &&) = delete;
+  TrackStore &operator=(TrackStore const &) = delete;
+  TrackStore &operator=(TrackStore &&) = delete;
+
+  /// @brief Store an event unless a newer one (by time) is stored for its uid
+  /// @return true if the event was stored
+  bool upsert(CotType cot);
+
+  /// @brief Latest state of a uid, read under its shard's lock
+  /// @return nullptr if the uid is not stored
+  [[nodiscard]] Track find(std::string const &uid) const;
+
+  /// @brief Remove tracks whose stale time is at or before now, then publish
+  ///        snapshots of the shards that changed
+  /// @param now milliseconds since the Unix epoch
+  /// @return number of tracks removed
+  std::size_t expire(int64_t now);
+
+  /// @brief Snapshot of every shard as of the last expire()
+  /// @details Takes no shard lock, so it never waits on upsert or expire.
+  [[nodiscard]] TrackSnapshot snapshot() const;
+
+  /// @brief Number of stored tracks
+  [[nodiscard]] std::size_t size() const;
+
+ private:
+  [[nodiscard]] Shard &shard_for(std::string const &uid) const;
+
+  TrackStoreOptions options_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+}  // namespace taktile
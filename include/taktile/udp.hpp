@@ -0,0 +1,265 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "taktile/capture.hpp"
+#include "taktile/constants.hpp"
+#include "taktile/cot_view.hpp"
+#include "taktile/functions.hpp"
+#include "taktile/metrics.hpp"
+
+namespace taktile {
+
+/// @brief Socket options for CotUdpSender
+struct UdpSenderOptions {
+  /// @brief IP_MULTICAST_TTL; 1 keeps traffic on the local subnet
+  int ttl{1};
+  /// @brief IP_MULTICAST_LOOP; deliver to listeners on this host too
+  bool loopback{true};
+  /// @brief Outgoing multicast interface, as an IPv4 address or interface
+  ///        name (empty for the kernel's choice)
+  std::string interface;
+  /// @brief Most datagrams handed to a single sendmmsg call
+  std::size_t batch_size{64};
+  /// @brief Most datagrams queued between flushes before new ones are dropped
+  std::size_t queue_capacity{1024};
+};
+
+/// @brief Outcome of one CotUdpSender::flush
+struct UdpBatchResult {
+  std::size_t sent{0};
+  /// @brief Datagrams the kernel refused in this flush
+  std::size_t dropped{0};
+  /// @brief Messages enqueue() refused since the previous flush
+  /// @details Already counted as dropped in stats(), when enqueue() returned
+  ///          false; callers that retry them should not count them again.
+  std::size_t refused{0};
+  std::size_t syscalls{0};
+};
+
+/// @brief Running totals of a CotUdpSender
+/// @details Also added up over all senders in the taktile_udp_sent_total
+///          and taktile_udp_dropped_total metrics.
+struct UdpSenderStats {
+  uint64_t sent{0};
+  uint64_t dropped{0};
+  /// @brief Flushes that had something to send
+  uint64_t batches{0};
+};
+
+/// @brief Batching UDP sender for unicast, broadcast and multicast CoT
+/// @details Messages are copied (or serialized) into preallocated
+///          MAX_UDP_BLOB_SIZE slots and sent on flush() with as few sendmmsg
+///          calls as possible.  Not thread-safe; use one sender per thread.
+class CotUdpSender {
+ public:
+  /// @brief Open a socket for the given destination
+  /// @param url a UDP, UDP_BROADCAST or UDP_WRITE_ONLY URL
+  /// @param options
+  /// @throws std::invalid_argument if the URL is not a UDP URL or cannot be
+  ///         resolved
+  /// @throws std::system_error if the socket cannot be set up
+  explicit CotUdpSender(URL const &url, UdpSenderOptions options = {});
+
+  ~CotUdpSender();
+
+  CotUdpSender(CotUdpSender const &) = delete;
+  CotUdpSender(CotUdpSender &&) = delete;
+  CotUdpSender &operator=(CotUdpSender const &) = delete;
+  CotUdpSender &operator=(CotUdpSender &&) = delete;
+
+  /// @brief Queue a serialized message
+  /// @return false (counted as a drop) if the queue is full or the payload
+  ///         is larger than MAX_UDP_BLOB_SIZE
+  bool enqueue(std::byte const *data, std::size_t size);
+
+  /// @brief Queue the payload of a CoT message
+  template <size_t N>
+  bool enqueue(CotMessage<N> const &message) {
+    auto const &blob = message.blob();
+    return enqueue(blob.data(), blob.size());
+  }
+
+  /// @brief Queue a shared message without copying it
+  /// @details The queue holds a reference until the next flush().
+  /// @return false (counted as a drop) if the queue is full or the payload
+  ///         is larger than MAX_UDP_BLOB_SIZE
+  bool enqueue(SharedBlob blob);
+
+  /// @brief Queue the payload of an inline CoT message
+  /// @details A capacity of at most MAX_UDP_BLOB_SIZE is checked at compile
+  ///          time, so the message always fits a slot.
+  template <size_t N>
+  bool enqueue(InlineCotMessage<N> const &message) {
+    static_assert(N <= MAX_UDP_BLOB_SIZE,
+                  "InlineCotMessage capacity exceeds MAX_UDP_BLOB_SIZE");
+    return enqueue(message.data(), message.size());
+  }
+
+  /// @brief Serialize a CoT message straight into the next queue slot
+  /// @return false (counted as a drop) if the queue is full or the message
+  ///         does not fit in MAX_UDP_BLOB_SIZE bytes
+  bool enqueue(CotType const &cot, CotSerializer &serializer);
+
+  /// @brief Send everything queued, batch_size datagrams per sendmmsg
+  /// @details Datagrams the kernel refuses are dropped rather than retried,
+  ///          so a flush never blocks on a single bad send.  With nothing
+  ///          queued no syscall is made and no batch is counted.
+  /// @return counts for this flush
+  UdpBatchResult flush();
+
+  [[nodiscard]] std::size_t queued() const {
+    return queued_;
+  }
+
+  [[nodiscard]] UdpSenderStats const &stats() const {
+    return stats_;
+  }
+
+ private:
+  using Slot = std::array<std::byte, MAX_UDP_BLOB_SIZE>;
+
+  /// @brief Count a dropped message
+  /// @return false
+  bool drop();
+
+  UdpSenderOptions options_;
+  int fd_{-1};
+  sockaddr_in destination_{};
+  std::vector<Slot> slots_;
+  std::vector<std::size_t> sizes_;
+  // Set where a queue position holds a shared message instead of a slot.
+  std::vector<SharedBlob> shared_;
+  std::vector<mmsghdr> headers_;
+  std::vector<iovec> iovecs_;
+  std::size_t queued_{0};
+  // Drops counted by enqueue() since the last flush().
+  std::size_t refused_{0};
+  UdpSenderStats stats_;
+  Counter &sent_metric_;
+  Counter &dropped_metric_;
+};
+
+/// @brief Socket and threading options for CotUdpReceiver
+struct UdpReceiverOptions {
+  /// @brief Number of receive/decode worker threads
+  std::size_t workers{1};
+  /// @brief Most datagrams pulled by a single recvmmsg call
+  std::size_t batch_size{64};
+  /// @brief Interface to join multicast groups on, as an IPv4 address or
+  ///        interface name (empty for the kernel's choice)
+  std::string interface;
+  /// @brief SO_RCVBUF in bytes per socket; 0 keeps the system default
+  int receive_buffer{0};
+  /// @brief CPUs to pin workers to, round-robin; empty leaves them unpinned
+  std::vector<int> cpus;
+  /// @brief How often idle workers check whether to stop
+  int poll_timeout_ms{100};
+  /// @brief If set, datagrams it rejects are dropped before being decoded
+  std::shared_ptr<CotFilter const> filter;
+  /// @brief If set, every datagram is recorded here before it is filtered
+  ///        or decoded, stamped with the time its batch was received
+  std::shared_ptr<CaptureWriter> capture;
+};
+
+/// @brief Running totals of a CotUdpReceiver, summed over its workers
+struct UdpReceiverStats {
+  uint64_t received{0};
+  uint64_t decode_failures{0};
+  /// @brief Datagrams larger than a receive slot, truncated and discarded
+  uint64_t oversize{0};
+  uint64_t filtered{0};
+  uint64_t kernel_drops{0};
+};
+
+/// @brief Multi-threaded UDP receiver that decodes CoT on the receiving core
+/// @details Each worker pulls datagrams with recvmmsg into preallocated
+///          MAX_UDP_BLOB_SIZE slots and decodes them on the same thread.
+///          Unicast URLs get one SO_REUSEPORT socket per worker, so the
+///          kernel shards flows across them.  Multicast and broadcast
+///          datagrams are delivered to every matching socket, so for those
+///          the workers share a single socket instead.  Kernel drops are read
+///          from SO_RXQ_OVFL.
+class CotUdpReceiver {
+ public:
+  /// @brief Called on a worker thread for every decoded message
+  /// @note Runs concurrently on all workers and must not throw.
+  using Handler = std::function<void(CotType &&)>;
+
+  /// @brief Open and bind the sockets; workers start with start()
+  /// @param url a UDP or UDP_BROADCAST URL; port 0 picks a free port
+  /// @param serializer decoder shared by all workers, so it must be safe to
+  ///        call concurrently (CotDirectXmlSerializer is)
+  /// @param handler
+  /// @param options
+  /// @throws std::invalid_argument if the URL is not a receivable UDP URL
+  /// @throws std::system_error if a socket cannot be set up
+  CotUdpReceiver(URL const &url, std::shared_ptr<CotSerializer> serializer,
+                 Handler handler, UdpReceiverOptions options = {});
+
+  ~CotUdpReceiver();
+
+  CotUdpReceiver(CotUdpReceiver const &) = delete;
+  CotUdpReceiver(CotUdpReceiver &&) = delete;
+  CotUdpReceiver &operator=(CotUdpReceiver const &) = delete;
+  CotUdpReceiver &operator=(CotUdpReceiver &&) = delete;
+
+  /// @brief Start the worker threads
+  void start();
+
+  /// @brief Stop and join the worker threads
+  void stop();
+
+  /// @brief Port the sockets are bound to
+  [[nodiscard]] uint16_t port() const {
+    return port_;
+  }
+
+  [[nodiscard]] UdpReceiverStats stats() const;
+
+ private:
+  struct alignas(64) WorkerCounters {
+    std::atomic<uint64_t> received{0};
+    std::atomic<uint64_t> decode_failures{0};
+    std::atomic<uint64_t> oversize{0};
+    std::atomic<uint64_t> filtered{0};
+  };
+
+  struct alignas(64) SocketCounters {
+    std::atomic<uint32_t> kernel_drops{0};
+  };
+
+  void run(std::size_t worker);
+
+  std::shared_ptr<CotSerializer> serializer_;
+  Handler handler_;
+  UdpReceiverOptions options_;
+  // The URL as recorded in captures.
+  std::string source_;
+  std::vector<int> fds_;
+  uint16_t port_{0};
+  std::vector<WorkerCounters> worker_counters_;
+  std::vector<SocketCounters> socket_counters_;
+  std::vector<std::thread> threads_;
+  std::atomic<bool> running_{false};
+};
+
+/// @brief Resolve the IPv4 socket address of a URL
+/// @throws std::invalid_argument if the host cannot be resolved
+sockaddr_in resolve_ipv4(URL const &url);
+
+}  // namespace taktile
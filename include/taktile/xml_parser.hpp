@@ -0,0 +1,109 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "taktile/compact_cot.hpp"
+#include "taktile/functions.hpp"
+
+namespace taktile {
+
+/// @brief Raw attribute values of a CoT event, viewed in the source buffer
+/// @details Values are still XML-escaped; absent attributes are empty.
+struct CotXmlFields {
+  std::string_view uid;
+  std::string_view cot_type;
+  std::string_view time;
+  std::string_view start;
+  std::string_view stale;
+  std::string_view lat;
+  std::string_view lon;
+  std::string_view le;
+  std::string_view hae;
+  std::string_view ce;
+};
+
+/// @brief Scan a CoT event once and pull out its <event>/<point> attributes
+/// @details No DOM is built and nothing is copied; the returned views point
+///          into xml and are only valid as long as it is.
+/// @param xml
+/// @return fields
+/// @throws std::invalid_argument if the document is not a well-formed event
+CotXmlFields scan_cot_xml(std::string_view xml);
+
+/// @brief Scan only the <event> start tag of a CoT event
+/// @details As scan_cot_xml, but stops before the first child element, so
+///          only uid, cot_type, time, start and stale are filled in.
+/// @param xml
+/// @return fields
+/// @throws std::invalid_argument if the document does not start with a
+///         well-formed <event> tag
+CotXmlFields scan_cot_event_xml(std::string_view xml);
+
+/// @brief Where a relay splices its changes into a received CoT event
+/// @details Offsets are in bytes from the start of the scanned document.
+struct CotRelaySpans {
+  /// @brief How the relay's flow-tag is written at flow_begin
+  enum class Insert {
+    /// @brief As an attribute of the existing <_flow-tags_> element
+    ATTRIBUTE,
+    /// @brief As a new <_flow-tags_> element at the end of <detail>
+    ELEMENT,
+    /// @brief As a whole <detail> element holding <_flow-tags_>
+    DETAIL,
+  };
+
+  /// @brief Value of the event's time attribute
+  std::size_t time_begin{0};
+  std::size_t time_end{0};
+  /// @brief Content of <detail>; empty if there is none
+  std::size_t detail_begin{0};
+  std::size_t detail_end{0};
+  /// @brief Bytes replaced by the flow-tag: none, or this node's earlier
+  ///        attribute if the event looped
+  std::size_t flow_begin{0};
+  std::size_t flow_end{0};
+  Insert flow_insert{Insert::DETAIL};
+  /// @brief Whether <_flow-tags_> already has the relay's attribute
+  bool looped{false};
+};
+
+/// @brief Scan a CoT event for the spans a relay rewrites
+/// @details Checks the structure of the whole event but converts nothing,
+///          so values are not validated.
+/// @param xml
+/// @param flow_tag name of the relay's own flow-tag attribute
+/// @return spans
+/// @throws std::invalid_argument if the event is malformed or has no time
+///         attribute or <point>
+CotRelaySpans scan_cot_relay_xml(std::string_view xml,
+                                 std::string_view flow_tag);
+
+/// @brief Decode an XML-escaped attribute value
+/// @param value raw attribute value
+/// @param out replaced with the decoded text
+/// @throws std::invalid_argument on a malformed entity reference
+void unescape_xml(std::string_view value, std::string &out);
+
+/// @brief Decode a CoT event from XML without building a DOM
+/// @details Raises the same errors as Cot2Xml::convert on malformed input.
+/// @param xml
+/// @return cot
+/// @throws std::invalid_argument if the event is malformed or invalid
+CotType read_cot_xml(std::string_view xml);
+
+/// @brief Decode a CoT event from XML into its compact form
+/// @details Same checks and errors as read_cot_xml.  The uid and type are
+///          interned straight from the input unless they contain entities,
+///          so decoding a known uid allocates nothing.
+/// @param xml
+/// @param interner receives the uid and type of valid events only
+/// @return cot
+/// @throws std::invalid_argument if the event is malformed or invalid
+CompactCot read_compact_cot_xml(std::string_view xml,
+                                StringInterner &interner);
+
+}  // namespace taktile
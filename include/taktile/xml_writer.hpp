@@ -0,0 +1,136 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "taktile/compact_cot.hpp"
+#include "taktile/cot_batch.hpp"
+#include "taktile/functions.hpp"
+
+namespace taktile {
+
+/// @brief Name of this node's flow-tag attribute, from default_host_id()
+/// @details Rebuilt only when the host id changes; the view is valid until
+///          then.
+std::string_view flow_tag_name();
+
+/// @brief Append-only XML writer over a caller-supplied byte buffer
+/// @details The writer never allocates.  Once a write would run past the end
+///          of the buffer, nothing more is written and overflowed() reports
+///          true; callers check once at the end instead of after every call.
+class XmlWriter {
+ public:
+  XmlWriter(std::byte *buffer, std::size_t capacity) noexcept;
+
+  /// @brief Append text verbatim
+  XmlWriter &raw(std::string_view text) noexcept;
+
+  /// @brief Append text with attribute-value escaping (as Poco's XMLWriter)
+  XmlWriter &escaped(std::string_view text) noexcept;
+
+  /// @brief Append a double with six fixed decimals (as std::to_string)
+  XmlWriter &fixed(double value) noexcept;
+
+  /// @brief Append a double with six fixed decimals, zero-padded to exactly
+  ///        width characters (e.g. "-37.774900" or "037.774900" for 10)
+  /// @details Marks the writer overflowed if the value is not finite or needs
+  ///          more than width characters.
+  XmlWriter &fixed(double value, std::size_t width) noexcept;
+
+  /// @brief Append epoch milliseconds in W3C XML datetime format
+  XmlWriter &datetime(int64_t epoch_ms) noexcept;
+
+  /// @brief Append ` name="value"` with the value escaped
+  XmlWriter &attribute(std::string_view name, std::string_view value) noexcept;
+
+  /// @brief Append ` name="value"` with the value in fixed notation
+  XmlWriter &attribute(std::string_view name, double value) noexcept;
+
+  /// @brief Append ` name="value"` with epoch milliseconds as a W3C datetime
+  XmlWriter &datetime_attribute(std::string_view name,
+                                int64_t epoch_ms) noexcept;
+
+  [[nodiscard]] std::size_t size() const noexcept { return size_; }
+
+  [[nodiscard]] bool overflowed() const noexcept { return overflowed_; }
+
+ private:
+  char *cursor() noexcept;
+
+  bool reserve(std::size_t count) noexcept;
+
+  std::byte *buffer_;
+  std::size_t capacity_;
+  std::size_t size_{0};
+  bool overflowed_{false};
+};
+
+/// @brief Widths of the zero-padded lat and lon written with a CotXmlLayout
+static constexpr std::size_t FIXED_LAT_WIDTH{10};  // -DD.dddddd
+static constexpr std::size_t FIXED_LON_WIDTH{11};  // -DDD.dddddd
+
+/// @brief Byte offsets of the values that change between re-emissions
+/// @details Each offset is the first byte of an attribute value.  Datetimes
+///          are W3C_DATETIME_LENGTH bytes; lat and lon are FIXED_LAT_WIDTH
+///          and FIXED_LON_WIDTH bytes.
+struct CotXmlLayout {
+  std::size_t time{0};
+  std::size_t start{0};
+  std::size_t stale{0};
+  std::size_t lat{0};
+  std::size_t lon{0};
+  std::size_t flow_time{0};
+};
+
+/// @brief Write a CoT event as XML directly into a byte buffer
+/// @details Produces the same bytes as Cot2Xml::convert followed by
+///          simpleio::messages::XmlSerializer (attributes in the sorted order
+///          Poco's writer emits them), but without building a DOM.  The clock
+///          is read once, for the flow-tag.
+/// @param cot
+/// @param buffer destination
+/// @param capacity size of the destination in bytes
+/// @return number of bytes written
+/// @throws std::length_error if the event does not fit in capacity bytes
+std::size_t write_cot_xml(CotType const &cot, std::byte *buffer,
+                          std::size_t capacity);
+
+/// @brief Write a CoT event as XML and record where its mutable values are
+/// @details As write_cot_xml, except that lat and lon are zero-padded to a
+///          fixed width so that any later position fits the same bytes.
+/// @param cot
+/// @param buffer destination
+/// @param capacity size of the destination in bytes
+/// @param layout receives the offsets of the mutable values
+/// @return number of bytes written
+/// @throws std::length_error if the event does not fit in capacity bytes
+std::size_t write_cot_xml(CotType const &cot, std::byte *buffer,
+                          std::size_t capacity, CotXmlLayout &layout);
+
+/// @brief Write a compact CoT event as XML directly into a byte buffer
+/// @details Same output as the CotType overload; the uid and type are read
+///          straight out of the interner's arena.
+/// @throws std::length_error if the event does not fit in capacity bytes
+/// @throws std::out_of_range if an id was not issued by interner
+std::size_t write_cot_xml(CompactCot const &cot,
+                          StringInterner const &interner, std::byte *buffer,
+                          std::size_t capacity);
+
+/// @brief Write every row of a batch as XML, one event after another
+/// @details The clock is read once for the whole batch, and rows are written
+///          in a single loop straight from the columns.  Rows are not
+///          validated; check CotBatch::validate() first.
+/// @param batch
+/// @param out replaced with the events back to back
+/// @param ends replaced with the offset one past each event in out
+/// @param max_event_size bound on each event, e.g. MAX_UDP_BLOB_SIZE
+/// @throws std::length_error if an event does not fit in max_event_size
+void write_cot_xml(CotBatch const &batch, std::vector<std::byte> &out,
+                   std::vector<std::size_t> &ends,
+                   std::size_t max_event_size = MAX_UDP_BLOB_SIZE);
+
+}  // namespace taktile
@@ -0,0 +1,290 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include "taktile/bulk_load.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <exception>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include "taktile/xml_parser.hpp"
+
+namespace taktile {
+
+namespace {
+
+constexpr std::string_view END_TAG{"</event>"};
+
+constexpr bool is_space(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+[[noreturn]] void throw_errno(std::string const& what) {
+  throw std::system_error(errno, std::generic_category(), what);
+}
+
+/// @brief A file mapped read-only for the length of a load
+class MappedFile {
+ public:
+  explicit MappedFile(std::string const& path) {
+    auto const fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      throw_errno("open " + path);
+    }
+    struct stat status {};
+    if (::fstat(fd, &status) != 0) {
+      ::close(fd);
+      throw_errno("fstat " + path);
+    }
+    size_ = static_cast<std::size_t>(status.st_size);
+    if (size_ > 0) {
+      auto* map = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (map == MAP_FAILED) {
+        ::close(fd);
+        throw_errno("mmap " + path);
+      }
+      data_ = static_cast<char const*>(map);
+      // Workers walk their chunks front to back.
+      ::madvise(map, size_, MADV_SEQUENTIAL);
+    }
+    ::close(fd);
+  }
+
+  ~MappedFile() {
+    if (data_ != nullptr) {
+      ::munmap(const_cast<char*>(data_), size_);
+    }
+  }
+
+  MappedFile(MappedFile const&) = delete;
+  MappedFile& operator=(MappedFile const&) = delete;
+
+  [[nodiscard]] std::string_view view() const {
+    return {data_, size_};
+  }
+
+ private:
+  char const* data_{nullptr};
+  std::size_t size_{0};
+};
+
+/// @brief Split an archive into chunks of about chunk_size bytes, each
+///        ending just after an </event>
+std::vector<std::string_view> split(std::string_view archive,
+                                    std::size_t chunk_size) {
+  std::vector<std::string_view> chunks;
+  std::size_t begin{0};
+  while (begin < archive.size()) {
+    auto end = archive.size();
+    if (archive.size() - begin > chunk_size) {
+      // Back up far enough to catch an </event> the cut lands inside, but
+      // never before begin, which would wrap for tiny chunk sizes.
+      auto const from =
+          begin + std::max(chunk_size, END_TAG.size()) - (END_TAG.size() - 1);
+      auto const tag = archive.find(END_TAG, from);
+      if (tag != std::string_view::npos) {
+        end = tag + END_TAG.size();
+      }
+    }
+    chunks.push_back(archive.substr(begin, end - begin));
+    begin = end;
+  }
+  return chunks;
+}
+
+/// @brief Decoded events of one chunk, by partition
+struct DecodedChunk {
+  std::vector<std::vector<CotType>> partitions;
+  uint64_t events{0};
+  uint64_t malformed{0};
+};
+
+DecodedChunk decode(std::string_view chunk, std::size_t partitions) {
+  DecodedChunk decoded;
+  decoded.partitions.resize(partitions);
+  std::size_t pos{0};
+  while (true) {
+    while (pos < chunk.size() && is_space(chunk[pos])) {
+      ++pos;
+    }
+    if (pos == chunk.size()) {
+      break;
+    }
+    auto const tag = chunk.find(END_TAG, pos);
+    if (tag == std::string_view::npos) {
+      ++decoded.malformed;
+      break;
+    }
+    auto const end = tag + END_TAG.size();
+    try {
+      auto cot = read_cot_xml(chunk.substr(pos, end - pos));
+      auto const partition =
+          partitions == 1 ? 0
+                          : std::hash<std::string>{}(cot.uid) % partitions;
+      decoded.partitions[partition].push_back(std::move(cot));
+      ++decoded.events;
+    } catch (std::exception const&) {
+      ++decoded.malformed;
+    }
+    pos = end;
+  }
+  return decoded;
+}
+
+/// @brief Hands one partition's events to the handler in chunk order
+/// @details Chunks finish out of order; whichever worker completes the next
+///          chunk in line delivers it and any later ones already waiting.
+class Sequencer {
+ public:
+  void deliver(std::size_t chunk, std::vector<CotType>&& events,
+               std::size_t partition, BulkLoadHandler const& handler) {
+    std::unique_lock lock{mutex_};
+    waiting_.emplace(chunk, std::move(events));
+    if (delivering_) {
+      return;
+    }
+    delivering_ = true;
+    while (!waiting_.empty() && waiting_.begin()->first == next_) {
+      auto batch = std::move(waiting_.begin()->second);
+      waiting_.erase(waiting_.begin());
+      ++next_;
+      lock.unlock();
+      if (!batch.empty()) {
+        try {
+          handler(partition, std::move(batch));
+        } catch (...) {
+          lock.lock();
+          delivering_ = false;
+          throw;
+        }
+      }
+      lock.lock();
+    }
+    delivering_ = false;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::map<std::size_t, std::vector<CotType>> waiting_;
+  std::size_t next_{0};
+  bool delivering_{false};
+};
+
+}  // namespace
+
+BulkLoadStats bulk_load(std::string const& path,
+                        BulkLoadOptions const& options,
+                        BulkLoadHandler const& handler) {
+  auto const start = std::chrono::steady_clock::now();
+  MappedFile const file{path};
+  auto const chunks =
+      split(file.view(), std::max<std::size_t>(options.chunk_size, 1));
+  auto const partitions = std::max<std::size_t>(options.partitions, 1);
+  auto workers = options.workers == 0
+                     ? std::size_t{std::thread::hardware_concurrency()}
+                     : options.workers;
+  workers = std::clamp<std::size_t>(workers, 1,
+                                    std::max<std::size_t>(chunks.size(), 1));
+
+  std::vector<Sequencer> sequencers(partitions);
+  std::atomic<std::size_t> next_chunk{0};
+  std::atomic<uint64_t> events{0};
+  std::atomic<uint64_t> malformed{0};
+  std::atomic<bool> failed{false};
+  std::exception_ptr error;
+  std::mutex error_mutex;
+
+  auto const work = [&] {
+    try {
+      while (!failed.load(std::memory_order_relaxed)) {
+        auto const chunk = next_chunk.fetch_add(1, std::memory_order_relaxed);
+        if (chunk >= chunks.size()) {
+          return;
+        }
+        auto decoded = decode(chunks[chunk], partitions);
+        events.fetch_add(decoded.events, std::memory_order_relaxed);
+        malformed.fetch_add(decoded.malformed, std::memory_order_relaxed);
+        for (std::size_t p = 0; p < partitions; ++p) {
+          sequencers[p].deliver(chunk, std::move(decoded.partitions[p]), p,
+                                handler);
+        }
+      }
+    } catch (...) {
+      std::lock_guard const lock{error_mutex};
+      if (!error) {
+        error = std::current_exception();
+      }
+      failed = true;
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < workers; ++i) {
+    threads.emplace_back(work);
+  }
+  work();
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+
+  BulkLoadStats stats;
+  stats.events = events.load();
+  stats.malformed = malformed.load();
+  stats.bytes = file.view().size();
+  stats.chunks = chunks.size();
+  stats.seconds = std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+  return stats;
+}
+
+BulkLoadStats bulk_load(std::string const& path,
+                        BulkLoadOptions const& options,
+                        std::vector<CotType>& events) {
+  auto ordered = options;
+  ordered.partitions = 1;
+  return bulk_load(path, ordered,
+                   [&events](std::size_t, std::vector<CotType>&& batch) {
+                     if (events.empty()) {
+                       events = std::move(batch);
+                       return;
+                     }
+                     events.insert(events.end(),
+                                   std::make_move_iterator(batch.begin()),
+                                   std::make_move_iterator(batch.end()));
+                   });
+}
+
+BulkLoadStats bulk_load(std::string const& path,
+                        BulkLoadOptions const& options, TrackStore& store) {
+  auto sharded = options;
+  auto const workers = options.workers == 0
+                           ? std::size_t{std::thread::hardware_concurrency()}
+                           : options.workers;
+  sharded.partitions = std::max(options.partitions, workers);
+  return bulk_load(path, sharded,
+                   [&store](std::size_t, std::vector<CotType>&& batch) {
+                     for (auto& cot : batch) {
+                       store.upsert(std::move(cot));
+                     }
+                   });
+}
+
+}  // namespace taktile
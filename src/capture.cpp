@@ -0,0 +1,379 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include "taktile/capture.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#include "taktile/stream.hpp"
+#include "taktile/udp.hpp"
+
+namespace taktile {
+
+namespace {
+
+/// @brief First bytes of a capture file
+struct FileHeader {
+  std::array<char, 8> magic;
+  uint64_t reserved;
+};
+
+/// @brief Precedes the source URL and payload of every record
+/// @details length is the whole record, padded to RECORD_ALIGNMENT, and is
+///          stored last; 0 marks the end of the records.
+struct RecordHeader {
+  uint32_t length;
+  uint32_t size;
+  int64_t time;
+  uint16_t source_size;
+  std::array<uint16_t, 3> reserved;
+};
+
+constexpr std::array<char, 8> MAGIC{'T', 'A', 'K', 'C', 'A', 'P', '0', '1'};
+constexpr std::size_t RECORD_ALIGNMENT{8};
+constexpr std::size_t FIRST_RECORD{sizeof(FileHeader)};
+
+// Index spacing when a missing index is rebuilt.
+constexpr std::size_t REBUILT_INDEX_INTERVAL{std::size_t{1} << 16};
+
+// Records queued on a transport before a replay flushes it.
+constexpr uint64_t REPLAY_FLUSH_RECORDS{64};
+constexpr int REPLAY_SEND_TIMEOUT_MS{1000};
+
+static_assert(sizeof(RecordHeader) % RECORD_ALIGNMENT == 0);
+static_assert(FIRST_RECORD % RECORD_ALIGNMENT == 0);
+
+[[noreturn]] void throw_errno(std::string const& what) {
+  throw std::system_error(errno, std::generic_category(), what);
+}
+
+std::string index_path(std::string const& path) {
+  return path + ".idx";
+}
+
+/// @brief Padded length of a record, or 0 if it cannot be stored
+std::size_t record_length(std::size_t source_size, std::size_t size) {
+  if (source_size > UINT16_MAX || size > UINT32_MAX) {
+    return 0;
+  }
+  auto const length = sizeof(RecordHeader) + source_size + size;
+  auto const padded =
+      (length + RECORD_ALIGNMENT - 1) / RECORD_ALIGNMENT * RECORD_ALIGNMENT;
+  return padded > UINT32_MAX ? 0 : padded;
+}
+
+/// @brief Length of the complete record at offset, or 0 if there is none
+std::size_t complete_length(std::byte const* map, std::size_t mapped,
+                            std::size_t offset) {
+  if (offset + sizeof(RecordHeader) > mapped) {
+    return 0;
+  }
+  // Pairs with the release store in CaptureWriter::append.
+  auto const length = __atomic_load_n(
+      reinterpret_cast<uint32_t const*>(map + offset), __ATOMIC_ACQUIRE);
+  if (length < sizeof(RecordHeader) || offset + length > mapped) {
+    return 0;
+  }
+  return length;
+}
+
+}  // namespace
+
+CaptureWriter::CaptureWriter(std::string path, CaptureOptions options)
+    : path_{std::move(path)}, options_{options} {
+  if (options_.max_size < FIRST_RECORD + sizeof(RecordHeader)) {
+    throw std::invalid_argument("Capture max_size is too small.");
+  }
+  if (options_.index_interval == 0) {
+    throw std::invalid_argument("Capture index_interval must be positive.");
+  }
+  // A stale index from an earlier capture would point into the wrong file.
+  ::unlink(index_path(path_).c_str());
+  fd_ = ::open(path_.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd_ < 0) {
+    throw_errno("open " + path_);
+  }
+  if (::ftruncate(fd_, static_cast<off_t>(options_.max_size)) != 0) {
+    ::close(fd_);
+    throw_errno("ftruncate " + path_);
+  }
+  auto* map = ::mmap(nullptr, options_.max_size, PROT_READ | PROT_WRITE,
+                     MAP_SHARED, fd_, 0);
+  if (map == MAP_FAILED) {
+    ::close(fd_);
+    throw_errno("mmap " + path_);
+  }
+  map_ = static_cast<std::byte*>(map);
+  FileHeader const header{MAGIC, 0};
+  std::memcpy(map_, &header, sizeof(header));
+  end_ = FIRST_RECORD;
+}
+
+CaptureWriter::~CaptureWriter() {
+  try {
+    close();
+  } catch (std::exception const&) {
+    // The records are in the file; only the index is lost.
+  }
+}
+
+bool CaptureWriter::append(int64_t time, std::string_view source,
+                           std::byte const* data, std::size_t size) {
+  auto const length = record_length(source.size(), size);
+  if (length == 0 || closed_.load(std::memory_order_relaxed)) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  auto const offset = end_.fetch_add(length, std::memory_order_relaxed);
+  if (offset + length > options_.max_size) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  auto* record = map_ + offset;
+  RecordHeader const header{0, static_cast<uint32_t>(size), time,
+                            static_cast<uint16_t>(source.size()), {}};
+  std::memcpy(record, &header, sizeof(header));
+  std::memcpy(record + sizeof(header), source.data(), source.size());
+  std::memcpy(record + sizeof(header) + source.size(), data, size);
+  __atomic_store_n(reinterpret_cast<uint32_t*>(record),
+                   static_cast<uint32_t>(length), __ATOMIC_RELEASE);
+
+  auto const interval = options_.index_interval;
+  auto const start = offset - FIRST_RECORD;
+  if (start == 0 || start / interval != (start + length) / interval) {
+    std::lock_guard const lock{index_mutex_};
+    index_.emplace_back(time, offset);
+  }
+  records_.fetch_add(1, std::memory_order_relaxed);
+  bytes_.fetch_add(size, std::memory_order_relaxed);
+  return true;
+}
+
+void CaptureWriter::close() {
+  if (closed_.exchange(true)) {
+    return;
+  }
+  // Past max_size, end_ only counts reservations that were refused.
+  auto const end = std::min(end_.load(), options_.max_size);
+  ::munmap(map_, options_.max_size);
+  map_ = nullptr;
+  auto const truncated = ::ftruncate(fd_, static_cast<off_t>(end));
+  ::close(fd_);
+  fd_ = -1;
+  if (truncated != 0) {
+    throw_errno("ftruncate " + path_);
+  }
+
+  std::sort(index_.begin(), index_.end(),
+            [](auto const& a, auto const& b) { return a.second < b.second; });
+  std::ofstream out{index_path(path_), std::ios::binary | std::ios::trunc};
+  out.write(reinterpret_cast<char const*>(index_.data()),
+            static_cast<std::streamsize>(index_.size() * sizeof(index_[0])));
+  if (!out) {
+    throw std::system_error(errno, std::generic_category(),
+                            "write " + index_path(path_));
+  }
+}
+
+CaptureStats CaptureWriter::stats() const {
+  return {records_.load(std::memory_order_relaxed),
+          bytes_.load(std::memory_order_relaxed),
+          dropped_.load(std::memory_order_relaxed)};
+}
+
+CaptureReader::CaptureReader(std::string const& path) {
+  fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd_ < 0) {
+    throw_errno("open " + path);
+  }
+  struct stat status {};
+  if (::fstat(fd_, &status) != 0) {
+    ::close(fd_);
+    throw_errno("fstat " + path);
+  }
+  mapped_ = static_cast<std::size_t>(status.st_size);
+  FileHeader header{};
+  if (mapped_ < FIRST_RECORD ||
+      ::pread(fd_, &header, sizeof(header), 0) !=
+          static_cast<ssize_t>(sizeof(header)) ||
+      header.magic != MAGIC) {
+    ::close(fd_);
+    throw std::invalid_argument(path + " is not a capture file.");
+  }
+  auto* map = ::mmap(nullptr, mapped_, PROT_READ, MAP_SHARED, fd_, 0);
+  if (map == MAP_FAILED) {
+    ::close(fd_);
+    throw_errno("mmap " + path);
+  }
+  map_ = static_cast<std::byte const*>(map);
+  ::madvise(map, mapped_, MADV_SEQUENTIAL);
+
+  std::ifstream in{index_path(path), std::ios::binary};
+  for (std::pair<int64_t, uint64_t> entry;
+       in.read(reinterpret_cast<char*>(&entry), sizeof(entry));) {
+    if (entry.second >= FIRST_RECORD && entry.second < mapped_) {
+      index_.push_back(entry);
+    }
+  }
+  build_index();
+  position_ = FIRST_RECORD;
+}
+
+CaptureReader::~CaptureReader() {
+  ::munmap(const_cast<std::byte*>(map_), mapped_);
+  ::close(fd_);
+}
+
+void CaptureReader::build_index() {
+  // With an index, only the records after its last entry are walked, to
+  // find where they end.
+  auto offset = index_.empty() ? FIRST_RECORD : index_.back().second;
+  auto const rebuild = index_.empty();
+  auto next_entry = FIRST_RECORD;
+  while (auto const length = complete_length(map_, mapped_, offset)) {
+    if (rebuild && offset >= next_entry) {
+      RecordHeader header{};
+      std::memcpy(&header, map_ + offset, sizeof(header));
+      index_.emplace_back(header.time, offset);
+      next_entry = offset + REBUILT_INDEX_INTERVAL;
+    }
+    offset += length;
+  }
+  end_ = offset;
+}
+
+std::optional<CaptureRecord> CaptureReader::next() {
+  if (position_ >= end_) {
+    return std::nullopt;
+  }
+  auto const* record = map_ + position_;
+  RecordHeader header{};
+  std::memcpy(&header, record, sizeof(header));
+  position_ += header.length;
+  auto const* source = reinterpret_cast<char const*>(record + sizeof(header));
+  return CaptureRecord{header.time, {source, header.source_size},
+                       record + sizeof(header) + header.source_size,
+                       header.size};
+}
+
+void CaptureReader::seek(int64_t time) {
+  auto const later =
+      std::find_if(index_.begin(), index_.end(),
+                   [time](auto const& entry) { return entry.first >= time; });
+  position_ = later == index_.begin() ? FIRST_RECORD
+                                      : std::prev(later)->second;
+  while (position_ < end_) {
+    int64_t record_time{0};
+    std::memcpy(&record_time,
+                map_ + position_ + offsetof(RecordHeader, time),
+                sizeof(record_time));
+    if (record_time >= time) {
+      return;
+    }
+    RecordHeader header{};
+    std::memcpy(&header, map_ + position_, sizeof(header));
+    position_ += header.length;
+  }
+}
+
+void CaptureReader::rewind() {
+  position_ = FIRST_RECORD;
+}
+
+ReplayStats replay(CaptureReader& reader, ReplayOptions const& options,
+                   ReplayHandler const& emit,
+                   std::function<void()> const& flush) {
+  if (options.speed < 0.0) {
+    throw std::invalid_argument("Replay speed must not be negative.");
+  }
+  if (options.from > 0) {
+    reader.seek(options.from);
+  }
+  ReplayStats stats;
+  auto const start = std::chrono::steady_clock::now();
+  std::optional<int64_t> first;
+  while (auto const record = reader.next()) {
+    if (record->time < options.from) {
+      continue;
+    }
+    if (record->time > options.to) {
+      break;
+    }
+    if (options.speed > 0.0) {
+      if (!first) {
+        first = record->time;
+      }
+      auto const due =
+          start + std::chrono::nanoseconds(static_cast<int64_t>(
+                      static_cast<double>(record->time - *first) /
+                      options.speed));
+      if (due > std::chrono::steady_clock::now()) {
+        if (flush) {
+          flush();
+        }
+        std::this_thread::sleep_until(due);
+      }
+    }
+    emit(*record);
+    ++stats.records;
+    stats.bytes += record->size;
+  }
+  if (flush) {
+    flush();
+  }
+  stats.seconds = std::chrono::duration<double>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+  return stats;
+}
+
+ReplayStats replay(CaptureReader& reader, ReplayOptions const& options,
+                   CotUdpSender& sender) {
+  return replay(
+      reader, options,
+      [&sender](CaptureRecord const& record) {
+        sender.enqueue(record.data, record.size);
+        if (sender.queued() >= REPLAY_FLUSH_RECORDS) {
+          sender.flush();
+        }
+      },
+      [&sender] { sender.flush(); });
+}
+
+ReplayStats replay(CaptureReader& reader, ReplayOptions const& options,
+                   CotStream& stream) {
+  uint64_t unflushed{0};
+  return replay(
+      reader, options,
+      [&stream, &unflushed](CaptureRecord const& record) {
+        if (!stream.enqueue(record.data, record.size)) {
+          stream.send({record.data, record.data + record.size},
+                       REPLAY_SEND_TIMEOUT_MS);
+        }
+        if (++unflushed >= REPLAY_FLUSH_RECORDS) {
+          stream.flush();
+          unflushed = 0;
+        }
+      },
+      [&stream, &unflushed] {
+        stream.flush();
+        unflushed = 0;
+      });
+}
+
+}  // namespace taktile
@@ -0,0 +1,119 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include "taktile/compact_cot.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace taktile {
+
+namespace {
+
+/// @brief Segment and offset of an id, for segments of base << k entries
+std::pair<std::size_t, std::size_t> locate(std::size_t id,
+                                           std::size_t base_bits) {
+  auto const biased = id + (std::size_t{1} << base_bits);
+  // Index of the highest set bit; biased is never zero.
+  auto const top = static_cast<std::size_t>(
+      63 - __builtin_clzll(static_cast<unsigned long long>(biased)));
+  return {top - base_bits, biased - (std::size_t{1} << top)};
+}
+
+}  // namespace
+
+InternId StringInterner::intern(std::string_view text) {
+  {
+    std::shared_lock<std::shared_mutex> const lock{mutex_};
+    auto const it = ids_.find(text);
+    if (it != ids_.end()) {
+      return it->second;
+    }
+  }
+
+  std::unique_lock<std::shared_mutex> const lock{mutex_};
+  // Another thread may have stored it between the two locks.
+  auto const it = ids_.find(text);
+  if (it != ids_.end()) {
+    return it->second;
+  }
+  auto const id = size_.load(std::memory_order_relaxed);
+  if (id > std::numeric_limits<InternId>::max()) {
+    throw std::length_error("String interner is full.");
+  }
+  // The first string, even an empty one, needs a chunk to point into.
+  if (chunks_.empty() || CHUNK_SIZE - chunk_used_ < text.size()) {
+    chunks_.push_back(
+        std::make_unique<char[]>(std::max(CHUNK_SIZE, text.size())));
+    chunk_used_ = 0;
+  }
+  auto* const stored = chunks_.back().get() + chunk_used_;
+  std::memcpy(stored, text.data(), text.size());
+  // An oversize string fills its own chunk.
+  chunk_used_ = std::min(chunk_used_ + text.size(), CHUNK_SIZE);
+
+  auto const [segment, offset] = locate(id, FIRST_SEGMENT_BITS);
+  if (!owned_[segment]) {
+    owned_[segment] = std::make_unique<std::string_view[]>(
+        std::size_t{1} << (FIRST_SEGMENT_BITS + segment));
+    segments_[segment].store(owned_[segment].get(), std::memory_order_release);
+  }
+  owned_[segment][offset] = {stored, text.size()};
+  ids_.emplace(owned_[segment][offset], static_cast<InternId>(id));
+  // Publish the view before readers can see its id.
+  size_.store(id + 1, std::memory_order_release);
+  return static_cast<InternId>(id);
+}
+
+std::optional<InternId> StringInterner::find(std::string_view text) const {
+  std::shared_lock<std::shared_mutex> const lock{mutex_};
+  auto const it = ids_.find(text);
+  if (it == ids_.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+std::string_view StringInterner::view(InternId id) const {
+  if (id >= size_.load(std::memory_order_acquire)) {
+    throw std::out_of_range("Unknown interned string id " +
+                            std::to_string(id));
+  }
+  auto const [segment, offset] = locate(id, FIRST_SEGMENT_BITS);
+  return segments_[segment].load(std::memory_order_acquire)[offset];
+}
+
+CompactCot compact(CotType const& cot, StringInterner& interner) {
+  CompactCot result;
+  result.lat = cot.lat;
+  result.lon = cot.lon;
+  result.ce = cot.ce;
+  result.hae = cot.hae;
+  result.le = cot.le;
+  result.uid = interner.intern(cot.uid);
+  result.cot_type = interner.intern(cot.cot_type);
+  result.time = cot.time;
+  result.start = cot.start;
+  result.stale = cot.stale;
+  return result;
+}
+
+CotType expand(CompactCot const& cot, StringInterner const& interner) {
+  auto result = CotType(std::string(interner.view(cot.uid)));
+  result.lat = cot.lat;
+  result.lon = cot.lon;
+  result.ce = cot.ce;
+  result.hae = cot.hae;
+  result.le = cot.le;
+  result.cot_type = interner.view(cot.cot_type);
+  result.time = cot.time;
+  result.start = cot.start;
+  result.stale = cot.stale;
+  return result;
+}
+
+}  // namespace taktile
@@ -2,13 +2,59 @@
 // SPDX-License-Identifier: Apache-2.0
 #include "taktile/constants.hpp"
 
-#include <boost/asio.hpp>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <mutex>
 #include <string>
+#include <utility>
 
 namespace taktile {
 
-// NOLINTBEGIN[runtime/string]
-const std::string DEFAULT_HOST_ID = "taktile@" + boost::asio::ip::host_name();
-// NOLINTEND[runtime/string]
+namespace {
+
+/// @brief Every host id ever set; never shrinks, so references stay valid
+struct HostIds {
+  std::mutex mutex;
+  std::deque<std::string> ids;
+  std::atomic<std::string const*> current{nullptr};
+};
+
+HostIds& host_ids() {
+  static HostIds host_ids;
+  return host_ids;
+}
+
+std::string lookup_host_id() {
+  std::array<char, 256> name{};
+  if (::gethostname(name.data(), name.size() - 1) != 0 || name[0] == '\0') {
+    return "taktile@localhost";
+  }
+  return std::string("taktile@") + name.data();
+}
+
+}  // namespace
+
+std::string const& default_host_id() {
+  auto& state = host_ids();
+  if (auto const* id = state.current.load(std::memory_order_acquire)) {
+    return *id;
+  }
+  std::lock_guard const lock{state.mutex};
+  if (state.current.load(std::memory_order_relaxed) == nullptr) {
+    state.current.store(&state.ids.emplace_back(lookup_host_id()),
+                        std::memory_order_release);
+  }
+  return *state.current.load(std::memory_order_relaxed);
+}
+
+void set_default_host_id(std::string host_id) {
+  auto& state = host_ids();
+  std::lock_guard const lock{state.mutex};
+  state.current.store(&state.ids.emplace_back(std::move(host_id)),
+                      std::memory_order_release);
+}
 
 }  // namespace taktile
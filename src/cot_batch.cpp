@@ -0,0 +1,190 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include "taktile/cot_batch.hpp"
+
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define TAKTILE_X86 1
+#endif
+
+namespace taktile {
+
+namespace {
+
+/// @brief The numeric columns, as the validation kernels see them
+struct Columns {
+  double const* lat;
+  double const* lon;
+  double const* ce;
+  double const* hae;
+  double const* le;
+};
+
+/// @brief Mark invalid rows in [begin, size) one at a time
+void validate_scalar(Columns const& c, std::size_t begin, std::size_t size,
+                     uint64_t* mask) {
+  for (auto i = begin; i < size; ++i) {
+    // Same comparisons as CotType::validate_point: a NaN position is
+    // invalid, a NaN error estimate passes.
+    auto const invalid = !(c.lat[i] >= -LATITUDE_BOUND &&
+                           c.lat[i] <= LATITUDE_BOUND) ||
+                         !(c.lon[i] >= -LONGITUDE_BOUND &&
+                           c.lon[i] <= LONGITUDE_BOUND) ||
+                         c.ce[i] < 0 || c.hae[i] < 0 || c.le[i] < 0;
+    mask[i / 64] |= uint64_t{invalid} << (i % 64);
+  }
+}
+
+#ifdef TAKTILE_X86
+
+/// @brief Mark invalid rows two at a time; SSE2 is in every x86-64 CPU
+/// @return first row not checked
+std::size_t validate_sse2(Columns const& c, std::size_t size, uint64_t* mask) {
+  auto const lat_min = _mm_set1_pd(-LATITUDE_BOUND);
+  auto const lat_max = _mm_set1_pd(LATITUDE_BOUND);
+  auto const lon_min = _mm_set1_pd(-LONGITUDE_BOUND);
+  auto const lon_max = _mm_set1_pd(LONGITUDE_BOUND);
+  auto const zero = _mm_setzero_pd();
+  std::size_t i = 0;
+  for (; i + 2 <= size; i += 2) {
+    auto const lat = _mm_loadu_pd(c.lat + i);
+    auto const lon = _mm_loadu_pd(c.lon + i);
+    // Negated compares are true for a NaN position and ordered ones false
+    // for a NaN error estimate, as in the scalar kernel.
+    auto bad =
+        _mm_or_pd(_mm_cmpnge_pd(lat, lat_min), _mm_cmpnle_pd(lat, lat_max));
+    bad = _mm_or_pd(bad, _mm_cmpnge_pd(lon, lon_min));
+    bad = _mm_or_pd(bad, _mm_cmpnle_pd(lon, lon_max));
+    bad = _mm_or_pd(bad, _mm_cmplt_pd(_mm_loadu_pd(c.ce + i), zero));
+    bad = _mm_or_pd(bad, _mm_cmplt_pd(_mm_loadu_pd(c.hae + i), zero));
+    bad = _mm_or_pd(bad, _mm_cmplt_pd(_mm_loadu_pd(c.le + i), zero));
+    mask[i / 64] |= static_cast<uint64_t>(_mm_movemask_pd(bad)) << (i % 64);
+  }
+  return i;
+}
+
+/// @brief Mark invalid rows four at a time
+/// @return first row not checked
+__attribute__((target("avx2"))) std::size_t validate_avx2(Columns const& c,
+                                                          std::size_t size,
+                                                          uint64_t* mask) {
+  auto const lat_min = _mm256_set1_pd(-LATITUDE_BOUND);
+  auto const lat_max = _mm256_set1_pd(LATITUDE_BOUND);
+  auto const lon_min = _mm256_set1_pd(-LONGITUDE_BOUND);
+  auto const lon_max = _mm256_set1_pd(LONGITUDE_BOUND);
+  auto const zero = _mm256_setzero_pd();
+  std::size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    auto const lat = _mm256_loadu_pd(c.lat + i);
+    auto const lon = _mm256_loadu_pd(c.lon + i);
+    auto bad = _mm256_or_pd(_mm256_cmp_pd(lat, lat_min, _CMP_NGE_UQ),
+                            _mm256_cmp_pd(lat, lat_max, _CMP_NLE_UQ));
+    bad = _mm256_or_pd(bad, _mm256_cmp_pd(lon, lon_min, _CMP_NGE_UQ));
+    bad = _mm256_or_pd(bad, _mm256_cmp_pd(lon, lon_max, _CMP_NLE_UQ));
+    bad = _mm256_or_pd(
+        bad, _mm256_cmp_pd(_mm256_loadu_pd(c.ce + i), zero, _CMP_LT_OQ));
+    bad = _mm256_or_pd(
+        bad, _mm256_cmp_pd(_mm256_loadu_pd(c.hae + i), zero, _CMP_LT_OQ));
+    bad = _mm256_or_pd(
+        bad, _mm256_cmp_pd(_mm256_loadu_pd(c.le + i), zero, _CMP_LT_OQ));
+    // Four rows starting at a multiple of four never straddle a word.
+    mask[i / 64] |= static_cast<uint64_t>(_mm256_movemask_pd(bad))
+                    << (i % 64);
+  }
+  return i;
+}
+
+#endif  // TAKTILE_X86
+
+/// @brief Mark invalid rows with the widest kernel this CPU runs
+void validate_columns(Columns const& c, std::size_t size, uint64_t* mask) {
+  std::size_t checked = 0;
+#ifdef TAKTILE_X86
+  static bool const has_avx2 = __builtin_cpu_supports("avx2");
+  checked = has_avx2 ? validate_avx2(c, size, mask)
+                     : validate_sse2(c, size, mask);
+#endif
+  validate_scalar(c, checked, size, mask);
+}
+
+}  // namespace
+
+void CotBatch::push_back(CotType const& cot) {
+  lat_.push_back(cot.lat);
+  lon_.push_back(cot.lon);
+  ce_.push_back(cot.ce);
+  hae_.push_back(cot.hae);
+  le_.push_back(cot.le);
+  time_.push_back(cot.time);
+  start_.push_back(cot.start);
+  stale_.push_back(cot.stale);
+  uid_.push_back(cot.uid);
+  cot_type_.push_back(cot.cot_type);
+}
+
+void CotBatch::resize(std::size_t count) {
+  lat_.resize(count, 0.0);
+  lon_.resize(count, 0.0);
+  ce_.resize(count, DEFAULT_COT_VAL);
+  hae_.resize(count, DEFAULT_COT_VAL);
+  le_.resize(count, DEFAULT_COT_VAL);
+  time_.resize(count, 0);
+  start_.resize(count, 0);
+  stale_.resize(count, 0);
+  uid_.resize(count);
+  cot_type_.resize(count, DEFAULT_COT_TYPE);
+}
+
+void CotBatch::reserve(std::size_t count) {
+  lat_.reserve(count);
+  lon_.reserve(count);
+  ce_.reserve(count);
+  hae_.reserve(count);
+  le_.reserve(count);
+  time_.reserve(count);
+  start_.reserve(count);
+  stale_.reserve(count);
+  uid_.reserve(count);
+  cot_type_.reserve(count);
+}
+
+CotType CotBatch::row(std::size_t i) const {
+  auto cot = CotType(uid_.at(i));
+  cot.lat = lat_[i];
+  cot.lon = lon_[i];
+  cot.ce = ce_[i];
+  cot.hae = hae_[i];
+  cot.le = le_[i];
+  cot.time = time_[i];
+  cot.start = start_[i];
+  cot.stale = stale_[i];
+  cot.cot_type = cot_type_[i];
+  return cot;
+}
+
+std::vector<uint64_t> CotBatch::validate() const {
+  std::vector<uint64_t> mask((size() + 63) / 64, 0);
+  validate_columns({lat_.data(), lon_.data(), ce_.data(), hae_.data(),
+                    le_.data()},
+                   size(), mask.data());
+  for (std::size_t i = 0; i < size(); ++i) {
+    auto const invalid = uid_[i].empty() || cot_type_[i].empty();
+    mask[i / 64] |= uint64_t{invalid} << (i % 64);
+  }
+  return mask;
+}
+
+void CotBatch::restamp(int64_t now) {
+  for (std::size_t i = 0; i < size(); ++i) {
+    auto const time_to_stale = stale_[i] > start_[i]
+                                   ? stale_[i] - start_[i]
+                                   : int64_t{DEFAULT_COT_STALE} * 1000;
+    time_[i] = now;
+    start_[i] = now;
+    stale_[i] = now + time_to_stale;
+  }
+}
+
+}  // namespace taktile
@@ -0,0 +1,44 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include "taktile/cot_template.hpp"
+
+#include <cstring>
+
+namespace taktile {
+
+CotTemplate::CotTemplate(CotType const& cot, std::size_t max_blob_size)
+    : time_to_stale_{cot.stale - cot.start} {
+  CotType::validate(cot);
+  blob_.resize(max_blob_size);
+  blob_.resize(write_cot_xml(cot, blob_.data(), blob_.size(), layout_));
+  blob_.shrink_to_fit();
+}
+
+std::size_t CotTemplate::emit(int64_t now, std::byte* buffer,
+                              std::size_t capacity) const {
+  if (capacity < blob_.size()) {
+    throw_oversize(capacity);
+  }
+  std::memcpy(buffer, blob_.data(), blob_.size());
+  // time, start and the flow-tag share one formatted value.
+  XmlWriter{buffer + layout_.time, W3C_DATETIME_LENGTH}.datetime(now);
+  std::memcpy(buffer + layout_.start, buffer + layout_.time,
+              W3C_DATETIME_LENGTH);
+  std::memcpy(buffer + layout_.flow_time, buffer + layout_.time,
+              W3C_DATETIME_LENGTH);
+  XmlWriter{buffer + layout_.stale, W3C_DATETIME_LENGTH}.datetime(
+      now + time_to_stale_);
+  return blob_.size();
+}
+
+std::size_t CotTemplate::emit(int64_t now, double lat, double lon,
+                              std::byte* buffer, std::size_t capacity) const {
+  // ce, hae and le are fixed in the template and were checked on creation.
+  CotType::validate_point(lat, lon, 0.0, 0.0, 0.0);
+  auto const size = emit(now, buffer, capacity);
+  XmlWriter{buffer + layout_.lat, FIXED_LAT_WIDTH}.fixed(lat, FIXED_LAT_WIDTH);
+  XmlWriter{buffer + layout_.lon, FIXED_LON_WIDTH}.fixed(lon, FIXED_LON_WIDTH);
+  return size;
+}
+
+}  // namespace taktile
@@ -0,0 +1,119 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include "taktile/cot_view.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace taktile {
+
+namespace {
+
+/// @brief Split off the first level of a CoT type
+/// @return the level; type is left holding the levels after it
+std::string_view next_level(std::string_view& type) {
+  auto const dash = type.find('-');
+  auto const level = type.substr(0, dash);
+  type = dash == std::string_view::npos ? std::string_view{}
+                                        : type.substr(dash + 1);
+  return level;
+}
+
+/// @brief Decode a raw attribute value only if it holds an entity or
+///        whitespace that decoding normalizes, as intern_xml does
+std::string_view unescaped(std::string_view value, std::string& scratch) {
+  if (value.find_first_of("&\t\n\r") == std::string_view::npos) {
+    return value;
+  }
+  unescape_xml(value, scratch);
+  return scratch;
+}
+
+}  // namespace
+
+CotFilter::CotFilter() : nodes_(1) {}
+
+void CotFilter::allow_type(std::string_view pattern) {
+  if (pattern.empty()) {
+    throw std::invalid_argument("Type pattern must not be empty.");
+  }
+  // A trailing "-*" is the same as matching everything below.
+  if (pattern.size() > 2 && pattern.substr(pattern.size() - 2) == "-*") {
+    pattern.remove_suffix(2);
+  }
+  any_type_ = false;
+  std::size_t node = 0;
+  while (!pattern.empty()) {
+    auto const level = next_level(pattern);
+    std::optional<std::size_t> child;
+    if (level == "*") {
+      child = nodes_[node].any;
+    } else {
+      for (auto const& [name, index] : nodes_[node].children) {
+        if (name == level) {
+          child = index;
+          break;
+        }
+      }
+    }
+    if (!child) {
+      child = nodes_.size();
+      if (level == "*") {
+        nodes_[node].any = child;
+      } else {
+        nodes_[node].children.emplace_back(std::string(level), *child);
+      }
+      nodes_.emplace_back();
+    }
+    node = *child;
+  }
+  nodes_[node].accept = true;
+}
+
+void CotFilter::follow_uid(std::string_view uid) {
+  if (uids_.count(uid) == 0) {
+    uids_.insert(owned_.emplace_back(uid));
+  }
+}
+
+bool CotFilter::matches(CotView const& view) const {
+  // Most events carry no entities, so decoding rarely touches these.
+  thread_local std::string type_scratch;
+  thread_local std::string uid_scratch;
+  try {
+    return matches(unescaped(view.cot_type(), type_scratch),
+                   unescaped(view.uid(), uid_scratch));
+  } catch (std::invalid_argument const&) {
+    return false;
+  }
+}
+
+bool CotFilter::matches(std::string_view cot_type,
+                        std::string_view uid) const {
+  if (!uids_.empty() && uids_.count(uid) == 0) {
+    return false;
+  }
+  return any_type_ || type_matches(0, cot_type);
+}
+
+bool CotFilter::type_matches(std::size_t node,
+                             std::string_view cot_type) const {
+  // Recursion is bounded by the depth of the trie, not by the input.
+  auto const& current = nodes_[node];
+  if (current.accept) {
+    return true;
+  }
+  if (cot_type.empty()) {
+    return false;
+  }
+  auto const level = next_level(cot_type);
+  for (auto const& [name, child] : current.children) {
+    if (name == level && type_matches(child, cot_type)) {
+      return true;
+    }
+  }
+  return current.any && type_matches(*current.any, cot_type);
+}
+
+}  // namespace taktile
@@ -0,0 +1,234 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include "taktile/datetime.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace taktile {
+
+namespace {
+
+constexpr int64_t MS_PER_SECOND{1000};
+constexpr int64_t SECONDS_PER_MINUTE{60};
+constexpr int64_t SECONDS_PER_HOUR{3600};
+constexpr int64_t SECONDS_PER_DAY{86400};
+// "YYYY-MM-DDTHH:MM:SS." is shared by every millisecond within a second.
+constexpr std::size_t PREFIX_LENGTH{20};
+
+constexpr int64_t floor_div(int64_t a, int64_t b) {
+  return a / b - static_cast<int64_t>((a % b != 0) && ((a < 0) != (b < 0)));
+}
+
+/// @brief Days since 1970-01-01 of a proleptic Gregorian date
+/// @details H. Hinnant's days_from_civil,
+///          https://howardhinnant.github.io/date_algorithms.html
+constexpr int64_t days_from_civil(int64_t year, int64_t month, int64_t day) {
+  year -= static_cast<int64_t>(month <= 2);
+  auto const era = floor_div(year, 400);
+  auto const yoe = year - era * 400;
+  auto const mp = month > 2 ? month - 3 : month + 9;
+  auto const doy = (153 * mp + 2) / 5 + day - 1;
+  auto const doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + doe - 719468;
+}
+
+struct CivilDate {
+  int64_t year;
+  int64_t month;
+  int64_t day;
+};
+
+/// @brief Inverse of days_from_civil
+constexpr CivilDate civil_from_days(int64_t days) {
+  days += 719468;
+  auto const era = floor_div(days, 146097);
+  auto const doe = days - era * 146097;
+  auto const yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  auto const doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  auto const mp = (5 * doy + 2) / 153;
+  auto const day = doy - (153 * mp + 2) / 5 + 1;
+  auto const month = mp < 10 ? mp + 3 : mp - 9;
+  return {yoe + era * 400 + static_cast<int64_t>(month <= 2), month, day};
+}
+
+static_assert(days_from_civil(1970, 1, 1) == 0);
+static_assert(civil_from_days(days_from_civil(2000, 2, 29)).day == 29);
+
+constexpr bool is_leap_year(int64_t year) {
+  return year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+}
+
+constexpr int64_t days_in_month(int64_t year, int64_t month) {
+  constexpr std::array<int64_t, 12> DAYS{31, 28, 31, 30, 31, 30,
+                                         31, 31, 30, 31, 30, 31};
+  return month == 2 && is_leap_year(year) ? 29 : DAYS.at(month - 1);
+}
+
+void write_digits(char* out, int64_t value, std::size_t width) {
+  for (auto i = width; i > 0; --i) {
+    out[i - 1] = static_cast<char>('0' + value % 10);
+    value /= 10;
+  }
+}
+
+/// @brief Formatted "YYYY-MM-DDTHH:MM:SS." prefixes of recent seconds
+/// @details time/start and stale are usually different seconds, so a few
+///          entries are kept and replaced round-robin.
+class PrefixCache {
+ public:
+  char const* prefix(int64_t epoch_seconds) {
+    for (std::size_t i = 0; i < SIZE; ++i) {
+      if (seconds_.at(i) == epoch_seconds) {
+        return prefixes_.at(i).data();
+      }
+    }
+    auto const slot = next_;
+    next_ = (next_ + 1) % SIZE;
+    seconds_.at(slot) = epoch_seconds;
+
+    auto* const out = prefixes_.at(slot).data();
+    auto const days = floor_div(epoch_seconds, SECONDS_PER_DAY);
+    auto const seconds_of_day = epoch_seconds - days * SECONDS_PER_DAY;
+    auto const date = civil_from_days(days);
+    write_digits(out, date.year, 4);
+    out[4] = '-';
+    write_digits(out + 5, date.month, 2);
+    out[7] = '-';
+    write_digits(out + 8, date.day, 2);
+    out[10] = 'T';
+    write_digits(out + 11, seconds_of_day / SECONDS_PER_HOUR, 2);
+    out[13] = ':';
+    write_digits(out + 14,
+                 (seconds_of_day % SECONDS_PER_HOUR) / SECONDS_PER_MINUTE, 2);
+    out[16] = ':';
+    write_digits(out + 17, seconds_of_day % SECONDS_PER_MINUTE, 2);
+    out[19] = '.';
+    return out;
+  }
+
+ private:
+  static constexpr std::size_t SIZE{4};
+
+  std::array<int64_t, SIZE> seconds_{
+      std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::min(),
+      std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::min()};
+  std::array<std::array<char, PREFIX_LENGTH>, SIZE> prefixes_{};
+  std::size_t next_{0};
+};
+
+[[noreturn]] void invalid_datetime(std::string_view text) {
+  throw std::invalid_argument("Invalid W3C XML datetime: " +
+                              std::string(text));
+}
+
+int64_t read_digits(std::string_view text, std::size_t pos,
+                    std::size_t count) {
+  if (pos + count > text.size()) {
+    invalid_datetime(text);
+  }
+  int64_t value{0};
+  for (auto i = pos; i < pos + count; ++i) {
+    if (text[i] < '0' || text[i] > '9') {
+      invalid_datetime(text);
+    }
+    value = value * 10 + (text[i] - '0');
+  }
+  return value;
+}
+
+void expect(std::string_view text, std::size_t pos, char c) {
+  if (pos >= text.size() || text[pos] != c) {
+    invalid_datetime(text);
+  }
+}
+
+}  // namespace
+
+int64_t now_ms() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+void format_w3c_datetime(int64_t epoch_ms, char* out) noexcept {
+  thread_local PrefixCache cache;
+  auto const epoch_seconds = floor_div(epoch_ms, MS_PER_SECOND);
+  std::memcpy(out, cache.prefix(epoch_seconds), PREFIX_LENGTH);
+  write_digits(out + PREFIX_LENGTH, epoch_ms - epoch_seconds * MS_PER_SECOND,
+               3);
+  out[W3C_DATETIME_LENGTH - 1] = 'Z';
+}
+
+std::string format_w3c_datetime(int64_t epoch_ms) {
+  std::string out(W3C_DATETIME_LENGTH, '\0');
+  format_w3c_datetime(epoch_ms, out.data());
+  return out;
+}
+
+int64_t parse_w3c_datetime(std::string_view text) {
+  auto const year = read_digits(text, 0, 4);
+  expect(text, 4, '-');
+  auto const month = read_digits(text, 5, 2);
+  expect(text, 7, '-');
+  auto const day = read_digits(text, 8, 2);
+  expect(text, 10, 'T');
+  auto const hour = read_digits(text, 11, 2);
+  expect(text, 13, ':');
+  auto const minute = read_digits(text, 14, 2);
+  expect(text, 16, ':');
+  auto const second = read_digits(text, 17, 2);
+  if (month < 1 || month > 12 || day < 1 ||
+      day > days_in_month(year, month) || hour > 23 || minute > 59 ||
+      second > 60) {
+    invalid_datetime(text);
+  }
+
+  std::size_t pos{19};
+  int64_t millis{0};
+  if (pos < text.size() && text[pos] == '.') {
+    auto const begin = ++pos;
+    while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') {
+      if (pos - begin < 3) {
+        millis = millis * 10 + (text[pos] - '0');
+      }
+      ++pos;
+    }
+    if (pos == begin) {
+      invalid_datetime(text);
+    }
+    for (auto digits = pos - begin; digits < 3; ++digits) {
+      millis *= 10;
+    }
+  }
+
+  int64_t offset{0};
+  if (pos < text.size() && text[pos] == 'Z') {
+    ++pos;
+  } else if (pos < text.size() && (text[pos] == '+' || text[pos] == '-')) {
+    auto const sign = text[pos] == '-' ? -1 : 1;
+    auto const offset_hours = read_digits(text, pos + 1, 2);
+    expect(text, pos + 3, ':');
+    auto const offset_minutes = read_digits(text, pos + 4, 2);
+    offset = sign * (offset_hours * SECONDS_PER_HOUR +
+                     offset_minutes * SECONDS_PER_MINUTE);
+    pos += 6;
+  }
+  if (pos != text.size()) {
+    invalid_datetime(text);
+  }
+
+  auto const seconds = days_from_civil(year, month, day) * SECONDS_PER_DAY +
+                       hour * SECONDS_PER_HOUR + minute * SECONDS_PER_MINUTE +
+                       second - offset;
+  return seconds * MS_PER_SECOND + millis;
+}
+
+}  // namespace taktile
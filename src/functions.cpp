@@ -8,40 +8,103 @@
 #include <Poco/DOM/Element.h>
 #include <Poco/URI.h>
 #include <Poco/XML/XMLWriter.h>
-#include <fmt/chrono.h>
-#include <fmt/core.h>
 
 #include <algorithm>
-#include <boost/log/attributes/clock.hpp>
-#include <boost/log/core.hpp>
-#include <boost/log/sources/severity_logger.hpp>
-#include <boost/log/trivial.hpp>
-#include <boost/log/utility/setup/console.hpp>
-#include <chrono>
-#include <iostream>
+#include <array>
+#include <cstdint>
+#include <cstring>
 #include <memory>
 #include <optional>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
+#include "taktile/datetime.hpp"
+#include "taktile/logging.hpp"
+#include "taktile/metrics.hpp"
+#include "taktile/xml_parser.hpp"
+#include "taktile/xml_writer.hpp"
+
 namespace siomsg = simpleio::messages;
 
 namespace taktile {
 
+namespace {
+
+/// @brief Count a validation failure, then throw
+[[noreturn]] void throw_invalid(char const* what) {
+  static auto& failures =
+      metrics().counter("taktile_validation_failures_total",
+                        "CoT messages that failed validation");
+  failures.add();
+  throw std::invalid_argument(what);
+}
+
+uint16_t default_port(Scheme scheme) {
+  return scheme == Scheme::UDP_BROADCAST || scheme == Scheme::UDP_WRITE_ONLY
+             ? DEFAULT_BROADCAST_PORT
+             : DEFAULT_COT_PORT;
+}
+
+constexpr bool is_host_char(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '.' ||
+         c == '-';
+}
+
+/// @brief Parse "scheme://host[:port]" without Poco, for the plain form
+///        to_string writes and configurations use
+/// @return std::nullopt for anything else (user info, paths, IPv6, upper
+///         case, unknown schemes, port 0), which Poco::URI then parses
+std::optional<URL> parse_plain_url(std::string_view inp) {
+  auto const separator = inp.find("://");
+  if (separator == std::string_view::npos) {
+    return std::nullopt;
+  }
+  auto const scheme = parse_scheme(inp.substr(0, separator));
+  if (!scheme) {
+    return std::nullopt;
+  }
+  auto const authority = inp.substr(separator + 3);
+  auto const colon = authority.find(':');
+  auto const host = authority.substr(0, colon);
+  if (host.empty() || !std::all_of(host.begin(), host.end(), is_host_char)) {
+    return std::nullopt;
+  }
+  if (colon == std::string_view::npos) {
+    return URL{*scheme, std::string(host), default_port(*scheme)};
+  }
+  auto const digits = authority.substr(colon + 1);
+  if (digits.empty() || digits.size() > 5) {
+    return std::nullopt;
+  }
+  uint32_t port{0};
+  for (auto const c : digits) {
+    if (c < '0' || c > '9') {
+      return std::nullopt;
+    }
+    port = port * 10 + static_cast<uint32_t>(c - '0');
+  }
+  if (port == 0 || port > UINT16_MAX) {
+    return std::nullopt;
+  }
+  return URL{*scheme, std::string(host), static_cast<uint16_t>(port)};
+}
+
+}  // namespace
+
+void throw_oversize(std::size_t capacity) {
+  static auto& oversize = metrics().counter(
+      "taktile_oversize_total", "CoT messages too large for their buffer");
+  oversize.add();
+  throw std::length_error("Serialized CoT message exceeds " +
+                          std::to_string(capacity) + " bytes.");
+}
+
 void init_logger() {
-  boost::log::core::get()->add_global_attribute(
-      "TimeStamp", boost::log::attributes::local_clock());
-  // Set up the logger
-  boost::log::add_console_log(
-      std::clog,
-      boost::log::keywords::format = "[%TimeStamp%] [%Severity%] %Message%");
-  // boost::log::add_file_log("taktile.log", boost::log::keywords::format =
-  // "[%TimeStamp%] [%Severity%] %Message%");
-  boost::log::core::get()->set_filter(boost::log::trivial::severity >=
-                                      boost::log::trivial::debug);
+  init_logger(LoggerOptions{});
 }
 
 URL::URL(std::string const& url) {
@@ -58,69 +121,80 @@ URL::URL(Scheme const& _scheme, std::string const& _net_loc, uint16_t _port) {
 }
 
 URL URL::parse_url(std::string const& inp) {
+  if (auto url = parse_plain_url(inp)) {
+    return std::move(*url);
+  }
+
   // Parse the URL
   Poco::URI uri{inp};
 
-  if (SCHEME_INV_MAP.find(uri.getScheme()) == SCHEME_INV_MAP.end()) {
+  auto const scheme = parse_scheme(uri.getScheme());
+  if (!scheme) {
     throw std::invalid_argument("Invalid scheme: " + uri.getScheme());
   }
 
-  auto scheme = SCHEME_INV_MAP.at(uri.getScheme());
-
   if (uri.getSpecifiedPort() == 0) {
-    auto is_broadcast =
-        (uri.getScheme().find("broadcast") != std::string::npos);
-    auto is_write_only = (uri.getScheme().find("wo") != std::string::npos);
-    return URL{scheme, uri.getHost(),
-               is_broadcast || is_write_only ? DEFAULT_BROADCAST_PORT
-                                             : DEFAULT_COT_PORT};
+    return URL{*scheme, uri.getHost(), default_port(*scheme)};
   }
 
-  return URL{scheme, uri.getHost(), uri.getSpecifiedPort()};
+  return URL{*scheme, uri.getHost(), uri.getSpecifiedPort()};
 }
 
-void CotType::validate(CotType const& cot) {
-  if (cot.lat < -LATITUDE_BOUND || cot.lat > LATITUDE_BOUND) {
-    throw std::invalid_argument("Latitude must be between -90 and 90 degrees");
+std::string to_string(URL const& url) {
+  return std::string(scheme_name(url.scheme)) + "://" + url.net_loc + ":" +
+         std::to_string(url.port);
+}
+
+void CotType::validate_point(double lat, double lon, double ce, double hae,
+                             double le) {
+  // Written so that NaN, which fails every comparison, is out of range.
+  if (!(lat >= -LATITUDE_BOUND && lat <= LATITUDE_BOUND)) {
+    throw_invalid("Latitude must be between -90 and 90 degrees");
   }
-  if (cot.lon < -LONGITUDE_BOUND || cot.lon > LONGITUDE_BOUND) {
-    throw std::invalid_argument(
-        "Longitude must be between -180 and 180 degrees");
+  if (!(lon >= -LONGITUDE_BOUND && lon <= LONGITUDE_BOUND)) {
+    throw_invalid("Longitude must be between -180 and 180 degrees");
   }
-  if (cot.ce < 0) {
-    throw std::invalid_argument(
-        "Circular Error must be greater than or equal to 0");
+  if (ce < 0) {
+    throw_invalid("Circular Error must be greater than or equal to 0");
   }
-  if (cot.hae < 0) {
-    throw std::invalid_argument(
-        "Height Above Ellipsoid must be greater than or equal to 0");
+  if (hae < 0) {
+    throw_invalid("Height Above Ellipsoid must be greater than or equal to 0");
   }
-  if (cot.le < 0) {
-    throw std::invalid_argument(
-        "Linear Error must be greater than or equal to 0");
+  if (le < 0) {
+    throw_invalid("Linear Error must be greater than or equal to 0");
   }
+}
+
+void CotType::validate(CotType const& cot) {
+  validate_point(cot.lat, cot.lon, cot.ce, cot.hae, cot.le);
   if (cot.uid.empty()) {
-    throw std::invalid_argument("UID must not be empty");
+    throw_invalid("UID must not be empty");
   }
   if (cot.cot_type.empty()) {
-    throw std::invalid_argument("CoT type must not be empty");
+    throw_invalid("CoT type must not be empty");
   }
 }
 
+CotType::CotType() {
+  restamp(now_ms());
+}
+
 CotType::CotType(std::string _uid)
-    : uid{std::move(_uid)},
-      stale{DEFAULT_COT_STALE},
-      cot_type{DEFAULT_COT_TYPE} {}
+    : uid{std::move(_uid)}, cot_type{DEFAULT_COT_TYPE} {
+  restamp(now_ms());
+}
+
+void CotType::restamp(int64_t now) {
+  auto const time_to_stale =
+      stale > start ? stale - start : int64_t{DEFAULT_COT_STALE} * 1000;
+  time = now;
+  start = now;
+  stale = now + time_to_stale;
+}
 
 std::string CotType::get_time(std::optional<int32_t> cot_stale) {
-  auto time = std::chrono::system_clock::now();
-  if (cot_stale.has_value()) {
-    time += std::chrono::seconds(cot_stale.value());
-  }
-  auto const seconds = std::chrono::time_point_cast<std::chrono::seconds>(time);
-  auto const milliseconds =
-      std::chrono::duration_cast<std::chrono::milliseconds>((time - seconds));
-  return fmt::format(W3C_XML_DATETIME, seconds, milliseconds.count());
+  return format_w3c_datetime(now_ms() +
+                             int64_t{cot_stale.value_or(0)} * 1000);
 }
 
 siomsg::XmlMessageType Cot2Xml::convert(CotType const& cot) {
@@ -133,9 +207,9 @@ siomsg::XmlMessageType Cot2Xml::convert(CotType const& cot) {
   event->setAttribute("type", cot.cot_type);
   event->setAttribute("uid", cot.uid);
   event->setAttribute("how", "m-g");
-  event->setAttribute("time", CotType::get_time());
-  event->setAttribute("start", CotType::get_time());
-  event->setAttribute("stale", CotType::get_time(cot.stale));
+  event->setAttribute("time", format_w3c_datetime(cot.time));
+  event->setAttribute("start", format_w3c_datetime(cot.start));
+  event->setAttribute("stale", format_w3c_datetime(cot.stale));
 
   // Create <point> element
   auto* point = doc->createElement("point");
@@ -147,9 +221,9 @@ siomsg::XmlMessageType Cot2Xml::convert(CotType const& cot) {
 
   // Create <_flow-tags_> element
   auto* flow_tags = doc->createElement("_flow-tags_");
-  std::string _ft_tag = DEFAULT_HOST_ID + "-v" + std::string(VERSION);
+  std::string _ft_tag = default_host_id() + "-v" + std::string(VERSION);
   std::replace(_ft_tag.begin(), _ft_tag.end(), '@', '-');
-  flow_tags->setAttribute(_ft_tag, CotType::get_time());
+  flow_tags->setAttribute(_ft_tag, format_w3c_datetime(now_ms()));
 
   // Create <detail> element
   auto* detail = doc->createElement("detail");
@@ -200,7 +274,9 @@ CotType Cot2Xml::convert(siomsg::XmlMessageType const& xml) {
     cot.hae = std::stod(point->getAttribute("hae"));
     cot.ce = std::stod(point->getAttribute("ce"));
     cot.cot_type = event->getAttribute("type");
-    cot.stale = std::stoul(event->getAttribute("stale"));
+    cot.time = parse_w3c_datetime(event->getAttribute("time"));
+    cot.start = parse_w3c_datetime(event->getAttribute("start"));
+    cot.stale = parse_w3c_datetime(event->getAttribute("stale"));
     CotType::validate(cot);
     return cot;
   } catch (std::invalid_argument const& e) {
@@ -211,6 +287,21 @@ CotType Cot2Xml::convert(siomsg::XmlMessageType const& xml) {
   }
 }
 
+std::size_t CotSerializer::serialize_into(CotType const& cot, std::byte* buffer,
+                                          std::size_t capacity) {
+  auto const blob = serialize(cot);
+  if (blob.size() > capacity) {
+    throw_oversize(capacity);
+  }
+  std::memcpy(buffer, blob.data(), blob.size());
+  return blob.size();
+}
+
+CotType CotSerializer::deserialize_from(std::byte const* data,
+                                        std::size_t size) {
+  return deserialize(std::vector<std::byte>(data, data + size));
+}
+
 CotXmlSerializer::CotXmlSerializer(
     std::shared_ptr<siomsg::XmlSerializer> strategy)
     : xml_serializer_{std::move(strategy)} {}
@@ -225,6 +316,34 @@ CotType CotXmlSerializer::deserialize(std::vector<std::byte> const& _blog) {
   return Cot2Xml::convert(xml);
 }
 
+CotDirectXmlSerializer::CotDirectXmlSerializer(std::size_t max_blob_size)
+    : max_blob_size_{std::min(max_blob_size, MAX_TCP_BLOB_SIZE)} {}
+
+std::vector<std::byte> CotDirectXmlSerializer::serialize(
+    CotType const& entity) {
+  // Encode into per-thread scratch space so the only allocation is the
+  // returned vector itself.
+  thread_local std::array<std::byte, MAX_TCP_BLOB_SIZE> scratch;
+  auto const size = write_cot_xml(entity, scratch.data(), max_blob_size_);
+  return {scratch.begin(), scratch.begin() + static_cast<std::ptrdiff_t>(size)};
+}
+
+CotType CotDirectXmlSerializer::deserialize(
+    std::vector<std::byte> const& _blob) {
+  return deserialize_from(_blob.data(), _blob.size());
+}
+
+std::size_t CotDirectXmlSerializer::serialize_into(CotType const& entity,
+                                                   std::byte* buffer,
+                                                   std::size_t capacity) {
+  return write_cot_xml(entity, buffer, std::min(capacity, max_blob_size_));
+}
+
+CotType CotDirectXmlSerializer::deserialize_from(std::byte const* data,
+                                                 std::size_t size) {
+  return read_cot_xml({reinterpret_cast<char const*>(data), size});
+}
+
 CotType hello_event(std::optional<std::string> const& uid) {
   auto cot = CotType(uid.value_or("takPing"));
   cot.cot_type = "t-x-d-d";
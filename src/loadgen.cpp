@@ -0,0 +1,200 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include "taktile/loadgen.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "taktile/datetime.hpp"
+#include "taktile/udp.hpp"
+
+namespace taktile {
+
+namespace {
+
+// Mean Earth radius in meters, per degree of arc.
+constexpr double METERS_PER_DEGREE{6371008.8 * M_PI / 180.0};
+// Start points are spread over about 10 km around the center.
+constexpr double SPREAD_DEGREES{0.1};
+constexpr double MAX_ALTITUDE_M{500.0};
+
+/// @brief SplitMix64, so paths are the same on every platform and standard
+///        library
+uint64_t next_random(uint64_t& state) {
+  state += 0x9e3779b97f4a7c15ULL;
+  auto z = state;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+/// @brief Uniform in [-1, 1)
+double next_signed(uint64_t& state) {
+  return static_cast<double>(next_random(state) >> 11) * 0x1.0p-52 - 1.0;
+}
+
+double to_ms(std::chrono::steady_clock::duration elapsed) {
+  return std::chrono::duration<double, std::milli>(elapsed).count();
+}
+
+}  // namespace
+
+SyntheticTracks::SyntheticTracks(std::size_t tracks, uint64_t seed,
+                                 double step_m, double lat, double lon)
+    : step_m_{step_m}, tracks_(tracks) {
+  for (std::size_t i = 0; i < tracks; ++i) {
+    auto& track = tracks_[i];
+    track.state = seed ^ (0xd1b54a32d192ed03ULL * (i + 1));
+    auto& cot = track.cot;
+    cot.uid = std::string(LOAD_UID_PREFIX) + std::to_string(i);
+    cot.cot_type = "a-f-G-U-C";
+    cot.lat = lat + next_signed(track.state) * SPREAD_DEGREES / 2;
+    cot.lon = lon + next_signed(track.state) * SPREAD_DEGREES / 2;
+    cot.hae = (next_signed(track.state) + 1.0) * MAX_ALTITUDE_M / 2;
+  }
+}
+
+CotType const& SyntheticTracks::next(std::size_t track, double sent_ms) {
+  auto& [cot, state, sequence] = tracks_.at(track);
+  cot.lat = std::clamp(
+      cot.lat + next_signed(state) * step_m_ / METERS_PER_DEGREE, -89.0, 89.0);
+  cot.lon += next_signed(state) * step_m_ /
+             (METERS_PER_DEGREE * std::cos(cot.lat * M_PI / 180.0));
+  if (cot.lon > LONGITUDE_BOUND) {
+    cot.lon -= 360.0;
+  } else if (cot.lon < -LONGITUDE_BOUND) {
+    cot.lon += 360.0;
+  }
+  cot.hae = std::clamp(cot.hae + next_signed(state) * step_m_ / 10, 0.0,
+                       MAX_ALTITUDE_M);
+  cot.restamp(now_ms());
+  cot.ce = static_cast<double>(sequence++);
+  cot.le = sent_ms;
+  return cot;
+}
+
+LoadMonitor::LoadMonitor(std::size_t tracks,
+                         std::chrono::steady_clock::time_point epoch)
+    : epoch_{epoch},
+      next_{std::make_unique<std::atomic<uint64_t>[]>(tracks)},
+      tracks_{tracks} {}
+
+void LoadMonitor::record(CotType const& cot) {
+  record(cot, elapsed_ms());
+}
+
+void LoadMonitor::record(CotType const& cot, double received_ms) {
+  std::string_view const uid{cot.uid};
+  std::size_t track{0};
+  auto const digits = uid.substr(std::min(LOAD_UID_PREFIX.size(), uid.size()));
+  auto const [end, error] =
+      std::from_chars(digits.data(), digits.data() + digits.size(), track);
+  if (uid.substr(0, LOAD_UID_PREFIX.size()) != LOAD_UID_PREFIX ||
+      error != std::errc{} || end != digits.data() + digits.size() ||
+      track >= tracks_ || !(cot.ce >= 0.0)) {
+    foreign_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  received_.fetch_add(1, std::memory_order_relaxed);
+  latency_.record(static_cast<uint64_t>(
+      std::max((received_ms - cot.le) * 1.0e6, 0.0)));
+
+  auto const sequence = static_cast<uint64_t>(cot.ce);
+  auto& next = next_[track];
+  auto seen = next.load(std::memory_order_relaxed);
+  while (sequence >= seen) {
+    if (next.compare_exchange_weak(seen, sequence + 1,
+                                   std::memory_order_relaxed)) {
+      return;
+    }
+  }
+  reordered_.fetch_add(1, std::memory_order_relaxed);
+}
+
+double LoadMonitor::elapsed_ms() const {
+  return to_ms(std::chrono::steady_clock::now() - epoch_);
+}
+
+LoadReport LoadMonitor::report(uint64_t sent) const {
+  LoadReport report;
+  report.sent = sent;
+  report.received = received();
+  report.lost = sent > report.received ? sent - report.received : 0;
+  report.reordered = reordered_.load(std::memory_order_relaxed);
+  report.foreign = foreign_.load(std::memory_order_relaxed);
+  auto const latency = latency_.snapshot();
+  report.p50_ns = latency.percentile(0.5);
+  report.p99_ns = latency.percentile(0.99);
+  report.p999_ns = latency.percentile(0.999);
+  return report;
+}
+
+LoadReport run_load(LoadOptions const& options) {
+  if (!(options.rate_hz > 0.0) || options.tracks == 0) {
+    throw std::invalid_argument("Load rate and track count must be positive.");
+  }
+  auto const serializer =
+      options.serializer ? options.serializer
+                         : std::make_shared<CotDirectXmlSerializer>();
+  auto const epoch = std::chrono::steady_clock::now();
+  LoadMonitor monitor{options.tracks, epoch};
+
+  UdpReceiverOptions receiver_options;
+  receiver_options.workers = std::max<std::size_t>(options.workers, 1);
+  // Room for bursts, so drops measure the path rather than the default
+  // buffer size.
+  receiver_options.receive_buffer = 8 << 20;
+  CotUdpReceiver receiver{
+      options.url, serializer,
+      [&monitor](CotType&& cot) { monitor.record(cot); }, receiver_options};
+  receiver.start();
+
+  UdpSenderOptions sender_options;
+  CotUdpSender sender{
+      URL{options.url.scheme, options.url.net_loc, receiver.port()},
+      sender_options};
+  SyntheticTracks tracks{options.tracks, options.seed, options.step_m};
+
+  auto const rate = static_cast<double>(options.tracks) * options.rate_hz;
+  auto const seconds_to_send = std::max(options.seconds, 0.0);
+  auto const total =
+      static_cast<uint64_t>(std::llround(seconds_to_send * rate));
+  auto const interval_ns = 1.0e9 / rate;
+  auto const start = std::chrono::steady_clock::now();
+  for (uint64_t i = 0; i < total; ++i) {
+    auto const due =
+        start + std::chrono::nanoseconds(
+                    static_cast<int64_t>(static_cast<double>(i) * interval_ns));
+    if (std::chrono::steady_clock::now() < due) {
+      sender.flush();
+      std::this_thread::sleep_until(due);
+    }
+    sender.enqueue(tracks.next(i % options.tracks, monitor.elapsed_ms()),
+                   *serializer);
+    if (sender.queued() >= sender_options.batch_size) {
+      sender.flush();
+    }
+  }
+  sender.flush();
+  auto const seconds = to_ms(std::chrono::steady_clock::now() - start) / 1e3;
+
+  auto const expected = total - std::min(total, sender.stats().dropped);
+  auto const deadline = std::chrono::steady_clock::now() + options.drain;
+  while (monitor.received() < expected &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  receiver.stop();
+
+  auto report = monitor.report(total);
+  report.seconds = seconds;
+  report.send_drops = sender.stats().dropped;
+  report.kernel_drops = receiver.stats().kernel_drops;
+  return report;
+}
+
+}  // namespace taktile
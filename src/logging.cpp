@@ -0,0 +1,247 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include "taktile/logging.hpp"
+
+#include <atomic>
+#include <boost/core/null_deleter.hpp>
+#include <boost/log/attributes/clock.hpp>
+#include <boost/log/core.hpp>
+#include <boost/log/expressions.hpp>
+#include <boost/log/keywords/file_name.hpp>
+#include <boost/log/keywords/max_files.hpp>
+#include <boost/log/keywords/open_mode.hpp>
+#include <boost/log/keywords/rotation_size.hpp>
+#include <boost/log/keywords/target.hpp>
+#include <boost/log/sinks/basic_sink_backend.hpp>
+#include <boost/log/sinks/sync_frontend.hpp>
+#include <boost/log/sinks/text_file_backend.hpp>
+#include <boost/log/sinks/text_ostream_backend.hpp>
+#include <boost/log/sinks/unlocked_frontend.hpp>
+#include <boost/log/utility/setup/formatter_parser.hpp>
+#include <boost/make_shared.hpp>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "taktile/metrics.hpp"
+#include "taktile/pipeline.hpp"
+
+namespace taktile {
+
+namespace {
+
+namespace logging = boost::log;
+namespace sinks = boost::log::sinks;
+namespace keywords = boost::log::keywords;
+
+constexpr char const* FORMAT{"[%TimeStamp%] [%Severity%] %Message%"};
+
+// Records written per pass of the background thread.
+constexpr std::size_t WRITE_BATCH{256};
+
+using RecordQueue = MpmcRing<logging::record_view>;
+
+/// @brief Backend that hands records to the background thread
+/// @details Fed concurrently and without a lock by the unlocked frontend.
+class QueueBackend
+    : public sinks::basic_sink_backend<sinks::concurrent_feeding> {
+ public:
+  QueueBackend(std::shared_ptr<RecordQueue> queue, Counter& dropped)
+      : queue_{std::move(queue)}, dropped_{dropped} {}
+
+  void consume(logging::record_view const& record) {
+    // Values such as the severity live in the logging thread until detached.
+    // The unlocked frontend does not ask the core to do it, so do it here.
+    for (auto const& entry : record.attribute_values()) {
+      const_cast<logging::attribute_value&>(entry.second).detach_from_thread();
+    }
+    auto copy = record;
+    if (!queue_->push(std::move(copy))) {
+      dropped_.add();
+    }
+  }
+
+ private:
+  std::shared_ptr<RecordQueue> queue_;
+  Counter& dropped_;
+};
+
+using QueueSink = sinks::unlocked_sink<QueueBackend>;
+
+/// @brief A text backend the background thread writes formatted records to
+struct Output {
+  std::function<void(logging::record_view const&, std::string const&)>
+      consume;
+  std::function<void()> flush;
+};
+
+/// @brief The asynchronous logger's queue, sink and background thread
+class AsyncLogger {
+ public:
+  AsyncLogger(LoggerOptions const& options, std::vector<Output> outputs)
+      : core_{logging::core::get()},
+        queue_{std::make_shared<RecordQueue>(options.queue_capacity)},
+        sink_{boost::make_shared<QueueSink>(boost::make_shared<QueueBackend>(
+            queue_,
+            metrics().counter("taktile_log_dropped_total",
+                              "Log records dropped because the asynchronous "
+                              "logger's queue was full")))},
+        format_{logging::parse_formatter(FORMAT)},
+        outputs_{std::move(outputs)},
+        interval_{options.flush_interval} {
+    thread_ = std::thread(&AsyncLogger::run, this);
+    core_->add_sink(sink_);
+  }
+
+  ~AsyncLogger() {
+    // No new records once the sink is gone; the thread drains the rest.
+    core_->remove_sink(sink_);
+    running_ = false;
+    thread_.join();
+  }
+
+  AsyncLogger(AsyncLogger const&) = delete;
+  AsyncLogger& operator=(AsyncLogger const&) = delete;
+
+ private:
+  void run() {
+    std::vector<logging::record_view> batch;
+    batch.reserve(WRITE_BATCH);
+    std::string line;
+    logging::formatting_ostream stream{line};
+    bool unflushed{false};
+    while (true) {
+      auto const stopping = !running_.load();
+      batch.clear();
+      queue_->pop(batch, WRITE_BATCH);
+      for (auto const& record : batch) {
+        line.clear();
+        format_(record, stream);
+        stream.flush();
+        for (auto const& output : outputs_) {
+          output.consume(record, line);
+        }
+      }
+      if (!batch.empty()) {
+        unflushed = true;
+        continue;
+      }
+      if (unflushed) {
+        for (auto const& output : outputs_) {
+          output.flush();
+        }
+        unflushed = false;
+      }
+      if (stopping) {
+        return;
+      }
+      std::this_thread::sleep_for(interval_);
+    }
+  }
+
+  // Keeps the core alive for the destructor, which may run at exit.
+  logging::core_ptr core_;
+  std::shared_ptr<RecordQueue> queue_;
+  boost::shared_ptr<QueueSink> sink_;
+  logging::formatter format_;
+  std::vector<Output> outputs_;
+  std::chrono::milliseconds interval_;
+  std::atomic<bool> running_{true};
+  std::thread thread_;
+};
+
+struct AsyncLoggerHolder {
+  std::mutex mutex;
+  std::unique_ptr<AsyncLogger> logger;
+};
+
+// Destroyed at exit, which stops the logger and writes out its queue.
+AsyncLoggerHolder async_logger;
+
+boost::shared_ptr<sinks::text_ostream_backend> console_backend(
+    bool auto_flush) {
+  auto backend = boost::make_shared<sinks::text_ostream_backend>();
+  backend->add_stream(
+      boost::shared_ptr<std::ostream>(&std::clog, boost::null_deleter()));
+  backend->auto_flush(auto_flush);
+  return backend;
+}
+
+boost::shared_ptr<sinks::text_file_backend> file_backend(
+    LoggerOptions const& options) {
+  auto backend = boost::make_shared<sinks::text_file_backend>(
+      keywords::file_name = options.file,
+      keywords::rotation_size = options.rotation_size,
+      keywords::open_mode = std::ios_base::out | std::ios_base::app);
+  if (options.max_files > 0) {
+    auto const slash = options.file.find_last_of('/');
+    backend->set_file_collector(sinks::file::make_collector(
+        keywords::target = slash == std::string::npos
+                               ? std::string{"."}
+                               : options.file.substr(0, slash + 1),
+        keywords::max_files = options.max_files));
+    backend->scan_for_files();
+  }
+  return backend;
+}
+
+template <typename Backend>
+void add_synchronous_sink(boost::shared_ptr<Backend> backend) {
+  auto sink = boost::make_shared<sinks::synchronous_sink<Backend>>(
+      std::move(backend));
+  sink->set_formatter(logging::parse_formatter(FORMAT));
+  logging::core::get()->add_sink(sink);
+}
+
+template <typename Backend>
+Output output(boost::shared_ptr<Backend> backend) {
+  return {[backend](logging::record_view const& record,
+                    std::string const& line) {
+            backend->consume(record, line);
+          },
+          [backend] { backend->flush(); }};
+}
+
+}  // namespace
+
+void init_logger(LoggerOptions const& options) {
+  // Fails before any sink is touched.
+  static_cast<void>(ring_capacity(options.queue_capacity));
+
+  auto const core = logging::core::get();
+  core->add_global_attribute("TimeStamp", logging::attributes::local_clock());
+  core->set_filter(logging::trivial::severity >= options.severity);
+
+  if (!options.asynchronous) {
+    if (options.console) {
+      add_synchronous_sink(console_backend(true));
+    }
+    if (!options.file.empty()) {
+      add_synchronous_sink(file_backend(options));
+    }
+    return;
+  }
+
+  std::vector<Output> outputs;
+  if (options.console) {
+    outputs.push_back(output(console_backend(false)));
+  }
+  if (!options.file.empty()) {
+    outputs.push_back(output(file_backend(options)));
+  }
+  std::lock_guard const lock{async_logger.mutex};
+  async_logger.logger.reset();
+  async_logger.logger =
+      std::make_unique<AsyncLogger>(options, std::move(outputs));
+}
+
+void stop_logger() {
+  std::lock_guard const lock{async_logger.mutex};
+  async_logger.logger.reset();
+}
+
+}  // namespace taktile
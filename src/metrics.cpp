@@ -0,0 +1,476 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include "taktile/metrics.hpp"
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+namespace taktile {
+
+namespace {
+
+[[noreturn]] void throw_errno(std::string const& what) {
+  throw std::system_error(errno, std::generic_category(), what);
+}
+
+// Stripes not owned by a live thread, other than the shared one.  Never
+// destroyed, since threads may exit after static destructors have run.
+struct StripePool {
+  std::mutex mutex;
+  std::vector<std::size_t> free;
+
+  StripePool() {
+    for (auto i = SHARED_METRIC_STRIPE; i-- > 0;) {
+      free.push_back(i);
+    }
+  }
+};
+
+StripePool& stripe_pool() {
+  static auto* const pool = new StripePool;
+  return *pool;
+}
+
+// Hands the thread's stripe back when it exits.
+struct StripeOwner {
+  std::size_t stripe{SHARED_METRIC_STRIPE};
+
+  ~StripeOwner() {
+    // Later metrics from this thread's exit path go to the shared stripe.
+    current_metric_stripe = SHARED_METRIC_STRIPE;
+    if (stripe != SHARED_METRIC_STRIPE) {
+      auto& pool = stripe_pool();
+      std::lock_guard const lock{pool.mutex};
+      pool.free.push_back(stripe);
+    }
+  }
+};
+
+thread_local StripeOwner stripe_owner;
+
+// Write end of the dump-signal pipe, or -1.
+std::atomic<int> signal_fd{-1};
+
+void on_dump_signal(int /*signal*/) {
+  auto const saved = errno;
+  auto const fd = signal_fd.load();
+  if (fd >= 0) {
+    char const byte{0};
+    static_cast<void>(::write(fd, &byte, 1));
+  }
+  errno = saved;
+}
+
+// Powers of two nanoseconds reported as Prometheus histogram buckets.
+constexpr unsigned FIRST_EXPOSED_POWER{6};
+constexpr unsigned LAST_EXPOSED_POWER{34};
+
+bool valid_metric_name(std::string_view name) {
+  auto const valid = [](char c, bool first) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' ||
+           c == ':' || (!first && c >= '0' && c <= '9');
+  };
+  if (name.empty() || !valid(name.front(), true)) {
+    return false;
+  }
+  return std::all_of(name.begin() + 1, name.end(),
+                     [&valid](char c) { return valid(c, false); });
+}
+
+void append_help(std::string& out, std::string const& name,
+                 std::string const& help, char const* type) {
+  if (!help.empty()) {
+    out += "# HELP " + name + ' ';
+    for (auto const c : help) {
+      if (c == '\\') {
+        out += "\\\\";
+      } else if (c == '\n') {
+        out += "\\n";
+      } else {
+        out += c;
+      }
+    }
+    out += '\n';
+  }
+  out += "# TYPE " + name + ' ' + type + '\n';
+}
+
+std::string seconds(uint64_t nanoseconds) {
+  std::array<char, 32> text{};
+  std::snprintf(text.data(), text.size(), "%.9g",
+                static_cast<double>(nanoseconds) / 1e9);
+  return text.data();
+}
+
+// Sockets are written with MSG_NOSIGNAL, so a scraper that hangs up early
+// does not raise SIGPIPE.
+bool write_all(int fd, std::string_view data, bool socket) {
+  while (!data.empty()) {
+    auto const n = socket ? ::send(fd, data.data(), data.size(), MSG_NOSIGNAL)
+                          : ::write(fd, data.data(), data.size());
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    data.remove_prefix(static_cast<std::size_t>(n));
+  }
+  return true;
+}
+
+}  // namespace
+
+std::size_t acquire_metric_stripe() {
+  auto& pool = stripe_pool();
+  std::lock_guard const lock{pool.mutex};
+  if (!pool.free.empty()) {
+    stripe_owner.stripe = pool.free.back();
+    pool.free.pop_back();
+  }
+  return stripe_owner.stripe;
+}
+
+uint64_t Counter::value() const {
+  uint64_t total{0};
+  for (auto const& stripe : stripes_) {
+    total += stripe.value.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
+uint64_t HistogramSnapshot::percentile(double q) const {
+  if (count == 0) {
+    return 0;
+  }
+  auto const rank = std::max<uint64_t>(
+      1, static_cast<uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) *
+                                         static_cast<double>(count))));
+  uint64_t seen{0};
+  for (std::size_t bucket = 0; bucket < counts.size(); ++bucket) {
+    seen += counts[bucket];
+    if (seen >= rank) {
+      return HistogramBuckets::highest(bucket);
+    }
+  }
+  return HistogramBuckets::highest(counts.size() - 1);
+}
+
+LatencyHistogram::LatencyHistogram()
+    : stripes_{std::make_unique<Stripe[]>(METRIC_STRIPES)} {}
+
+HistogramSnapshot LatencyHistogram::snapshot() const {
+  HistogramSnapshot snapshot;
+  snapshot.counts.resize(HistogramBuckets::COUNT);
+  for (std::size_t s = 0; s < METRIC_STRIPES; ++s) {
+    auto const& stripe = stripes_[s];
+    for (std::size_t bucket = 0; bucket < HistogramBuckets::COUNT; ++bucket) {
+      auto const n = stripe.buckets[bucket].load(std::memory_order_relaxed);
+      snapshot.counts[bucket] += n;
+      snapshot.count += n;
+    }
+    snapshot.sum += stripe.sum.load(std::memory_order_relaxed);
+  }
+  return snapshot;
+}
+
+Counter& MetricsRegistry::counter(std::string const& name,
+                                  std::string const& help) {
+  std::lock_guard const lock{mutex_};
+  if (auto const found = counters_.find(name); found != counters_.end()) {
+    return *found->second.metric;
+  }
+  if (!valid_metric_name(name) || histograms_.count(name) != 0) {
+    throw std::invalid_argument("Invalid or duplicate metric name: " + name);
+  }
+  auto& entry = counters_[name];
+  entry.help = help;
+  entry.metric = std::make_unique<Counter>();
+  return *entry.metric;
+}
+
+LatencyHistogram& MetricsRegistry::histogram(std::string const& name,
+                                             std::string const& help) {
+  std::lock_guard const lock{mutex_};
+  if (auto const found = histograms_.find(name); found != histograms_.end()) {
+    return *found->second.metric;
+  }
+  if (!valid_metric_name(name) || counters_.count(name) != 0) {
+    throw std::invalid_argument("Invalid or duplicate metric name: " + name);
+  }
+  auto& entry = histograms_[name];
+  entry.help = help;
+  entry.metric = std::make_unique<LatencyHistogram>();
+  return *entry.metric;
+}
+
+MetricsSnapshot MetricsRegistry::snapshot() const {
+  std::lock_guard const lock{mutex_};
+  MetricsSnapshot snapshot;
+  for (auto const& [name, entry] : counters_) {
+    snapshot.counters.emplace(name, entry.metric->value());
+  }
+  for (auto const& [name, entry] : histograms_) {
+    snapshot.histograms.emplace(name, entry.metric->snapshot());
+  }
+  return snapshot;
+}
+
+std::string MetricsRegistry::prometheus() const {
+  std::lock_guard const lock{mutex_};
+  std::string out;
+  for (auto const& [name, entry] : counters_) {
+    append_help(out, name, entry.help, "counter");
+    out += name + ' ' + std::to_string(entry.metric->value()) + '\n';
+  }
+  for (auto const& [name, entry] : histograms_) {
+    append_help(out, name, entry.help, "histogram");
+    auto const snapshot = entry.metric->snapshot();
+    uint64_t cumulative{0};
+    std::size_t bucket{0};
+    for (auto power = FIRST_EXPOSED_POWER; power <= LAST_EXPOSED_POWER;
+         ++power) {
+      auto const bound = uint64_t{1} << power;
+      // Buckets break at powers of two, so this counts every sample below
+      // bound exactly.
+      for (; bucket < HistogramBuckets::of(bound); ++bucket) {
+        cumulative += snapshot.counts[bucket];
+      }
+      out += name + "_bucket{le=\"" + seconds(bound) + "\"} " +
+             std::to_string(cumulative) + '\n';
+    }
+    out += name + "_bucket{le=\"+Inf\"} " + std::to_string(snapshot.count) +
+           '\n';
+    out += name + "_sum " + seconds(snapshot.sum) + '\n';
+    out += name + "_count " + std::to_string(snapshot.count) + '\n';
+  }
+  return out;
+}
+
+MetricsRegistry& metrics() {
+  static auto* const registry = new MetricsRegistry;
+  return *registry;
+}
+
+MetricsExporter::MetricsExporter(MetricsRegistry& registry,
+                                 MetricsExporterOptions options)
+    : registry_{registry}, options_{std::move(options)} {
+  try {
+    if (!options_.address.empty()) {
+      sockaddr_in address{};
+      address.sin_family = AF_INET;
+      address.sin_port = htons(options_.port);
+      if (::inet_pton(AF_INET, options_.address.c_str(), &address.sin_addr) !=
+          1) {
+        throw std::invalid_argument("Invalid metrics address: " +
+                                    options_.address);
+      }
+      listen_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+      if (listen_fd_ < 0) {
+        throw_errno("socket");
+      }
+      int const enable{1};
+      ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &enable,
+                   sizeof(enable));
+      if (::bind(listen_fd_, reinterpret_cast<sockaddr const*>(&address),
+                 sizeof(address)) != 0) {
+        throw_errno("bind");
+      }
+      if (::listen(listen_fd_, SOMAXCONN) != 0) {
+        throw_errno("listen");
+      }
+      socklen_t size = sizeof(address);
+      ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&address), &size);
+      port_ = ntohs(address.sin_port);
+    }
+
+    if (::pipe2(signal_pipe_.data(), O_CLOEXEC | O_NONBLOCK) != 0) {
+      throw_errno("pipe2");
+    }
+    if (options_.dump_signal != 0) {
+      int expected{-1};
+      if (!signal_fd.compare_exchange_strong(expected, signal_pipe_[1])) {
+        throw std::invalid_argument(
+            "Another MetricsExporter already handles a dump signal");
+      }
+      struct sigaction action {};
+      action.sa_handler = on_dump_signal;
+      action.sa_flags = SA_RESTART;
+      sigemptyset(&action.sa_mask);
+      if (::sigaction(options_.dump_signal, &action, &previous_action_) !=
+          0) {
+        signal_fd = -1;
+        throw_errno("sigaction");
+      }
+    }
+  } catch (...) {
+    close_all();
+    throw;
+  }
+  thread_ = std::thread(&MetricsExporter::run, this);
+}
+
+MetricsExporter::~MetricsExporter() {
+  running_ = false;
+  // Wake the thread rather than waiting out its poll timeout.
+  char const byte{1};
+  static_cast<void>(::write(signal_pipe_[1], &byte, 1));
+  thread_.join();
+  if (options_.dump_signal != 0) {
+    ::sigaction(options_.dump_signal, &previous_action_, nullptr);
+    signal_fd = -1;
+  }
+  close_all();
+}
+
+void MetricsExporter::close_all() {
+  for (auto const fd : {listen_fd_, signal_pipe_[0], signal_pipe_[1]}) {
+    if (fd >= 0) {
+      ::close(fd);
+    }
+  }
+}
+
+void MetricsExporter::run() {
+  std::array<pollfd, 2> fds{};
+  fds[0].fd = signal_pipe_[0];
+  fds[0].events = POLLIN;
+  fds[1].fd = listen_fd_;
+  fds[1].events = POLLIN;
+  nfds_t const count = listen_fd_ >= 0 ? 2 : 1;
+  while (running_.load()) {
+    if (::poll(fds.data(), count, -1) <= 0) {
+      continue;
+    }
+    if (fds[0].revents & POLLIN) {
+      // The signal handler writes 0 and the destructor writes 1.
+      std::array<char, 64> bytes{};
+      auto const n = ::read(signal_pipe_[0], bytes.data(), bytes.size());
+      auto const end = bytes.begin() + std::max<ssize_t>(n, 0);
+      if (std::find(bytes.begin(), end, 0) != end) {
+        write_all(options_.dump_fd, registry_.prometheus(), false);
+      }
+    }
+    if (count == 2 && (fds[1].revents & POLLIN)) {
+      auto const client = ::accept4(listen_fd_, nullptr, nullptr,
+                                    SOCK_CLOEXEC);
+      if (client >= 0) {
+        serve(client);
+        ::close(client);
+      }
+    }
+  }
+}
+
+void MetricsExporter::serve(int client) {
+  // A scrape that stalls must not hold up dumps or shutdown for long.
+  timeval const timeout{1, 0};
+  ::setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  std::string request;
+  std::array<char, 1024> buffer{};
+  while (request.find("\r\n\r\n") == std::string::npos &&
+         request.size() < 8192) {
+    auto const n = ::recv(client, buffer.data(), buffer.size(), 0);
+    if (n <= 0) {
+      return;
+    }
+    request.append(buffer.data(), static_cast<std::size_t>(n));
+  }
+
+  auto const line = std::string_view(request).substr(0, request.find("\r\n"));
+  if (line.rfind("GET /metrics ", 0) == 0 ||
+      line.rfind("GET /metrics?", 0) == 0) {
+    auto const body = registry_.prometheus();
+    write_all(client,
+              "HTTP/1.1 200 OK\r\n"
+              "Content-Type: text/plain; version=0.0.4\r\n"
+              "Content-Length: " +
+                  std::to_string(body.size()) +
+                  "\r\nConnection: close\r\n\r\n" + body,
+              true);
+  } else {
+    write_all(client,
+              "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n"
+              "Connection: close\r\n\r\n",
+              true);
+  }
+}
+
+MeteredCotSerializer::MeteredCotSerializer(
+    std::shared_ptr<CotSerializer> serializer, MetricsRegistry& registry)
+    : serializer_{std::move(serializer)},
+      serialize_latency_{registry.histogram(
+          "taktile_serialize_seconds", "Time to serialize a CoT message")},
+      deserialize_latency_{registry.histogram(
+          "taktile_deserialize_seconds", "Time to deserialize a CoT message")},
+      serialize_failures_{registry.counter("taktile_serialize_failures_total",
+                                           "CoT messages that failed to "
+                                           "serialize")},
+      deserialize_failures_{registry.counter(
+          "taktile_deserialize_failures_total",
+          "CoT messages that failed to deserialize")} {}
+
+std::vector<std::byte> MeteredCotSerializer::serialize(CotType const& cot) {
+  auto const start = std::chrono::steady_clock::now();
+  try {
+    auto blob = serializer_->serialize(cot);
+    serialize_latency_.record_since(start);
+    return blob;
+  } catch (...) {
+    serialize_failures_.add();
+    throw;
+  }
+}
+
+CotType MeteredCotSerializer::deserialize(std::vector<std::byte> const& blob) {
+  auto const start = std::chrono::steady_clock::now();
+  try {
+    auto cot = serializer_->deserialize(blob);
+    deserialize_latency_.record_since(start);
+    return cot;
+  } catch (...) {
+    deserialize_failures_.add();
+    throw;
+  }
+}
+
+std::size_t MeteredCotSerializer::serialize_into(CotType const& cot,
+                                                 std::byte* buffer,
+                                                 std::size_t capacity) {
+  auto const start = std::chrono::steady_clock::now();
+  try {
+    auto const size = serializer_->serialize_into(cot, buffer, capacity);
+    serialize_latency_.record_since(start);
+    return size;
+  } catch (...) {
+    serialize_failures_.add();
+    throw;
+  }
+}
+
+CotType MeteredCotSerializer::deserialize_from(std::byte const* data,
+                                               std::size_t size) {
+  auto const start = std::chrono::steady_clock::now();
+  try {
+    auto cot = serializer_->deserialize_from(data, size);
+    deserialize_latency_.record_since(start);
+    return cot;
+  } catch (...) {
+    deserialize_failures_.add();
+    throw;
+  }
+}
+
+}  // namespace taktile
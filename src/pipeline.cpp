@@ -0,0 +1,115 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include "taktile/pipeline.hpp"
+
+#include <pthread.h>
+#include <sched.h>
+
+namespace taktile {
+
+namespace {
+
+// Rounds of spinning, then yielding, before an idle worker sleeps.
+constexpr unsigned SPINS{64};
+constexpr unsigned YIELDS{128};
+
+}  // namespace
+
+void Pipeline::Backoff::pause() {
+  if (spins_ < SPINS) {
+    ++spins_;
+  } else if (spins_ < SPINS + YIELDS) {
+    ++spins_;
+    std::this_thread::yield();
+  } else {
+    std::this_thread::sleep_for(sleep_);
+  }
+}
+
+Pipeline::~Pipeline() {
+  stop();
+}
+
+Pipeline::Stage& Pipeline::add(StageOptions options) {
+  if (running_) {
+    throw std::invalid_argument("Pipeline stages must be added before start()");
+  }
+  if (options.threads == 0 || options.batch_size == 0) {
+    throw std::invalid_argument(
+        "Pipeline stage needs at least one thread and a positive batch size");
+  }
+  // Fails here, rather than when the stage is connected.
+  static_cast<void>(ring_capacity(options.queue_capacity));
+  stages_.push_back(std::make_unique<Stage>(std::move(options)));
+  return *stages_.back();
+}
+
+void Pipeline::start() {
+  if (running_) {
+    return;
+  }
+  for (auto const& stage : stages_) {
+    if (stage->connected && !stage->connected()) {
+      throw std::invalid_argument("Output of pipeline stage '" +
+                                  stage->options.name + "' is not consumed");
+    }
+  }
+  running_ = true;
+  started_ = std::chrono::steady_clock::now();
+  for (auto& stage : stages_) {
+    stage->stopping = false;
+    auto const& cpus = stage->options.cpus;
+    for (std::size_t i = 0; i < stage->options.threads; ++i) {
+      stage->threads.emplace_back(stage->run, i);
+      if (!cpus.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpus[i % cpus.size()], &set);
+        ::pthread_setaffinity_np(stage->threads.back().native_handle(),
+                                 sizeof(set), &set);
+      }
+    }
+  }
+}
+
+void Pipeline::stop() {
+  if (!running_) {
+    return;
+  }
+  for (auto& stage : stages_) {
+    stage->stopping.store(true, std::memory_order_release);
+    for (auto& thread : stage->threads) {
+      thread.join();
+    }
+    stage->threads.clear();
+  }
+  stopped_ = std::chrono::steady_clock::now();
+  running_ = false;
+}
+
+std::vector<StageStats> Pipeline::stats() const {
+  auto const end = running_ ? std::chrono::steady_clock::now() : stopped_;
+  auto const seconds = std::chrono::duration<double>(end - started_).count();
+
+  std::vector<StageStats> stats;
+  stats.reserve(stages_.size());
+  for (auto const& stage : stages_) {
+    auto& entry = stats.emplace_back();
+    entry.name = stage->options.name;
+    if (stage->depth) {
+      entry.queue_depth = stage->depth();
+      entry.queue_capacity = stage->capacity;
+    }
+    for (auto const& counters : stage->counters) {
+      entry.processed += counters.processed.load(std::memory_order_relaxed);
+      entry.failures += counters.failures.load(std::memory_order_relaxed);
+      entry.stalls += counters.stalls.load(std::memory_order_relaxed);
+    }
+    if (seconds > 0.0) {
+      entry.throughput = static_cast<double>(entry.processed) / seconds;
+    }
+  }
+  return stats;
+}
+
+}  // namespace taktile
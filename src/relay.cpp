@@ -0,0 +1,63 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include "taktile/relay.hpp"
+
+#include "taktile/xml_writer.hpp"
+
+namespace taktile {
+
+namespace {
+
+constexpr std::string_view FLOW_TAGS_OPEN{"<_flow-tags_"};
+constexpr std::string_view FLOW_TAGS_CLOSE{"/>"};
+constexpr std::string_view DETAIL_OPEN{"<detail>"};
+constexpr std::string_view DETAIL_CLOSE{"</detail>"};
+
+}  // namespace
+
+CotRelayEvent::CotRelayEvent(std::string_view xml)
+    : xml_{xml}, spans_{scan_cot_relay_xml(xml, flow_tag_name())} {}
+
+std::size_t CotRelayEvent::size() const {
+  // The new time, and the flow-tag written as ` name="datetime"`.
+  auto size = xml_.size() - (spans_.time_end - spans_.time_begin) +
+              W3C_DATETIME_LENGTH - (spans_.flow_end - spans_.flow_begin) +
+              flow_tag_name().size() + W3C_DATETIME_LENGTH + 4;
+  if (spans_.flow_insert != CotRelaySpans::Insert::ATTRIBUTE) {
+    size += FLOW_TAGS_OPEN.size() + FLOW_TAGS_CLOSE.size();
+  }
+  if (spans_.flow_insert == CotRelaySpans::Insert::DETAIL) {
+    size += DETAIL_OPEN.size() + DETAIL_CLOSE.size();
+  }
+  return size;
+}
+
+std::size_t CotRelayEvent::write(int64_t now, std::byte* buffer,
+                                 std::size_t capacity) const {
+  using Insert = CotRelaySpans::Insert;
+  XmlWriter writer{buffer, capacity};
+  writer.raw(xml_.substr(0, spans_.time_begin))
+      .datetime(now)
+      .raw(xml_.substr(spans_.time_end, spans_.flow_begin - spans_.time_end));
+  if (spans_.flow_insert == Insert::DETAIL) {
+    writer.raw(DETAIL_OPEN);
+  }
+  if (spans_.flow_insert != Insert::ATTRIBUTE) {
+    writer.raw(FLOW_TAGS_OPEN);
+  }
+  writer.datetime_attribute(flow_tag_name(), now);
+  if (spans_.flow_insert != Insert::ATTRIBUTE) {
+    writer.raw(FLOW_TAGS_CLOSE);
+  }
+  if (spans_.flow_insert == Insert::DETAIL) {
+    writer.raw(DETAIL_CLOSE);
+  }
+  writer.raw(xml_.substr(spans_.flow_end));
+
+  if (writer.overflowed()) {
+    throw_oversize(capacity);
+  }
+  return writer.size();
+}
+
+}  // namespace taktile
@@ -0,0 +1,209 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include "taktile/router.hpp"
+
+#include <algorithm>
+#include <boost/log/trivial.hpp>
+#include <deque>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+namespace taktile {
+
+/// @brief One destination: a bounded queue in front of a transport
+class CotRouter::Route {
+ public:
+  explicit Route(RouteOptions const& options)
+      : capacity_{std::max<std::size_t>(options.queue_capacity, 1)},
+        drop_policy_{options.drop_policy} {}
+
+  virtual ~Route() = default;
+
+  Route(Route const&) = delete;
+  Route(Route&&) = delete;
+  Route& operator=(Route const&) = delete;
+  Route& operator=(Route&&) = delete;
+
+  /// @return false if the message was dropped
+  bool push(SharedBlob const& blob) {
+    if (stats_.failed) {
+      ++stats_.dropped;
+      return false;
+    }
+    if (queue_.size() == capacity_) {
+      ++stats_.dropped;
+      if (drop_policy_ == DropPolicy::NEWEST) {
+        return false;
+      }
+      queue_.pop_front();
+    }
+    queue_.push_back(blob);
+    ++stats_.routed;
+    return true;
+  }
+
+  void flush() {
+    if (stats_.failed) {
+      return;
+    }
+    try {
+      send();
+    } catch (std::system_error const& error) {
+      BOOST_LOG_TRIVIAL(error) << "CoT route failed: " << error.what();
+      stats_.failed = true;
+      stats_.dropped += queue_.size();
+      queue_.clear();
+    }
+  }
+
+  [[nodiscard]] RouteStats const& stats() const {
+    return stats_;
+  }
+
+ protected:
+  /// @brief Move as much of queue_ to the transport as it takes right now
+  virtual void send() = 0;
+
+  std::deque<SharedBlob> queue_;
+  RouteStats stats_;
+
+ private:
+  std::size_t capacity_;
+  DropPolicy drop_policy_;
+};
+
+namespace {
+
+class UdpRoute : public CotRouter::Route {
+ public:
+  UdpRoute(URL const& url, RouteOptions const& options)
+      : Route{options}, sender_{url, options.udp} {}
+
+ protected:
+  void send() override {
+    while (!queue_.empty()) {
+      if (sender_.enqueue(queue_.front())) {
+        queue_.pop_front();
+      } else if (sender_.queued() == 0) {
+        // Only an oversize datagram is refused by an empty sender.
+        ++stats_.dropped;
+        queue_.pop_front();
+      } else {
+        collect(sender_.flush());
+      }
+    }
+    collect(sender_.flush());
+  }
+
+ private:
+  void collect(UdpBatchResult const& result) {
+    // Refusals are handled in send(): retried, or counted there if oversize.
+    stats_.sent += result.sent;
+    stats_.dropped += result.dropped;
+  }
+
+  CotUdpSender sender_;
+};
+
+class StreamRoute : public CotRouter::Route {
+ public:
+  StreamRoute(URL const& url, RouteOptions const& options)
+      : Route{options}, stream_{url, options.stream} {}
+
+ protected:
+  void send() override {
+    while (!queue_.empty()) {
+      auto const& blob = queue_.front();
+      if (!blob || blob->empty()) {
+        // The stream never takes an empty payload; left here it would
+        // block everything queued behind it.
+        ++stats_.dropped;
+      } else if (!stream_.enqueue(blob)) {
+        break;
+      }
+      queue_.pop_front();
+    }
+    stream_.flush();
+    stats_.sent = stream_.stats().messages_sent;
+  }
+
+ private:
+  CotStream stream_;
+};
+
+class LogRoute : public CotRouter::Route {
+ public:
+  explicit LogRoute(RouteOptions const& options) : Route{options} {}
+
+ protected:
+  void send() override {
+    for (auto const& blob : queue_) {
+      BOOST_LOG_TRIVIAL(info) << std::string_view(
+          reinterpret_cast<char const*>(blob->data()), blob->size());
+    }
+    stats_.sent += queue_.size();
+    queue_.clear();
+  }
+};
+
+}  // namespace
+
+CotRouter::CotRouter(std::shared_ptr<CotSerializer> serializer,
+                     std::vector<URL> const& urls,
+                     RouteOptions const& options)
+    : serializer_{std::move(serializer)} {
+  for (auto const& url : urls) {
+    add_route(url, options);
+  }
+}
+
+CotRouter::~CotRouter() = default;
+
+std::size_t CotRouter::add_route(URL const& url, RouteOptions const& options) {
+  switch (url.scheme) {
+    case Scheme::UDP:
+    case Scheme::UDP_BROADCAST:
+    case Scheme::UDP_WRITE_ONLY:
+      routes_.push_back(std::make_unique<UdpRoute>(url, options));
+      break;
+    case Scheme::TCP:
+    case Scheme::TLS:
+      routes_.push_back(std::make_unique<StreamRoute>(url, options));
+      break;
+    case Scheme::LOG:
+      routes_.push_back(std::make_unique<LogRoute>(options));
+      break;
+    default:
+      throw std::invalid_argument("CotRouter cannot route to " +
+                                  std::string(scheme_name(url.scheme)) +
+                                  " URLs.");
+  }
+  return routes_.size() - 1;
+}
+
+std::size_t CotRouter::route(CotType const& cot) {
+  return route(std::make_shared<std::vector<std::byte> const>(
+      serializer_->serialize(cot)));
+}
+
+std::size_t CotRouter::route(SharedBlob const& blob) {
+  std::size_t queued{0};
+  for (auto& route : routes_) {
+    queued += static_cast<std::size_t>(route->push(blob));
+  }
+  return queued;
+}
+
+void CotRouter::flush() {
+  for (auto& route : routes_) {
+    route->flush();
+  }
+}
+
+RouteStats const& CotRouter::stats(std::size_t index) const {
+  return routes_.at(index)->stats();
+}
+
+}  // namespace taktile
@@ -0,0 +1,173 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include "taktile/spatial_index.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace taktile {
+
+namespace {
+
+constexpr double PI{3.14159265358979323846};
+constexpr double RADIANS_PER_DEGREE{PI / 180.0};
+
+}  // namespace
+
+double haversine_m(double lat1, double lon1, double lat2, double lon2) {
+  auto const phi1 = lat1 * RADIANS_PER_DEGREE;
+  auto const phi2 = lat2 * RADIANS_PER_DEGREE;
+  auto const sin_dphi = std::sin((phi2 - phi1) / 2.0);
+  auto const sin_dlambda = std::sin((lon2 - lon1) * RADIANS_PER_DEGREE / 2.0);
+  auto const h = sin_dphi * sin_dphi +
+                 std::cos(phi1) * std::cos(phi2) * sin_dlambda * sin_dlambda;
+  return 2.0 * EARTH_RADIUS_M * std::asin(std::sqrt(std::min(h, 1.0)));
+}
+
+SpatialIndex::SpatialIndex(double cell_degrees)
+    : cell_degrees_{cell_degrees} {
+  if (!(cell_degrees > 0.0 && cell_degrees <= 180.0)) {
+    throw std::invalid_argument("Cell size must be in (0, 180] degrees.");
+  }
+  rows_ = static_cast<int64_t>(std::ceil(180.0 / cell_degrees_));
+  columns_ = static_cast<int64_t>(std::ceil(360.0 / cell_degrees_));
+}
+
+void SpatialIndex::update(std::string const& uid, double lat, double lon) {
+  if (!(lat >= -90.0 && lat <= 90.0)) {
+    throw std::invalid_argument("Latitude must be in [-90, 90].");
+  }
+  if (!(lon >= -180.0 && lon <= 180.0)) {
+    throw std::invalid_argument("Longitude must be in [-180, 180].");
+  }
+  auto const cell = row(lat) * columns_ + column(lon);
+
+  auto const it = ids_.find(uid);
+  if (it == ids_.end()) {
+    auto const id = entries_.size();
+    auto& ids = cells_[cell];
+    entries_.push_back({uid, lat, lon, cell, ids.size()});
+    ids.push_back(id);
+    ids_.emplace(uid, id);
+    return;
+  }
+
+  auto& entry = entries_[it->second];
+  entry.lat = lat;
+  entry.lon = lon;
+  if (entry.cell == cell) {
+    return;
+  }
+  // Swap out of the old cell and append to the new one.
+  auto& old_ids = cells_[entry.cell];
+  auto const moved = old_ids.back();
+  old_ids[entry.slot] = moved;
+  entries_[moved].slot = entry.slot;
+  old_ids.pop_back();
+
+  auto& new_ids = cells_[cell];
+  entry.cell = cell;
+  entry.slot = new_ids.size();
+  new_ids.push_back(it->second);
+}
+
+bool SpatialIndex::remove(std::string const& uid) {
+  auto const it = ids_.find(uid);
+  if (it == ids_.end()) {
+    return false;
+  }
+  auto const id = it->second;
+  ids_.erase(it);
+
+  auto& ids = cells_[entries_[id].cell];
+  auto const moved_in_cell = ids.back();
+  ids[entries_[id].slot] = moved_in_cell;
+  entries_[moved_in_cell].slot = entries_[id].slot;
+  ids.pop_back();
+
+  // Keep entries_ dense: the last entry takes the removed one's place.
+  auto const last = entries_.size() - 1;
+  if (id != last) {
+    entries_[id] = std::move(entries_[last]);
+    cells_[entries_[id].cell][entries_[id].slot] = id;
+    ids_[entries_[id].uid] = id;
+  }
+  entries_.pop_back();
+  return true;
+}
+
+std::vector<std::string> SpatialIndex::within(GeoBox const& box) const {
+  std::vector<std::string> uids;
+  for_each_within(box, [&uids](std::string const& uid, double, double) {
+    uids.push_back(uid);
+  });
+  return uids;
+}
+
+std::vector<std::string> SpatialIndex::within(double lat, double lon,
+                                              double radius_m) const {
+  std::vector<std::string> uids;
+  for_each_within(lat, lon, radius_m,
+                  [&uids](std::string const& uid, double, double) {
+                    uids.push_back(uid);
+                  });
+  return uids;
+}
+
+int64_t SpatialIndex::row(double lat) const {
+  return std::clamp<int64_t>(
+      static_cast<int64_t>(std::floor((lat + 90.0) / cell_degrees_)), 0,
+      rows_ - 1);
+}
+
+int64_t SpatialIndex::column(double lon) const {
+  return std::clamp<int64_t>(
+      static_cast<int64_t>(std::floor((lon + 180.0) / cell_degrees_)), 0,
+      columns_ - 1);
+}
+
+std::size_t SpatialIndex::radius_boxes(double lat, double lon,
+                                       double radius_m,
+                                       std::array<GeoBox, 2>& boxes) {
+  if (!(radius_m >= 0.0)) {
+    return 0;
+  }
+  auto const angle = radius_m / EARTH_RADIUS_M;
+  auto const dlat = angle / RADIANS_PER_DEGREE;
+  auto const min_lat = lat - dlat;
+  auto const max_lat = lat + dlat;
+  if (min_lat <= -90.0 || max_lat >= 90.0 || angle >= PI / 2.0) {
+    // The circle reaches a pole, so it spans every longitude.
+    boxes[0] = {std::max(min_lat, -90.0), -180.0, std::min(max_lat, 90.0),
+                180.0};
+    return 1;
+  }
+  // Widest longitude offset of a circle on the sphere.
+  auto const dlon =
+      std::asin(std::min(std::sin(angle) / std::cos(lat * RADIANS_PER_DEGREE),
+                         1.0)) /
+      RADIANS_PER_DEGREE;
+  auto const min_lon = lon - dlon;
+  auto const max_lon = lon + dlon;
+  if (max_lon - min_lon >= 360.0) {
+    boxes[0] = {min_lat, -180.0, max_lat, 180.0};
+    return 1;
+  }
+  if (min_lon < -180.0) {
+    boxes[0] = {min_lat, min_lon + 360.0, max_lat, 180.0};
+    boxes[1] = {min_lat, -180.0, max_lat, max_lon};
+    return 2;
+  }
+  if (max_lon > 180.0) {
+    boxes[0] = {min_lat, min_lon, max_lat, 180.0};
+    boxes[1] = {min_lat, -180.0, max_lat, max_lon - 360.0};
+    return 2;
+  }
+  boxes[0] = {min_lat, min_lon, max_lat, max_lon};
+  return 1;
+}
+
+}  // namespace taktile
@@ -0,0 +1,539 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include "taktile/stream.hpp"
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+namespace taktile {
+
+namespace {
+
+constexpr std::string_view END_TAG{"</event>"};
+// Largest TLS record payload; coalescing beyond it buys nothing.
+constexpr std::size_t TLS_RECORD_SIZE{16384};
+constexpr std::size_t READ_SIZE{16384};
+
+constexpr bool is_space(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+[[noreturn]] void throw_errno(std::string const& what) {
+  throw std::system_error(errno, std::generic_category(), what);
+}
+
+[[noreturn]] void throw_tls(std::string const& what) {
+  std::string message = what;
+  while (auto const error = ::ERR_get_error()) {
+    message += ": " + std::string(::ERR_reason_error_string(error)
+                                      ? ::ERR_reason_error_string(error)
+                                      : "unknown");
+  }
+  throw std::system_error(std::make_error_code(std::errc::protocol_error),
+                          message);
+}
+
+int remaining_ms(std::chrono::steady_clock::time_point deadline) {
+  auto const remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+      deadline - std::chrono::steady_clock::now());
+  return static_cast<int>(std::max<int64_t>(remaining.count(), 0));
+}
+
+bool wait_for(int fd, int16_t events, int timeout_ms) {
+  pollfd pfd{fd, events, 0};
+  auto const ready = ::poll(&pfd, 1, timeout_ms);
+  if (ready < 0 && errno != EINTR) {
+    throw_errno("poll");
+  }
+  return ready > 0;
+}
+
+/// @brief Open a non-blocking TCP connection within the deadline
+int connect_tcp(URL const& url,
+                std::chrono::steady_clock::time_point deadline) {
+  addrinfo hints{};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo* result{nullptr};
+  auto const port = std::to_string(url.port);
+  auto const status =
+      ::getaddrinfo(url.net_loc.c_str(), port.c_str(), &hints, &result);
+  if (status != 0 || result == nullptr) {
+    throw std::invalid_argument("Unable to resolve " + url.net_loc + ": " +
+                                ::gai_strerror(status));
+  }
+
+  int error{ECONNREFUSED};
+  for (auto const* info = result; info != nullptr; info = info->ai_next) {
+    auto const fd = ::socket(info->ai_family,
+                             info->ai_socktype | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                             info->ai_protocol);
+    if (fd < 0) {
+      error = errno;
+      continue;
+    }
+    if (::connect(fd, info->ai_addr, info->ai_addrlen) == 0) {
+      // Loopback connects can complete immediately.
+      error = 0;
+    } else if (errno == EINPROGRESS &&
+               wait_for(fd, POLLOUT, remaining_ms(deadline))) {
+      socklen_t size = sizeof(error);
+      ::getsockopt(fd, SOL_SOCKET, SO_ERROR, &error, &size);
+    } else {
+      error = errno == EINPROGRESS ? ETIMEDOUT : errno;
+    }
+    if (error == 0) {
+      ::freeaddrinfo(result);
+      int const enable{1};
+      ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+      return fd;
+    }
+    ::close(fd);
+  }
+  ::freeaddrinfo(result);
+  errno = error;
+  throw_errno("connect to " + url.net_loc + ":" + port);
+}
+
+}  // namespace
+
+/// @brief Byte pipe under a CotStream; reads and writes never block
+class CotStream::Transport {
+ public:
+  explicit Transport(int fd) : fd_{fd} {}
+
+  virtual ~Transport() {
+    ::close(fd_);
+  }
+
+  Transport(Transport const&) = delete;
+  Transport(Transport&&) = delete;
+  Transport& operator=(Transport const&) = delete;
+  Transport& operator=(Transport&&) = delete;
+
+  [[nodiscard]] int fd() const {
+    return fd_;
+  }
+
+  /// @return bytes written; 0 if the socket is full
+  virtual std::size_t write(iovec const* iov, int count) {
+    auto const written = ::writev(fd_, iov, count);
+    if (written < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+        return 0;
+      }
+      throw_errno("writev");
+    }
+    return static_cast<std::size_t>(written);
+  }
+
+  /// @return bytes read; 0 if nothing is available
+  virtual std::size_t read(std::byte* data, std::size_t size) {
+    auto const count = ::recv(fd_, data, size, 0);
+    if (count == 0) {
+      throw std::system_error(std::make_error_code(std::errc::not_connected),
+                              "Connection closed by peer");
+    }
+    if (count < 0) {
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+        return 0;
+      }
+      throw_errno("recv");
+    }
+    return static_cast<std::size_t>(count);
+  }
+
+  /// @brief Whether bytes are buffered above the socket (decrypted TLS)
+  [[nodiscard]] virtual bool pending() const {
+    return false;
+  }
+
+ private:
+  int fd_;
+};
+
+namespace {
+
+class TlsTransport : public CotStream::Transport {
+ public:
+  TlsTransport(int fd, URL const& url, StreamOptions const& options,
+               std::chrono::steady_clock::time_point deadline)
+      : Transport{fd}, context_{::SSL_CTX_new(::TLS_client_method())} {
+    if (context_ == nullptr) {
+      throw_tls("SSL_CTX_new");
+    }
+    if (options.verify_peer) {
+      ::SSL_CTX_set_verify(context_, SSL_VERIFY_PEER, nullptr);
+      auto const loaded =
+          options.ca_file.empty()
+              ? ::SSL_CTX_set_default_verify_paths(context_)
+              : ::SSL_CTX_load_verify_locations(
+                    context_, options.ca_file.c_str(), nullptr);
+      if (loaded != 1) {
+        cleanup();
+        throw_tls("Unable to load trusted CAs");
+      }
+    }
+    if (!options.cert_file.empty() &&
+        (::SSL_CTX_use_certificate_chain_file(
+             context_, options.cert_file.c_str()) != 1 ||
+         ::SSL_CTX_use_PrivateKey_file(context_, options.key_file.c_str(),
+                                       SSL_FILETYPE_PEM) != 1)) {
+      cleanup();
+      throw_tls("Unable to load client certificate");
+    }
+
+    ssl_ = ::SSL_new(context_);
+    if (ssl_ == nullptr) {
+      cleanup();
+      throw_tls("SSL_new");
+    }
+    // Retries gather the same queued bytes into a different staging buffer.
+    ::SSL_set_mode(ssl_, SSL_MODE_ENABLE_PARTIAL_WRITE |
+                             SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
+    ::SSL_set_fd(ssl_, fd);
+    ::SSL_set_tlsext_host_name(ssl_, url.net_loc.c_str());
+    if (options.verify_peer) {
+      ::SSL_set1_host(ssl_, url.net_loc.c_str());
+    }
+
+    for (;;) {
+      auto const result = ::SSL_connect(ssl_);
+      if (result == 1) {
+        break;
+      }
+      auto const error = ::SSL_get_error(ssl_, result);
+      auto const events = error == SSL_ERROR_WANT_READ    ? POLLIN
+                          : error == SSL_ERROR_WANT_WRITE ? POLLOUT
+                                                          : 0;
+      if (events == 0 || !wait_for(fd, events, remaining_ms(deadline))) {
+        cleanup();
+        throw_tls("TLS handshake with " + url.net_loc + " failed");
+      }
+    }
+    staging_.reserve(TLS_RECORD_SIZE);
+  }
+
+  ~TlsTransport() override {
+    if (ssl_ != nullptr) {
+      ::SSL_shutdown(ssl_);
+    }
+    cleanup();
+  }
+
+  TlsTransport(TlsTransport const&) = delete;
+  TlsTransport(TlsTransport&&) = delete;
+  TlsTransport& operator=(TlsTransport const&) = delete;
+  TlsTransport& operator=(TlsTransport&&) = delete;
+
+  std::size_t write(iovec const* iov, int count) override {
+    // TLS has no writev; coalesce into one record instead.
+    staging_.clear();
+    for (int i = 0; i < count && staging_.size() < TLS_RECORD_SIZE; ++i) {
+      auto const* const base = static_cast<std::byte const*>(iov[i].iov_base);
+      auto const size =
+          std::min(iov[i].iov_len, TLS_RECORD_SIZE - staging_.size());
+      staging_.insert(staging_.end(), base, base + size);
+    }
+    auto const written = ::SSL_write(ssl_, staging_.data(),
+                                     static_cast<int>(staging_.size()));
+    if (written > 0) {
+      return static_cast<std::size_t>(written);
+    }
+    auto const error = ::SSL_get_error(ssl_, written);
+    if (error == SSL_ERROR_WANT_READ || error == SSL_ERROR_WANT_WRITE) {
+      return 0;
+    }
+    throw_tls("SSL_write");
+  }
+
+  std::size_t read(std::byte* data, std::size_t size) override {
+    auto const count = ::SSL_read(ssl_, data, static_cast<int>(size));
+    if (count > 0) {
+      return static_cast<std::size_t>(count);
+    }
+    auto const error = ::SSL_get_error(ssl_, count);
+    if (error == SSL_ERROR_WANT_READ || error == SSL_ERROR_WANT_WRITE) {
+      return 0;
+    }
+    if (error == SSL_ERROR_ZERO_RETURN) {
+      throw std::system_error(std::make_error_code(std::errc::not_connected),
+                              "Connection closed by peer");
+    }
+    throw_tls("SSL_read");
+  }
+
+  [[nodiscard]] bool pending() const override {
+    return ::SSL_pending(ssl_) > 0;
+  }
+
+ private:
+  void cleanup() {
+    ::SSL_free(ssl_);
+    ssl_ = nullptr;
+    ::SSL_CTX_free(context_);
+    context_ = nullptr;
+  }
+
+  SSL_CTX* context_{nullptr};
+  SSL* ssl_{nullptr};
+  std::vector<std::byte> staging_;
+};
+
+}  // namespace
+
+CotEventFramer::CotEventFramer(std::size_t max_event_size)
+    : max_event_size_{max_event_size} {}
+
+std::byte* CotEventFramer::prepare(std::size_t min_size) {
+  // Move unconsumed bytes to the front before growing the buffer.
+  if (begin_ > 0 && buffer_.size() - end_ < min_size) {
+    std::memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+    end_ -= begin_;
+    scan_ -= begin_;
+    begin_ = 0;
+  }
+  if (buffer_.size() - end_ < min_size) {
+    buffer_.resize(end_ + min_size);
+  }
+  return reinterpret_cast<std::byte*>(buffer_.data() + end_);
+}
+
+void CotEventFramer::commit(std::size_t size) {
+  end_ = std::min(end_ + size, buffer_.size());
+}
+
+void CotEventFramer::append(std::byte const* data, std::size_t size) {
+  std::memcpy(prepare(size), data, size);
+  commit(size);
+}
+
+std::optional<std::string_view> CotEventFramer::next() {
+  while (begin_ < end_ && is_space(buffer_[begin_])) {
+    ++begin_;
+  }
+  auto const* const data = buffer_.data();
+  auto pos = std::max(scan_, begin_);
+  while (pos < end_) {
+    auto const* const open =
+        static_cast<char const*>(std::memchr(data + pos, '<', end_ - pos));
+    if (open == nullptr) {
+      pos = end_;
+      break;
+    }
+    pos = static_cast<std::size_t>(open - data);
+    if (end_ - pos < END_TAG.size()) {
+      // Possibly a partial </event>; look again once more bytes arrive.
+      break;
+    }
+    if (std::memcmp(open, END_TAG.data(), END_TAG.size()) == 0) {
+      auto const event_end = pos + END_TAG.size();
+      std::string_view const event{data + begin_, event_end - begin_};
+      begin_ = event_end;
+      scan_ = event_end;
+      return event;
+    }
+    ++pos;
+  }
+  scan_ = pos;
+  if (end_ - begin_ > max_event_size_) {
+    throw std::length_error("CoT event exceeds " +
+                            std::to_string(max_event_size_) +
+                            " bytes without </event>.");
+  }
+  return std::nullopt;
+}
+
+CotStream::CotStream(URL const& url, StreamOptions options)
+    : options_{std::move(options)} {
+  if (url.scheme != Scheme::TCP && url.scheme != Scheme::TLS) {
+    throw std::invalid_argument("CotStream requires a tcp or tls URL.");
+  }
+  options_.max_batch =
+      std::clamp<std::size_t>(options_.max_batch, 1, IOV_MAX);
+  auto const deadline = std::chrono::steady_clock::now() +
+                        std::chrono::milliseconds(options_.connect_timeout_ms);
+  auto const fd = connect_tcp(url, deadline);
+  if (url.scheme == Scheme::TLS) {
+    transport_ = std::make_unique<TlsTransport>(fd, url, options_, deadline);
+  } else {
+    transport_ = std::make_unique<Transport>(fd);
+  }
+  iovecs_.resize(options_.max_batch);
+}
+
+CotStream::~CotStream() = default;
+
+bool CotStream::enqueue(SharedBlob blob) {
+  // An empty payload would make writev return 0, which reads as a full
+  // socket.
+  if (!blob || blob->empty()) {
+    return false;
+  }
+  // An empty queue always takes one message, however large.
+  if (!queue_.empty() &&
+      queued_bytes_ + blob->size() > options_.max_queued_bytes) {
+    ++stats_.refused;
+    return false;
+  }
+  queued_bytes_ += blob->size();
+  queue_.push_back(std::move(blob));
+  return true;
+}
+
+bool CotStream::enqueue(std::vector<std::byte>&& payload) {
+  if (payload.empty()) {
+    return false;
+  }
+  if (!queue_.empty() &&
+      queued_bytes_ + payload.size() > options_.max_queued_bytes) {
+    ++stats_.refused;
+    return false;
+  }
+  return enqueue(
+      std::make_shared<std::vector<std::byte> const>(std::move(payload)));
+}
+
+bool CotStream::enqueue(std::byte const* data, std::size_t size) {
+  if (size == 0) {
+    return false;
+  }
+  if (!queue_.empty() && queued_bytes_ + size > options_.max_queued_bytes) {
+    ++stats_.refused;
+    return false;
+  }
+  return enqueue(std::vector<std::byte>(data, data + size));
+}
+
+bool CotStream::send(std::vector<std::byte>&& payload, int timeout_ms) {
+  auto const deadline =
+      std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+  for (;;) {
+    flush();
+    if (queue_.empty() ||
+        queued_bytes_ + payload.size() <= options_.max_queued_bytes) {
+      return enqueue(std::move(payload));
+    }
+    if (!wait_writable(remaining_ms(deadline))) {
+      ++stats_.refused;
+      return false;
+    }
+  }
+}
+
+std::size_t CotStream::flush() {
+  std::size_t total{0};
+  while (!queue_.empty()) {
+    auto const count = std::min(options_.max_batch, queue_.size());
+    for (std::size_t i = 0; i < count; ++i) {
+      auto const& payload = *queue_[i];
+      auto const offset = i == 0 ? front_offset_ : 0;
+      // writev never writes through iov_base.
+      iovecs_[i].iov_base =
+          const_cast<std::byte*>(payload.data() + offset);  // NOLINT
+      iovecs_[i].iov_len = payload.size() - offset;
+    }
+    auto written =
+        transport_->write(iovecs_.data(), static_cast<int>(count));
+    if (written == 0) {
+      break;
+    }
+    ++stats_.write_calls;
+    stats_.bytes_sent += written;
+    total += written;
+
+    while (written > 0) {
+      auto const remaining = queue_.front()->size() - front_offset_;
+      if (written < remaining) {
+        front_offset_ += written;
+        break;
+      }
+      written -= remaining;
+      queued_bytes_ -= queue_.front()->size();
+      queue_.pop_front();
+      front_offset_ = 0;
+      ++stats_.messages_sent;
+    }
+  }
+  return total;
+}
+
+bool CotStream::drain(int timeout_ms) {
+  auto const deadline =
+      std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+  flush();
+  while (!queue_.empty()) {
+    if (!wait_writable(remaining_ms(deadline))) {
+      return false;
+    }
+    flush();
+  }
+  return true;
+}
+
+std::size_t CotStream::receive(Handler const& on_event, int timeout_ms) {
+  std::size_t events{0};
+  auto const deliver = [this, &on_event, &events] {
+    while (auto const event = framer_.next()) {
+      ++events;
+      ++stats_.events_received;
+      on_event(*event);
+    }
+  };
+
+  auto const deadline =
+      std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+  deliver();
+  // Readable is not the same as an event: a read may end mid-event, or carry
+  // only TLS handshake records such as session tickets.
+  while (events == 0) {
+    if (!transport_->pending() &&
+        !wait_for(transport_->fd(), POLLIN, remaining_ms(deadline))) {
+      break;
+    }
+    for (;;) {
+      auto const count =
+          transport_->read(framer_.prepare(READ_SIZE), READ_SIZE);
+      framer_.commit(count);
+      stats_.bytes_received += count;
+      if (count < READ_SIZE && !transport_->pending()) {
+        break;
+      }
+      // Hand out what is complete before reading more, so a peer that never
+      // sends </event> hits the framer's limit instead of growing the
+      // buffer.
+      if (framer_.buffered() > framer_.max_event_size()) {
+        deliver();
+      }
+    }
+    deliver();
+    if (remaining_ms(deadline) == 0) {
+      break;
+    }
+  }
+  return events;
+}
+
+bool CotStream::wait_writable(int timeout_ms) {
+  return wait_for(transport_->fd(), POLLOUT, timeout_ms);
+}
+
+}  // namespace taktile
@@ -0,0 +1,278 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include "taktile/suppression.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <string>
+#include <thread>
+
+#include "taktile/datetime.hpp"
+#include "taktile/pipeline.hpp"
+
+namespace taktile {
+
+namespace {
+
+// Slots looked at for a uid before giving up on tracking it.
+constexpr std::size_t MAX_PROBES{16};
+constexpr int64_t NEVER{std::numeric_limits<int64_t>::min()};
+// Mean Earth radius in meters, per degree of arc.
+constexpr double METERS_PER_DEGREE{6371008.8 * M_PI / 180.0};
+
+uint64_t uid_key(std::string_view uid) {
+  auto const key = static_cast<uint64_t>(std::hash<std::string_view>{}(uid));
+  // 0 marks an empty slot.
+  return key == 0 ? 1 : key;
+}
+
+uint32_t type_key(std::string_view cot_type) {
+  auto const hash =
+      static_cast<uint64_t>(std::hash<std::string_view>{}(cot_type));
+  return static_cast<uint32_t>(hash ^ (hash >> 32));
+}
+
+constexpr bool known(double value) {
+  return value < DEFAULT_COT_VAL;
+}
+
+/// @brief Squared distance in meters between two points, on a local flat
+///        approximation that is accurate at the scale of a threshold
+double distance_squared(double lat1, double lon1, double hae1, double lat2,
+                        double lon2, double hae2) {
+  auto dlon = lon2 - lon1;
+  if (dlon > 180.0) {
+    dlon -= 360.0;
+  } else if (dlon < -180.0) {
+    dlon += 360.0;
+  }
+  auto const dy = (lat2 - lat1) * METERS_PER_DEGREE;
+  auto const dx =
+      dlon * METERS_PER_DEGREE * std::cos((lat1 + lat2) * M_PI / 360.0);
+  auto const dz = known(hae1) && known(hae2) ? hae2 - hae1 : 0.0;
+  return dx * dx + dy * dy + dz * dz;
+}
+
+}  // namespace
+
+/// @brief State of one uid, guarded by a sequence lock
+/// @details sequence is odd while a writer holds the slot.  Fields are
+///          relaxed atomics so lock-free readers never race; a reader
+///          retries if sequence changed while it read them.
+struct alignas(64) CotSuppressor::Slot {
+  std::atomic<uint64_t> key{0};
+  std::atomic<uint32_t> sequence{0};
+  std::atomic<uint32_t> type{0};
+  std::atomic<double> lat{0.0};
+  std::atomic<double> lon{0.0};
+  std::atomic<double> hae{DEFAULT_COT_VAL};
+  std::atomic<int64_t> sent{NEVER};
+  std::atomic<int64_t> stale{0};
+
+  /// @return the sequence to pass to unlock()
+  uint32_t lock() {
+    auto sequence_value = sequence.load(std::memory_order_relaxed);
+    while (true) {
+      if ((sequence_value & 1U) != 0) {
+        std::this_thread::yield();
+        sequence_value = sequence.load(std::memory_order_relaxed);
+        continue;
+      }
+      if (sequence.compare_exchange_weak(sequence_value, sequence_value + 1,
+                                         std::memory_order_acquire,
+                                         std::memory_order_relaxed)) {
+        // Keep the field stores below from becoming visible first.
+        std::atomic_thread_fence(std::memory_order_release);
+        return sequence_value + 1;
+      }
+    }
+  }
+
+  void unlock(uint32_t locked) {
+    sequence.store(locked + 1, std::memory_order_release);
+  }
+
+  /// @brief Whether the uid went stale, so the slot can take another
+  /// @details A slot claimed but not yet written is not reusable.
+  [[nodiscard]] bool reusable(int64_t now) const {
+    return sent.load(std::memory_order_relaxed) != NEVER &&
+           stale.load(std::memory_order_relaxed) < now;
+  }
+};
+
+CotSuppressor::CotSuppressor(SuppressionOptions options)
+    : options_{options},
+      mask_{ring_capacity(std::max<std::size_t>(options.capacity,
+                                                MAX_PROBES)) -
+            1},
+      slots_{std::make_unique<Slot[]>(mask_ + 1)},
+      suppressed_metric_{
+          metrics().counter("taktile_suppressed_total",
+                            "CoT updates dropped by CotSuppressor as "
+                            "unchanged")},
+      rate_limited_metric_{
+          metrics().counter("taktile_rate_limited_total",
+                            "Changed CoT updates dropped by CotSuppressor "
+                            "for coming too soon")} {}
+
+CotSuppressor::~CotSuppressor() = default;
+
+CotSuppressor::Slot* CotSuppressor::find(uint64_t key) const {
+  // Keys are never cleared, so an empty slot ends the search.
+  for (std::size_t probe = 0; probe < MAX_PROBES; ++probe) {
+    auto& slot = slots_[(key + probe) & mask_];
+    auto const found = slot.key.load(std::memory_order_acquire);
+    if (found == key) {
+      return &slot;
+    }
+    if (found == 0) {
+      return nullptr;
+    }
+  }
+  return nullptr;
+}
+
+CotSuppressor::Slot* CotSuppressor::claim(uint64_t key, int64_t now) {
+  Slot* expired{nullptr};
+  for (std::size_t probe = 0; probe < MAX_PROBES; ++probe) {
+    auto& slot = slots_[(key + probe) & mask_];
+    auto found = slot.key.load(std::memory_order_acquire);
+    if (found == 0 &&
+        slot.key.compare_exchange_strong(found, key,
+                                         std::memory_order_acq_rel)) {
+      return &slot;
+    }
+    // found now holds whoever filled the slot, possibly this uid.
+    if (found == key) {
+      return &slot;
+    }
+    if (slot.reusable(now) &&
+        (expired == nullptr ||
+         slot.stale.load(std::memory_order_relaxed) <
+             expired->stale.load(std::memory_order_relaxed))) {
+      expired = &slot;
+    }
+  }
+  if (expired == nullptr) {
+    return nullptr;
+  }
+  // Reuse the line that went stale longest ago.  Two threads racing to add
+  // the same uid can each take one; the spare goes stale and is reused.
+  auto const locked = expired->lock();
+  if (!expired->reusable(now)) {
+    expired->unlock(locked);
+    return nullptr;
+  }
+  expired->key.store(key, std::memory_order_release);
+  expired->sent.store(NEVER, std::memory_order_relaxed);
+  expired->unlock(locked);
+  return expired;
+}
+
+bool CotSuppressor::admit(CotType const& cot) {
+  return admit(cot, now_ms());
+}
+
+bool CotSuppressor::admit(CotType const& cot, int64_t now) {
+  auto const key = uid_key(cot.uid);
+  Slot* slot{nullptr};
+  uint32_t locked{0};
+  while (true) {
+    slot = claim(key, now);
+    if (slot == nullptr) {
+      untracked_.add();
+      passed_.add();
+      return true;
+    }
+    locked = slot->lock();
+    // The line may have been reused for another uid before it was locked.
+    if (slot->key.load(std::memory_order_relaxed) == key) {
+      break;
+    }
+    slot->unlock(locked);
+  }
+
+  auto const type = type_key(cot.cot_type);
+  auto const sent = slot->sent.load(std::memory_order_relaxed);
+  if (sent != NEVER) {
+    auto threshold = options_.min_distance_m;
+    if (known(cot.ce)) {
+      threshold = std::max(threshold, options_.ce_fraction * cot.ce);
+    }
+    auto const changed =
+        type != slot->type.load(std::memory_order_relaxed) ||
+        distance_squared(slot->lat.load(std::memory_order_relaxed),
+                         slot->lon.load(std::memory_order_relaxed),
+                         slot->hae.load(std::memory_order_relaxed), cot.lat,
+                         cot.lon, cot.hae) > threshold * threshold;
+    auto const due =
+        now - sent >= options_.max_interval_ms ||
+        now >= slot->stale.load(std::memory_order_relaxed) -
+                   options_.stale_margin_ms;
+    if (!changed && !due) {
+      slot->unlock(locked);
+      suppressed_.add();
+      suppressed_metric_.add();
+      return false;
+    }
+    if (now - sent < options_.min_interval_ms) {
+      slot->unlock(locked);
+      rate_limited_.add();
+      rate_limited_metric_.add();
+      return false;
+    }
+  }
+  slot->type.store(type, std::memory_order_relaxed);
+  slot->lat.store(cot.lat, std::memory_order_relaxed);
+  slot->lon.store(cot.lon, std::memory_order_relaxed);
+  slot->hae.store(cot.hae, std::memory_order_relaxed);
+  slot->sent.store(now, std::memory_order_relaxed);
+  slot->stale.store(cot.stale, std::memory_order_relaxed);
+  slot->unlock(locked);
+  passed_.add();
+  return true;
+}
+
+std::optional<SuppressedState> CotSuppressor::last_sent(
+    std::string_view uid) const {
+  auto const key = uid_key(uid);
+  auto* const slot = find(key);
+  if (slot == nullptr) {
+    return std::nullopt;
+  }
+  while (true) {
+    auto const before = slot->sequence.load(std::memory_order_acquire);
+    if ((before & 1U) != 0) {
+      std::this_thread::yield();
+      continue;
+    }
+    auto const found = slot->key.load(std::memory_order_relaxed);
+    SuppressedState state;
+    state.lat = slot->lat.load(std::memory_order_relaxed);
+    state.lon = slot->lon.load(std::memory_order_relaxed);
+    state.hae = slot->hae.load(std::memory_order_relaxed);
+    state.sent = slot->sent.load(std::memory_order_relaxed);
+    state.stale = slot->stale.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot->sequence.load(std::memory_order_relaxed) != before) {
+      continue;
+    }
+    if (found != key || state.sent == NEVER) {
+      return std::nullopt;
+    }
+    return state;
+  }
+}
+
+SuppressionStats CotSuppressor::stats() const {
+  SuppressionStats stats;
+  stats.passed = passed_.value();
+  stats.suppressed = suppressed_.value();
+  stats.rate_limited = rate_limited_.value();
+  stats.untracked = untracked_.value();
+  return stats;
+}
+
+}  // namespace taktile
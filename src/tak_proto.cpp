@@ -0,0 +1,490 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include "taktile/tak_proto.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "taktile/xml_parser.hpp"
+
+namespace taktile {
+
+namespace {
+
+// Protobuf wire types.
+constexpr uint32_t VARINT{0};
+constexpr uint32_t FIXED64{1};
+constexpr uint32_t LENGTH_DELIMITED{2};
+constexpr uint32_t FIXED32{5};
+
+// TakMessage (takmessage.proto).
+constexpr uint32_t TAK_MESSAGE_COT_EVENT{2};
+
+// CotEvent (cotevent.proto).
+constexpr uint32_t COT_TYPE{1};
+constexpr uint32_t COT_UID{5};
+constexpr uint32_t COT_SEND_TIME{6};
+constexpr uint32_t COT_START_TIME{7};
+constexpr uint32_t COT_STALE_TIME{8};
+constexpr uint32_t COT_HOW{9};
+constexpr uint32_t COT_LAT{10};
+constexpr uint32_t COT_LON{11};
+constexpr uint32_t COT_HAE{12};
+constexpr uint32_t COT_CE{13};
+constexpr uint32_t COT_LE{14};
+
+// Written as the XML writer writes it.
+constexpr std::string_view HOW{"m-g"};
+constexpr std::size_t MESH_HEADER_SIZE{3};
+constexpr std::size_t MAX_VARINT_SIZE{10};
+
+constexpr uint32_t tag(uint32_t field, uint32_t wire_type) {
+  return field << 3 | wire_type;
+}
+
+constexpr std::size_t varint_size(uint64_t value) {
+  std::size_t size{1};
+  while (value >= 0x80) {
+    value >>= 7;
+    ++size;
+  }
+  return size;
+}
+
+uint64_t bits(double value) {
+  uint64_t out{0};
+  std::memcpy(&out, &value, sizeof(out));
+  return out;
+}
+
+// proto3 leaves out fields that hold their default (0, 0.0 or empty).
+std::size_t string_field_size(std::string_view value) {
+  return value.empty() ? 0 : 1 + varint_size(value.size()) + value.size();
+}
+
+std::size_t varint_field_size(uint64_t value) {
+  return value == 0 ? 0 : 1 + varint_size(value);
+}
+
+std::size_t double_field_size(double value) {
+  return bits(value) == 0 ? 0 : 1 + sizeof(uint64_t);
+}
+
+std::size_t event_size(CotType const& cot) {
+  return string_field_size(cot.cot_type) + string_field_size(cot.uid) +
+         varint_field_size(static_cast<uint64_t>(cot.time)) +
+         varint_field_size(static_cast<uint64_t>(cot.start)) +
+         varint_field_size(static_cast<uint64_t>(cot.stale)) +
+         string_field_size(HOW) + double_field_size(cot.lat) +
+         double_field_size(cot.lon) + double_field_size(cot.hae) +
+         double_field_size(cot.ce) + double_field_size(cot.le);
+}
+
+/// @brief Appends protobuf fields to a buffer already checked to be large
+///        enough
+class ProtoWriter {
+ public:
+  explicit ProtoWriter(std::byte* out) : out_{out} {}
+
+  ProtoWriter& byte(std::byte value) {
+    *out_++ = value;
+    return *this;
+  }
+
+  ProtoWriter& varint(uint64_t value) {
+    while (value >= 0x80) {
+      *out_++ = static_cast<std::byte>(value | 0x80);
+      value >>= 7;
+    }
+    *out_++ = static_cast<std::byte>(value);
+    return *this;
+  }
+
+  ProtoWriter& string_field(uint32_t field, std::string_view value) {
+    if (!value.empty()) {
+      varint(tag(field, LENGTH_DELIMITED)).varint(value.size());
+      std::memcpy(out_, value.data(), value.size());
+      out_ += value.size();
+    }
+    return *this;
+  }
+
+  ProtoWriter& varint_field(uint32_t field, uint64_t value) {
+    if (value != 0) {
+      varint(tag(field, VARINT)).varint(value);
+    }
+    return *this;
+  }
+
+  ProtoWriter& double_field(uint32_t field, double value) {
+    // Little-endian, as are the hosts this library targets.
+    if (auto const raw = bits(value); raw != 0) {
+      varint(tag(field, FIXED64));
+      std::memcpy(out_, &raw, sizeof(raw));
+      out_ += sizeof(raw);
+    }
+    return *this;
+  }
+
+ private:
+  std::byte* out_;
+};
+
+/// @brief Reads protobuf fields, throwing on anything truncated
+class ProtoReader {
+ public:
+  explicit ProtoReader(std::string_view data) : data_{data} {}
+
+  [[nodiscard]] bool done() const {
+    return pos_ == data_.size();
+  }
+
+  /// @brief Everything not read yet
+  [[nodiscard]] std::string_view rest() const {
+    return data_.substr(pos_);
+  }
+
+  uint64_t varint() {
+    uint64_t value{0};
+    for (std::size_t i = 0; i < MAX_VARINT_SIZE; ++i) {
+      if (pos_ == data_.size()) {
+        throw std::invalid_argument("Truncated protobuf varint.");
+      }
+      auto const byte = static_cast<uint8_t>(data_[pos_++]);
+      value |= static_cast<uint64_t>(byte & 0x7f) << (7 * i);
+      if ((byte & 0x80) == 0) {
+        return value;
+      }
+    }
+    throw std::invalid_argument("Protobuf varint is too long.");
+  }
+
+  double fixed64() {
+    auto const raw = take(sizeof(uint64_t));
+    double value{0.0};
+    std::memcpy(&value, raw.data(), sizeof(value));
+    return value;
+  }
+
+  std::string_view bytes() {
+    return take(varint());
+  }
+
+  /// @brief Skip the value of a field that is not decoded
+  void skip(uint32_t wire_type) {
+    switch (wire_type) {
+      case VARINT:
+        varint();
+        break;
+      case FIXED64:
+        take(sizeof(uint64_t));
+        break;
+      case LENGTH_DELIMITED:
+        bytes();
+        break;
+      case FIXED32:
+        take(sizeof(uint32_t));
+        break;
+      default:
+        throw std::invalid_argument("Unsupported protobuf wire type " +
+                                    std::to_string(wire_type) + ".");
+    }
+  }
+
+ private:
+  std::string_view take(uint64_t size) {
+    if (size > data_.size() - pos_) {
+      throw std::invalid_argument("Truncated protobuf field.");
+    }
+    auto const value = data_.substr(pos_, size);
+    pos_ += size;
+    return value;
+  }
+
+  std::string_view data_;
+  std::size_t pos_{0};
+};
+
+CotType read_event(std::string_view event) {
+  auto cot = CotType(std::string{});
+  cot.cot_type.clear();
+  cot.lat = cot.lon = cot.hae = cot.ce = cot.le = 0.0;
+  cot.time = cot.start = cot.stale = 0;
+  ProtoReader reader{event};
+  while (!reader.done()) {
+    auto const key = reader.varint();
+    auto const wire_type = static_cast<uint32_t>(key & 0x7);
+    auto const field = key >> 3;
+    if (field == COT_TYPE && wire_type == LENGTH_DELIMITED) {
+      cot.cot_type = reader.bytes();
+    } else if (field == COT_UID && wire_type == LENGTH_DELIMITED) {
+      cot.uid = reader.bytes();
+    } else if (field == COT_SEND_TIME && wire_type == VARINT) {
+      cot.time = static_cast<int64_t>(reader.varint());
+    } else if (field == COT_START_TIME && wire_type == VARINT) {
+      cot.start = static_cast<int64_t>(reader.varint());
+    } else if (field == COT_STALE_TIME && wire_type == VARINT) {
+      cot.stale = static_cast<int64_t>(reader.varint());
+    } else if (field >= COT_LAT && field <= COT_LE && wire_type == FIXED64) {
+      auto const value = reader.fixed64();
+      switch (field) {
+        case COT_LAT:
+          cot.lat = value;
+          break;
+        case COT_LON:
+          cot.lon = value;
+          break;
+        case COT_HAE:
+          cot.hae = value;
+          break;
+        case COT_CE:
+          cot.ce = value;
+          break;
+        default:
+          cot.le = value;
+          break;
+      }
+    } else {
+      reader.skip(wire_type);
+    }
+  }
+  if (cot.uid.empty()) {
+    throw std::invalid_argument("UID attribute is empty.");
+  }
+  try {
+    CotType::validate(cot);
+  } catch (std::invalid_argument const& e) {
+    throw std::invalid_argument("CoT validation failed: " +
+                                std::string(e.what()));
+  }
+  return cot;
+}
+
+}  // namespace
+
+TakFraming tak_framing(URL const& url) {
+  return url.scheme == Scheme::TCP || url.scheme == Scheme::TLS
+             ? TakFraming::STREAM
+             : TakFraming::MESH;
+}
+
+TakProtocol detect_protocol(std::byte const* data, std::size_t size) {
+  return size > 0 && data[0] == TAK_MAGIC ? TakProtocol::PROTOBUF
+                                          : TakProtocol::XML;
+}
+
+std::size_t write_cot_proto(CotType const& cot, TakFraming framing,
+                            std::byte* buffer, std::size_t capacity) {
+  auto const event = event_size(cot);
+  auto const message = 1 + varint_size(event) + event;
+  auto const header = framing == TakFraming::MESH
+                          ? MESH_HEADER_SIZE
+                          : 1 + varint_size(message);
+  auto const total = header + message;
+  if (total > capacity) {
+    throw_oversize(capacity);
+  }
+
+  ProtoWriter writer{buffer};
+  if (framing == TakFraming::MESH) {
+    writer.byte(TAK_MAGIC)
+        .byte(std::byte{TAK_PROTOCOL_VERSION})
+        .byte(TAK_MAGIC);
+  } else {
+    writer.byte(TAK_MAGIC).varint(message);
+  }
+  writer.varint(tag(TAK_MESSAGE_COT_EVENT, LENGTH_DELIMITED))
+      .varint(event)
+      .string_field(COT_TYPE, cot.cot_type)
+      .string_field(COT_UID, cot.uid)
+      .varint_field(COT_SEND_TIME, static_cast<uint64_t>(cot.time))
+      .varint_field(COT_START_TIME, static_cast<uint64_t>(cot.start))
+      .varint_field(COT_STALE_TIME, static_cast<uint64_t>(cot.stale))
+      .string_field(COT_HOW, HOW)
+      .double_field(COT_LAT, cot.lat)
+      .double_field(COT_LON, cot.lon)
+      .double_field(COT_HAE, cot.hae)
+      .double_field(COT_CE, cot.ce)
+      .double_field(COT_LE, cot.le);
+  return total;
+}
+
+CotType read_cot_proto(std::string_view frame, TakFraming framing) {
+  if (frame.empty() || static_cast<std::byte>(frame[0]) != TAK_MAGIC) {
+    throw std::invalid_argument("Not a TAK protocol message.");
+  }
+  ProtoReader header{frame.substr(1)};
+  std::string_view message;
+  if (framing == TakFraming::MESH) {
+    if (frame.size() < MESH_HEADER_SIZE ||
+        static_cast<std::byte>(frame[2]) != TAK_MAGIC) {
+      throw std::invalid_argument("Malformed TAK protocol mesh header.");
+    }
+    if (static_cast<uint8_t>(frame[1]) != TAK_PROTOCOL_VERSION) {
+      throw std::invalid_argument(
+          "Unsupported TAK protocol version " +
+          std::to_string(static_cast<uint8_t>(frame[1])) + ".");
+    }
+    message = frame.substr(MESH_HEADER_SIZE);
+  } else {
+    auto const size = header.varint();
+    message = header.rest();
+    if (message.size() != size) {
+      throw std::invalid_argument("TAK protocol frame length mismatch.");
+    }
+  }
+
+  ProtoReader reader{message};
+  std::optional<std::string_view> event;
+  while (!reader.done()) {
+    auto const key = reader.varint();
+    auto const wire_type = static_cast<uint32_t>(key & 0x7);
+    if (key >> 3 == TAK_MESSAGE_COT_EVENT && wire_type == LENGTH_DELIMITED) {
+      event = reader.bytes();
+    } else {
+      reader.skip(wire_type);
+    }
+  }
+  if (!event) {
+    throw std::invalid_argument("TakMessage has no cotEvent.");
+  }
+  return read_event(*event);
+}
+
+CotProtoSerializer::CotProtoSerializer(TakFraming framing)
+    : CotProtoSerializer(framing, framing == TakFraming::MESH
+                                      ? MAX_UDP_BLOB_SIZE
+                                      : MAX_TCP_BLOB_SIZE) {}
+
+CotProtoSerializer::CotProtoSerializer(TakFraming framing,
+                                       std::size_t max_blob_size)
+    : framing_{framing}, max_blob_size_{max_blob_size} {}
+
+std::vector<std::byte> CotProtoSerializer::serialize(CotType const& entity) {
+  // As CotDirectXmlSerializer: encode into per-thread scratch space so the
+  // only allocation is the returned vector itself.
+  thread_local std::array<std::byte, MAX_TCP_BLOB_SIZE> scratch;
+  auto const size = serialize_into(entity, scratch.data(), scratch.size());
+  return {scratch.begin(), scratch.begin() + static_cast<std::ptrdiff_t>(size)};
+}
+
+CotType CotProtoSerializer::deserialize(std::vector<std::byte> const& _blob) {
+  return deserialize_from(_blob.data(), _blob.size());
+}
+
+std::size_t CotProtoSerializer::serialize_into(CotType const& entity,
+                                               std::byte* buffer,
+                                               std::size_t capacity) {
+  return write_cot_proto(entity, framing_, buffer,
+                         std::min(capacity, max_blob_size_));
+}
+
+CotType CotProtoSerializer::deserialize_from(std::byte const* data,
+                                             std::size_t size) {
+  std::string_view const blob{reinterpret_cast<char const*>(data), size};
+  if (detect_protocol(data, size) == TakProtocol::XML) {
+    return read_cot_xml(blob);
+  }
+  return read_cot_proto(blob, framing_);
+}
+
+TakStreamFramer::TakStreamFramer(std::size_t max_message_size)
+    : max_message_size_{max_message_size} {}
+
+void TakStreamFramer::append(std::byte const* data, std::size_t size) {
+  // Drop consumed bytes before growing the buffer.
+  if (begin_ > 0 && buffer_.capacity() - buffer_.size() < size) {
+    buffer_.erase(buffer_.begin(),
+                  buffer_.begin() + static_cast<std::ptrdiff_t>(begin_));
+    begin_ = 0;
+  }
+  auto const* bytes = reinterpret_cast<char const*>(data);
+  buffer_.insert(buffer_.end(), bytes, bytes + size);
+}
+
+std::optional<std::string_view> TakStreamFramer::next() {
+  std::string_view const pending{buffer_.data() + begin_, buffered()};
+  if (pending.empty()) {
+    return std::nullopt;
+  }
+  if (static_cast<std::byte>(pending[0]) != TAK_MAGIC) {
+    throw std::invalid_argument("Not a TAK protocol stream.");
+  }
+  // Decode the length by hand, since it may not have fully arrived.
+  uint64_t size{0};
+  std::size_t pos{1};
+  for (std::size_t shift = 0;; shift += 7) {
+    if (pos == pending.size()) {
+      return std::nullopt;
+    }
+    if (pos > MAX_VARINT_SIZE) {
+      throw std::invalid_argument("Malformed TAK protocol frame length.");
+    }
+    auto const byte = static_cast<uint8_t>(pending[pos++]);
+    size |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) {
+      break;
+    }
+  }
+  if (size > max_message_size_) {
+    throw std::length_error("TAK protocol message of " +
+                            std::to_string(size) + " bytes exceeds " +
+                            std::to_string(max_message_size_) + " bytes.");
+  }
+  if (pending.size() - pos < size) {
+    return std::nullopt;
+  }
+  auto const frame = pending.substr(0, pos + size);
+  begin_ += frame.size();
+  return frame;
+}
+
+TakProtocolNegotiator::TakProtocolNegotiator(TakProtocol preferred)
+    : preferred_{preferred},
+      xml_{std::make_shared<CotDirectXmlSerializer>()},
+      mesh_{std::make_shared<CotProtoSerializer>(TakFraming::MESH,
+                                                 MAX_UDP_BLOB_SIZE)},
+      stream_{std::make_shared<CotProtoSerializer>(TakFraming::STREAM,
+                                                   MAX_TCP_BLOB_SIZE)} {}
+
+TakProtocol TakProtocolNegotiator::protocol(URL const& url) const {
+  std::lock_guard const lock{mutex_};
+  auto const found = peers_.find(to_string(url));
+  return found == peers_.end() ? TakProtocol::XML : found->second;
+}
+
+std::shared_ptr<CotSerializer> TakProtocolNegotiator::serializer(
+    URL const& url) const {
+  if (protocol(url) == TakProtocol::XML) {
+    return xml_;
+  }
+  return tak_framing(url) == TakFraming::STREAM ? stream_ : mesh_;
+}
+
+TakProtocol TakProtocolNegotiator::observe(URL const& url,
+                                           std::byte const* data,
+                                           std::size_t size) {
+  auto const received = detect_protocol(data, size);
+  auto supported = received == TakProtocol::PROTOBUF;
+  if (!supported) {
+    std::string_view const xml{reinterpret_cast<char const*>(data), size};
+    auto const advert = xml.find("<TakProtocolSupport");
+    supported = advert != std::string_view::npos &&
+                xml.find("version=\"1\"", advert) != std::string_view::npos;
+  }
+  if (supported && preferred_ == TakProtocol::PROTOBUF) {
+    set(url, TakProtocol::PROTOBUF);
+  }
+  return received;
+}
+
+void TakProtocolNegotiator::set(URL const& url, TakProtocol protocol) {
+  std::lock_guard const lock{mutex_};
+  peers_[to_string(url)] = protocol;
+}
+
+}  // namespace taktile
@@ -0,0 +1,304 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include "taktile/track_store.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include "taktile/datetime.hpp"
+
+namespace taktile {
+
+namespace {
+
+constexpr int LEVELS{4};
+constexpr int SLOT_BITS{6};
+constexpr int64_t SLOTS{int64_t{1} << SLOT_BITS};
+constexpr int64_t SLOT_MASK{SLOTS - 1};
+// Deadlines further out are parked at the top level and rescheduled when
+// they come around.
+constexpr int64_t HORIZON{int64_t{1} << (SLOT_BITS * LEVELS)};
+// Tracks per snapshot chunk: small enough that an update copies little on
+// publish, large enough that the chunk pointers of a big shard stay few.
+constexpr std::size_t CHUNK_SIZE{256};
+
+constexpr int64_t floor_div(int64_t a, int64_t b) {
+  return a / b - static_cast<int64_t>((a % b != 0) && ((a < 0) != (b < 0)));
+}
+
+constexpr int64_t ceil_div(int64_t a, int64_t b) {
+  return -floor_div(-a, b);
+}
+
+}  // namespace
+
+/// @brief Tracks whose uid hashes to one partition, with their timer wheel
+class TrackStore::Shard {
+ public:
+  Shard(int64_t tick_ms, int64_t now_tick)
+      : tick_ms_{tick_ms},
+        now_tick_{now_tick},
+        snapshot_{
+            std::make_shared<std::vector<TrackSnapshot::Chunk> const>()} {}
+
+  bool upsert(Track track) {
+    std::lock_guard<std::mutex> const lock{mutex_};
+    auto [it, inserted] = entries_.try_emplace(track->uid);
+    auto& entry = it->second;
+    if (inserted) {
+      entry.index = dense_.size();
+      dense_.push_back(&entry);
+    } else {
+      if (track->time < entry.track->time) {
+        return false;
+      }
+      unlink(entry);
+    }
+    // A track that arrives already stale goes on the next tick.
+    entry.tick = std::max(ceil_div(track->stale, tick_ms_), now_tick_ + 1);
+    entry.track = std::move(track);
+    schedule(entry);
+    mark(entry.index);
+    size_.store(entries_.size(), std::memory_order_relaxed);
+    return true;
+  }
+
+  Track find(std::string const& uid) const {
+    std::lock_guard<std::mutex> const lock{mutex_};
+    auto const it = entries_.find(uid);
+    return it == entries_.end() ? nullptr : it->second.track;
+  }
+
+  /// @brief Advance the wheel to now, removing every track that is due,
+  ///        then republish the chunks that changed
+  std::size_t expire(int64_t now) {
+    std::lock_guard<std::mutex> const lock{mutex_};
+    auto const removed = advance(floor_div(now, tick_ms_));
+    size_.store(entries_.size(), std::memory_order_relaxed);
+    publish();
+    return removed;
+  }
+
+  [[nodiscard]] TrackSnapshot::Shard snapshot() const {
+    return std::atomic_load(&snapshot_);
+  }
+
+  [[nodiscard]] std::size_t size() const {
+    return size_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct Entry {
+    Track track;
+    int64_t tick{0};
+    std::size_t slot{0};
+    // Position in dense_.
+    std::size_t index{0};
+    Entry* prev{nullptr};
+    Entry* next{nullptr};
+  };
+
+  /// @brief Note that the chunk holding a position of dense_ changed
+  void mark(std::size_t index) {
+    auto const chunk = index / CHUNK_SIZE;
+    if (chunk >= chunk_dirty_.size()) {
+      chunk_dirty_.resize(chunk + 1, false);
+    }
+    if (!chunk_dirty_[chunk]) {
+      chunk_dirty_[chunk] = true;
+      dirty_chunks_.push_back(chunk);
+    }
+  }
+
+  /// @brief Drop an entry, moving the last track into its place in dense_
+  void remove(Entry& entry) {
+    auto* const last = dense_.back();
+    dense_[entry.index] = last;
+    last->index = entry.index;
+    dense_.pop_back();
+    mark(entry.index);
+    mark(dense_.size());
+    // The key must outlive the erase, so hold the track until it returns.
+    auto const track = std::move(entry.track);
+    entries_.erase(track->uid);
+  }
+
+  /// @brief Copy the changed chunks and swap in a new snapshot
+  void publish() {
+    if (dirty_chunks_.empty()) {
+      return;
+    }
+    chunks_.resize((dense_.size() + CHUNK_SIZE - 1) / CHUNK_SIZE);
+    for (auto const chunk : dirty_chunks_) {
+      chunk_dirty_[chunk] = false;
+      if (chunk >= chunks_.size()) {
+        continue;
+      }
+      auto const begin = chunk * CHUNK_SIZE;
+      auto const end = std::min(begin + CHUNK_SIZE, dense_.size());
+      std::vector<Track> tracks;
+      tracks.reserve(end - begin);
+      for (auto i = begin; i < end; ++i) {
+        tracks.push_back(dense_[i]->track);
+      }
+      chunks_[chunk] =
+          std::make_shared<std::vector<Track> const>(std::move(tracks));
+    }
+    dirty_chunks_.clear();
+    std::atomic_store(
+        &snapshot_,
+        std::make_shared<std::vector<TrackSnapshot::Chunk> const>(chunks_));
+  }
+
+  void schedule(Entry& entry) {
+    auto const delta = std::min(entry.tick - now_tick_, HORIZON - 1);
+    auto const target = now_tick_ + delta;
+    int level{0};
+    while (delta >= (int64_t{1} << (SLOT_BITS * (level + 1)))) {
+      ++level;
+    }
+    entry.slot = static_cast<std::size_t>(
+        level * SLOTS + ((target >> (SLOT_BITS * level)) & SLOT_MASK));
+    auto& head = wheel_.at(entry.slot);
+    entry.prev = nullptr;
+    entry.next = head;
+    if (head != nullptr) {
+      head->prev = &entry;
+    }
+    head = &entry;
+  }
+
+  void unlink(Entry& entry) {
+    if (entry.prev != nullptr) {
+      entry.prev->next = entry.next;
+    } else {
+      wheel_.at(entry.slot) = entry.next;
+    }
+    if (entry.next != nullptr) {
+      entry.next->prev = entry.prev;
+    }
+  }
+
+  /// @brief Detach and return the list in a slot
+  Entry* take(std::size_t slot) {
+    auto* const head = wheel_.at(slot);
+    wheel_.at(slot) = nullptr;
+    return head;
+  }
+
+  std::size_t advance(int64_t to) {
+    std::size_t removed{0};
+    while (now_tick_ < to && !entries_.empty()) {
+      ++now_tick_;
+      // Entering a new block of a level moves its tracks one level down.
+      for (int level = 1; level < LEVELS; ++level) {
+        if (((now_tick_ >> (SLOT_BITS * (level - 1))) & SLOT_MASK) != 0) {
+          break;
+        }
+        auto const slot = static_cast<std::size_t>(
+            level * SLOTS + ((now_tick_ >> (SLOT_BITS * level)) & SLOT_MASK));
+        for (auto* entry = take(slot); entry != nullptr;) {
+          auto* const next = entry->next;
+          schedule(*entry);
+          entry = next;
+        }
+      }
+      for (auto* entry = take(static_cast<std::size_t>(now_tick_ & SLOT_MASK));
+           entry != nullptr;) {
+        auto* const next = entry->next;
+        if (entry->tick <= now_tick_) {
+          remove(*entry);
+          ++removed;
+        } else {
+          schedule(*entry);
+        }
+        entry = next;
+      }
+    }
+    now_tick_ = std::max(now_tick_, to);
+    return removed;
+  }
+
+  int64_t tick_ms_;
+  int64_t now_tick_;
+  mutable std::mutex mutex_;
+  std::unordered_map<std::string, Entry> entries_;
+  std::array<Entry*, LEVELS * SLOTS> wheel_{};
+  // Every entry, densely, so chunks are runs of positions.
+  std::vector<Entry*> dense_;
+  // The last published chunks and which have changed since.
+  std::vector<TrackSnapshot::Chunk> chunks_;
+  std::vector<bool> chunk_dirty_;
+  std::vector<std::size_t> dirty_chunks_;
+  std::atomic<std::size_t> size_{0};
+  TrackSnapshot::Shard snapshot_;
+};
+
+TrackSnapshot::TrackSnapshot(std::vector<Shard> shards)
+    : shards_{std::move(shards)} {}
+
+std::size_t TrackSnapshot::size() const {
+  std::size_t total{0};
+  for (auto const& shard : shards_) {
+    for (auto const& chunk : *shard) {
+      total += chunk->size();
+    }
+  }
+  return total;
+}
+
+TrackStore::TrackStore(TrackStoreOptions options) : options_{options} {
+  options_.shards = std::max<std::size_t>(options_.shards, 1);
+  options_.tick_ms = std::max<int64_t>(options_.tick_ms, 1);
+  auto const now_tick = floor_div(now_ms(), options_.tick_ms);
+  for (std::size_t i = 0; i < options_.shards; ++i) {
+    shards_.push_back(std::make_unique<Shard>(options_.tick_ms, now_tick));
+  }
+}
+
+TrackStore::~TrackStore() = default;
+
+bool TrackStore::upsert(CotType cot) {
+  auto& shard = shard_for(cot.uid);
+  return shard.upsert(std::make_shared<CotType const>(std::move(cot)));
+}
+
+Track TrackStore::find(std::string const& uid) const {
+  return shard_for(uid).find(uid);
+}
+
+std::size_t TrackStore::expire(int64_t now) {
+  std::size_t removed{0};
+  for (auto& shard : shards_) {
+    removed += shard->expire(now);
+  }
+  return removed;
+}
+
+TrackSnapshot TrackStore::snapshot() const {
+  std::vector<TrackSnapshot::Shard> shards;
+  shards.reserve(shards_.size());
+  for (auto const& shard : shards_) {
+    shards.push_back(shard->snapshot());
+  }
+  return TrackSnapshot{std::move(shards)};
+}
+
+std::size_t TrackStore::size() const {
+  std::size_t total{0};
+  for (auto const& shard : shards_) {
+    total += shard->size();
+  }
+  return total;
+}
+
+TrackStore::Shard& TrackStore::shard_for(std::string const& uid) const {
+  return *shards_[std::hash<std::string>{}(uid) % shards_.size()];
+}
+
+}  // namespace taktile
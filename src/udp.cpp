@@ -0,0 +1,427 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include "taktile/udp.hpp"
+
+#include <arpa/inet.h>
+#include <net/if.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+namespace taktile {
+
+namespace {
+
+[[noreturn]] void throw_errno(std::string const& what) {
+  throw std::system_error(errno, std::generic_category(), what);
+}
+
+void set_option(int fd, int level, int name, void const* value,
+                socklen_t size, std::string const& what) {
+  if (::setsockopt(fd, level, name, value, size) != 0) {
+    throw_errno(what);
+  }
+}
+
+/// @brief Fill in the interface part of a multicast request
+/// @param interface IPv4 address or interface name; empty for the default
+void set_interface(std::string const& interface, ip_mreqn& request) {
+  if (interface.empty() ||
+      ::inet_pton(AF_INET, interface.c_str(), &request.imr_address) == 1) {
+    return;
+  }
+  request.imr_ifindex = static_cast<int>(::if_nametoindex(interface.c_str()));
+  if (request.imr_ifindex == 0) {
+    throw std::invalid_argument("Unknown multicast interface: " + interface);
+  }
+}
+
+}  // namespace
+
+sockaddr_in resolve_ipv4(URL const& url) {
+  addrinfo hints{};
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_DGRAM;
+  addrinfo* result{nullptr};
+  auto const status =
+      ::getaddrinfo(url.net_loc.c_str(), nullptr, &hints, &result);
+  if (status != 0 || result == nullptr) {
+    throw std::invalid_argument("Unable to resolve " + url.net_loc + ": " +
+                                ::gai_strerror(status));
+  }
+  sockaddr_in address{};
+  std::memcpy(&address, result->ai_addr, sizeof(address));
+  ::freeaddrinfo(result);
+  address.sin_port = htons(url.port);
+  return address;
+}
+
+CotUdpSender::CotUdpSender(URL const& url, UdpSenderOptions options)
+    : options_{std::move(options)},
+      sent_metric_{metrics().counter("taktile_udp_sent_total",
+                                     "Datagrams sent by CotUdpSender")},
+      dropped_metric_{metrics().counter("taktile_udp_dropped_total",
+                                        "Datagrams dropped by CotUdpSender")} {
+  if (url.scheme != Scheme::UDP && url.scheme != Scheme::UDP_BROADCAST &&
+      url.scheme != Scheme::UDP_WRITE_ONLY) {
+    throw std::invalid_argument("CotUdpSender requires a udp URL.");
+  }
+  options_.batch_size = std::max<std::size_t>(options_.batch_size, 1);
+  options_.queue_capacity = std::max<std::size_t>(options_.queue_capacity, 1);
+  destination_ = resolve_ipv4(url);
+
+  fd_ = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+  if (fd_ < 0) {
+    throw_errno("socket");
+  }
+  try {
+    if (url.scheme == Scheme::UDP_BROADCAST) {
+      int const enable{1};
+      set_option(fd_, SOL_SOCKET, SO_BROADCAST, &enable, sizeof(enable),
+                 "SO_BROADCAST");
+    }
+    if (IN_MULTICAST(ntohl(destination_.sin_addr.s_addr))) {
+      int const ttl{options_.ttl};
+      set_option(fd_, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl),
+                 "IP_MULTICAST_TTL");
+      int const loop{options_.loopback ? 1 : 0};
+      set_option(fd_, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop),
+                 "IP_MULTICAST_LOOP");
+      if (!options_.interface.empty()) {
+        ip_mreqn request{};
+        set_interface(options_.interface, request);
+        set_option(fd_, IPPROTO_IP, IP_MULTICAST_IF, &request,
+                   sizeof(request), "IP_MULTICAST_IF");
+      }
+    }
+  } catch (...) {
+    ::close(fd_);
+    throw;
+  }
+
+  slots_.resize(options_.queue_capacity);
+  sizes_.resize(options_.queue_capacity);
+  shared_.resize(options_.queue_capacity);
+  headers_.resize(options_.batch_size);
+  iovecs_.resize(options_.batch_size);
+}
+
+CotUdpSender::~CotUdpSender() {
+  ::close(fd_);
+}
+
+bool CotUdpSender::enqueue(std::byte const* data, std::size_t size) {
+  if (queued_ == slots_.size() || size > MAX_UDP_BLOB_SIZE) {
+    return drop();
+  }
+  std::memcpy(slots_[queued_].data(), data, size);
+  sizes_[queued_++] = size;
+  return true;
+}
+
+bool CotUdpSender::enqueue(SharedBlob blob) {
+  if (queued_ == slots_.size() || !blob || blob->size() > MAX_UDP_BLOB_SIZE) {
+    return drop();
+  }
+  sizes_[queued_] = blob->size();
+  shared_[queued_++] = std::move(blob);
+  return true;
+}
+
+bool CotUdpSender::enqueue(CotType const& cot, CotSerializer& serializer) {
+  if (queued_ == slots_.size()) {
+    return drop();
+  }
+  try {
+    sizes_[queued_] = serializer.serialize_into(cot, slots_[queued_].data(),
+                                                MAX_UDP_BLOB_SIZE);
+  } catch (std::length_error const&) {
+    return drop();
+  }
+  ++queued_;
+  return true;
+}
+
+UdpBatchResult CotUdpSender::flush() {
+  UdpBatchResult result;
+  // Already in stats_ and the metric; reported here so the result accounts
+  // for every message offered since the last flush.
+  result.refused = std::exchange(refused_, 0);
+  if (queued_ == 0) {
+    return result;
+  }
+  std::size_t next{0};
+  while (next < queued_) {
+    auto const count = std::min(options_.batch_size, queued_ - next);
+    for (std::size_t i = 0; i < count; ++i) {
+      // sendmmsg never writes through iov_base.
+      auto const& shared = shared_[next + i];
+      iovecs_[i].iov_base =
+          shared ? const_cast<std::byte*>(shared->data())  // NOLINT
+                 : slots_[next + i].data();
+      iovecs_[i].iov_len = sizes_[next + i];
+      auto& header = headers_[i].msg_hdr;
+      header = msghdr{};
+      header.msg_name = &destination_;
+      header.msg_namelen = sizeof(destination_);
+      header.msg_iov = &iovecs_[i];
+      header.msg_iovlen = 1;
+    }
+
+    auto const sent = ::sendmmsg(fd_, headers_.data(),
+                                 static_cast<unsigned int>(count), 0);
+    ++result.syscalls;
+    if (sent < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      // The first datagram of the batch failed; drop it and move on.
+      ++result.dropped;
+      ++next;
+      continue;
+    }
+    result.sent += static_cast<std::size_t>(sent);
+    next += static_cast<std::size_t>(sent);
+  }
+  std::fill_n(shared_.begin(), queued_, nullptr);
+  queued_ = 0;
+
+  ++stats_.batches;
+  stats_.sent += result.sent;
+  stats_.dropped += result.dropped;
+  sent_metric_.add(result.sent);
+  if (result.dropped > 0) {
+    dropped_metric_.add(result.dropped);
+  }
+  return result;
+}
+
+bool CotUdpSender::drop() {
+  ++refused_;
+  ++stats_.dropped;
+  dropped_metric_.add();
+  return false;
+}
+
+CotUdpReceiver::CotUdpReceiver(URL const& url,
+                               std::shared_ptr<CotSerializer> serializer,
+                               Handler handler, UdpReceiverOptions options)
+    : serializer_{std::move(serializer)},
+      handler_{std::move(handler)},
+      options_{std::move(options)} {
+  if (url.scheme != Scheme::UDP && url.scheme != Scheme::UDP_BROADCAST) {
+    throw std::invalid_argument("CotUdpReceiver requires a udp URL.");
+  }
+  options_.workers = std::max<std::size_t>(options_.workers, 1);
+  options_.batch_size = std::max<std::size_t>(options_.batch_size, 1);
+
+  auto address = resolve_ipv4(url);
+  auto const multicast = IN_MULTICAST(ntohl(address.sin_addr.s_addr));
+  auto const shared = multicast || url.scheme == Scheme::UDP_BROADCAST;
+  if (url.scheme == Scheme::UDP_BROADCAST) {
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+  }
+
+  auto const sockets = shared ? std::size_t{1} : options_.workers;
+  try {
+    for (std::size_t i = 0; i < sockets; ++i) {
+      auto const fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+      if (fd < 0) {
+        throw_errno("socket");
+      }
+      fds_.push_back(fd);
+      int const enable{1};
+      set_option(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable),
+                 "SO_REUSEADDR");
+      set_option(fd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable),
+                 "SO_REUSEPORT");
+      set_option(fd, SOL_SOCKET, SO_RXQ_OVFL, &enable, sizeof(enable),
+                 "SO_RXQ_OVFL");
+      if (options_.receive_buffer > 0) {
+        set_option(fd, SOL_SOCKET, SO_RCVBUF, &options_.receive_buffer,
+                   sizeof(options_.receive_buffer), "SO_RCVBUF");
+      }
+      if (::bind(fd, reinterpret_cast<sockaddr const*>(&address),
+                 sizeof(address)) != 0) {
+        throw_errno("bind");
+      }
+      if (i == 0) {
+        // Later sockets join the same SO_REUSEPORT group, even if the URL
+        // asked for any free port.
+        socklen_t size = sizeof(address);
+        ::getsockname(fd, reinterpret_cast<sockaddr*>(&address), &size);
+        port_ = ntohs(address.sin_port);
+      }
+      if (multicast) {
+        ip_mreqn request{};
+        request.imr_multiaddr = address.sin_addr;
+        set_interface(options_.interface, request);
+        set_option(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &request,
+                   sizeof(request), "IP_ADD_MEMBERSHIP");
+      }
+    }
+  } catch (...) {
+    for (auto const fd : fds_) {
+      ::close(fd);
+    }
+    throw;
+  }
+
+  source_ = to_string(URL{url.scheme, url.net_loc, port_});
+  worker_counters_ = std::vector<WorkerCounters>(options_.workers);
+  socket_counters_ = std::vector<SocketCounters>(fds_.size());
+}
+
+CotUdpReceiver::~CotUdpReceiver() {
+  stop();
+  for (auto const fd : fds_) {
+    ::close(fd);
+  }
+}
+
+void CotUdpReceiver::start() {
+  if (running_.exchange(true)) {
+    return;
+  }
+  for (std::size_t i = 0; i < options_.workers; ++i) {
+    threads_.emplace_back(&CotUdpReceiver::run, this, i);
+    if (!options_.cpus.empty()) {
+      cpu_set_t cpus;
+      CPU_ZERO(&cpus);
+      CPU_SET(options_.cpus[i % options_.cpus.size()], &cpus);
+      ::pthread_setaffinity_np(threads_.back().native_handle(), sizeof(cpus),
+                               &cpus);
+    }
+  }
+}
+
+void CotUdpReceiver::stop() {
+  running_ = false;
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+  threads_.clear();
+}
+
+UdpReceiverStats CotUdpReceiver::stats() const {
+  UdpReceiverStats stats;
+  for (auto const& counters : worker_counters_) {
+    stats.received += counters.received.load(std::memory_order_relaxed);
+    stats.decode_failures +=
+        counters.decode_failures.load(std::memory_order_relaxed);
+    stats.oversize += counters.oversize.load(std::memory_order_relaxed);
+    stats.filtered += counters.filtered.load(std::memory_order_relaxed);
+  }
+  for (auto const& counters : socket_counters_) {
+    stats.kernel_drops += counters.kernel_drops.load(std::memory_order_relaxed);
+  }
+  return stats;
+}
+
+void CotUdpReceiver::run(std::size_t worker) {
+  auto const socket = fds_.size() == 1 ? std::size_t{0} : worker;
+  auto const fd = fds_[socket];
+  auto& counters = worker_counters_[worker];
+  auto& kernel_drops = socket_counters_[socket].kernel_drops;
+  auto& received_metric = metrics().counter(
+      "taktile_udp_received_total", "Datagrams received by CotUdpReceiver");
+
+  // Decode straight out of fixed-size receive slots, passing each
+  // datagram's length alongside, so nothing is resized or zeroed per recv.
+  auto const batch = options_.batch_size;
+  std::vector<std::array<std::byte, MAX_UDP_BLOB_SIZE>> slots(batch);
+  std::vector<iovec> iovecs(batch);
+  std::vector<mmsghdr> headers(batch);
+  constexpr auto CONTROL_SIZE = CMSG_SPACE(sizeof(uint32_t));
+  std::vector<std::array<char, CONTROL_SIZE>> controls(batch);
+
+  while (running_.load(std::memory_order_relaxed)) {
+    pollfd pfd{fd, POLLIN, 0};
+    if (::poll(&pfd, 1, options_.poll_timeout_ms) <= 0) {
+      continue;
+    }
+    for (std::size_t i = 0; i < batch; ++i) {
+      iovecs[i].iov_base = slots[i].data();
+      iovecs[i].iov_len = slots[i].size();
+      auto& header = headers[i].msg_hdr;
+      header = msghdr{};
+      header.msg_iov = &iovecs[i];
+      header.msg_iovlen = 1;
+      header.msg_control = controls[i].data();
+      header.msg_controllen = controls[i].size();
+    }
+    auto const count = ::recvmmsg(fd, headers.data(),
+                                  static_cast<unsigned int>(batch),
+                                  MSG_DONTWAIT, nullptr);
+    if (count <= 0) {
+      // EAGAIN when another worker sharing the socket got there first.
+      continue;
+    }
+    received_metric.add(static_cast<uint64_t>(count));
+    auto const received_at =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch())
+            .count();
+
+    for (std::size_t i = 0; i < static_cast<std::size_t>(count); ++i) {
+      auto& header = headers[i].msg_hdr;
+      for (auto* cmsg = CMSG_FIRSTHDR(&header); cmsg != nullptr;
+           cmsg = CMSG_NXTHDR(&header, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_RXQ_OVFL) {
+          uint32_t drops{0};
+          std::memcpy(&drops, CMSG_DATA(cmsg), sizeof(drops));
+          // The kernel reports the socket's running total; keep the largest.
+          auto seen = kernel_drops.load(std::memory_order_relaxed);
+          while (drops > seen &&
+                 !kernel_drops.compare_exchange_weak(
+                     seen, drops, std::memory_order_relaxed)) {
+          }
+        }
+      }
+
+      counters.received.fetch_add(1, std::memory_order_relaxed);
+      if ((header.msg_flags & MSG_TRUNC) != 0) {
+        // Only a prefix fit in the slot; decoding it could misread a
+        // longer event as a shorter one.
+        counters.oversize.fetch_add(1, std::memory_order_relaxed);
+        continue;
+      }
+      auto const* const datagram = slots[i].data();
+      std::size_t const size = headers[i].msg_len;
+      if (options_.capture) {
+        options_.capture->append(received_at, source_, datagram, size);
+      }
+      if (options_.filter &&
+          !options_.filter->matches(CotView(datagram, size))) {
+        counters.filtered.fetch_add(1, std::memory_order_relaxed);
+        continue;
+      }
+      std::optional<CotType> cot;
+      try {
+        cot.emplace(serializer_->deserialize_from(datagram, size));
+      } catch (std::exception const&) {
+        counters.decode_failures.fetch_add(1, std::memory_order_relaxed);
+        continue;
+      }
+      handler_(std::move(*cot));
+    }
+  }
+}
+
+}  // namespace taktile
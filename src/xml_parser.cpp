@@ -0,0 +1,593 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include "taktile/xml_parser.hpp"
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include "taktile/datetime.hpp"
+
+namespace taktile {
+
+namespace {
+
+constexpr bool is_space(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+constexpr bool is_name_end(char c) {
+  return is_space(c) || c == '=' || c == '/' || c == '>';
+}
+
+[[noreturn]] void malformed(std::size_t offset) {
+  throw std::invalid_argument("Unable to parse: malformed XML at offset " +
+                              std::to_string(offset) + ".");
+}
+
+/// @brief Forward-only cursor over an XML document
+/// @details Only understands as much XML as a CoT event needs: elements,
+///          attributes, comments, processing instructions and CDATA.  Nested
+///          elements are skipped iteratively, so hostile nesting cannot
+///          exhaust the stack.
+class PullParser {
+ public:
+  explicit PullParser(std::string_view xml) : xml_{xml} {}
+
+  /// @brief Skip the XML declaration, comments and doctype before the root
+  void skip_prolog() {
+    for (;;) {
+      skip_space();
+      if (starts_with("<?")) {
+        skip_past("?>");
+      } else if (starts_with("<!--")) {
+        skip_past("-->");
+      } else if (starts_with("<!")) {
+        skip_past(">");
+      } else {
+        return;
+      }
+    }
+  }
+
+  /// @brief Read the name of the start tag at the cursor
+  /// @return false if the cursor is not at a start tag
+  bool start_tag(std::string_view& name) {
+    if (!starts_with("<") || pos_ + 1 >= xml_.size() ||
+        is_name_end(xml_[pos_ + 1])) {
+      return false;
+    }
+    tag_begin_ = pos_;
+    auto const begin = ++pos_;
+    while (pos_ < xml_.size() && !is_name_end(xml_[pos_])) {
+      ++pos_;
+    }
+    name = xml_.substr(begin, pos_ - begin);
+    return true;
+  }
+
+  /// @brief Read the next attribute of the current start tag
+  /// @return false once the end of the tag has been consumed
+  bool attribute(std::string_view& name, std::string_view& value) {
+    skip_space();
+    if (pos_ >= xml_.size()) {
+      malformed(pos_);
+    }
+    if (xml_[pos_] == '>') {
+      ++pos_;
+      self_closing_ = false;
+      return false;
+    }
+    if (starts_with("/>")) {
+      pos_ += 2;
+      self_closing_ = true;
+      return false;
+    }
+    auto const begin = pos_;
+    while (pos_ < xml_.size() && !is_name_end(xml_[pos_])) {
+      ++pos_;
+    }
+    name = xml_.substr(begin, pos_ - begin);
+    skip_space();
+    if (name.empty() || pos_ >= xml_.size() || xml_[pos_] != '=') {
+      malformed(pos_);
+    }
+    ++pos_;
+    skip_space();
+    if (pos_ >= xml_.size() || (xml_[pos_] != '"' && xml_[pos_] != '\'')) {
+      malformed(pos_);
+    }
+    auto const end = xml_.find(xml_[pos_], pos_ + 1);
+    if (end == std::string_view::npos) {
+      malformed(pos_);
+    }
+    value = xml_.substr(pos_ + 1, end - pos_ - 1);
+    pos_ = end + 1;
+    return true;
+  }
+
+  /// @brief Skip the comments and processing instructions after the root
+  /// @throws std::invalid_argument if anything else follows the root
+  void skip_epilog() {
+    for (;;) {
+      skip_space();
+      if (starts_with("<?")) {
+        skip_past("?>");
+      } else if (starts_with("<!--")) {
+        skip_past("-->");
+      } else if (pos_ < xml_.size()) {
+        malformed(pos_);
+      } else {
+        return;
+      }
+    }
+  }
+
+  /// @brief Offset of the next byte to be read
+  [[nodiscard]] std::size_t position() const {
+    return pos_;
+  }
+
+  /// @brief Offset of the '<' of the last start or end tag read
+  [[nodiscard]] std::size_t tag_begin() const {
+    return tag_begin_;
+  }
+
+  /// @brief Whether the last start tag read was of the form <name/>
+  [[nodiscard]] bool self_closing() const {
+    return self_closing_;
+  }
+
+  /// @brief Advance to the next child element of the current element
+  /// @return false once the current element's end tag has been consumed
+  bool next_child(std::string_view& name) {
+    for (;;) {
+      auto const open = xml_.find('<', pos_);
+      if (open == std::string_view::npos) {
+        malformed(xml_.size());
+      }
+      pos_ = open;
+      if (starts_with("<!--")) {
+        skip_past("-->");
+      } else if (starts_with("<![CDATA[")) {
+        skip_past("]]>");
+      } else if (starts_with("<?")) {
+        skip_past("?>");
+      } else if (starts_with("</")) {
+        tag_begin_ = pos_;
+        skip_past(">");
+        return false;
+      } else if (start_tag(name)) {
+        return true;
+      } else {
+        malformed(pos_);
+      }
+    }
+  }
+
+  /// @brief Skip the rest of an element whose name has just been read
+  void skip_element() {
+    std::string_view name;
+    std::string_view value;
+    while (attribute(name, value)) {
+    }
+    if (!self_closing_) {
+      skip_children();
+    }
+  }
+
+  /// @brief Skip to the end of an element whose start tag has been read
+  void skip_children() {
+    std::string_view name;
+    std::string_view value;
+    std::size_t depth = 1;
+    while (depth > 0) {
+      if (next_child(name)) {
+        while (attribute(name, value)) {
+        }
+        depth += self_closing_ ? 0 : 1;
+      } else {
+        --depth;
+      }
+    }
+  }
+
+ private:
+  bool starts_with(std::string_view prefix) const {
+    return xml_.substr(pos_, prefix.size()) == prefix;
+  }
+
+  void skip_space() {
+    while (pos_ < xml_.size() && is_space(xml_[pos_])) {
+      ++pos_;
+    }
+  }
+
+  void skip_past(std::string_view terminator) {
+    auto const end = xml_.find(terminator, pos_);
+    if (end == std::string_view::npos) {
+      malformed(pos_);
+    }
+    pos_ = end + terminator.size();
+  }
+
+  std::string_view xml_;
+  std::size_t pos_{0};
+  std::size_t tag_begin_{0};
+  bool self_closing_{false};
+};
+
+/// @brief Strip what std::stod would accept before the digits
+std::string_view numeric_prefix(std::string_view text) {
+  while (!text.empty() && is_space(text.front())) {
+    text.remove_prefix(1);
+  }
+  if (!text.empty() && text.front() == '+') {
+    text.remove_prefix(1);
+  }
+  return text;
+}
+
+/// @brief Parse a double with std::stod's error behavior
+double to_double(std::string_view text) {
+  text = numeric_prefix(text);
+  double value{};
+  auto const result =
+      std::from_chars(text.data(), text.data() + text.size(), value);
+  if (result.ec == std::errc::invalid_argument) {
+    throw std::invalid_argument("stod");
+  }
+  if (result.ec == std::errc::result_out_of_range) {
+    throw std::out_of_range("stod");
+  }
+  return value;
+}
+
+void append_utf8(uint32_t code_point, std::string& out) {
+  if (code_point < 0x80) {
+    out.push_back(static_cast<char>(code_point));
+  } else if (code_point < 0x800) {
+    out.push_back(static_cast<char>(0xC0 | (code_point >> 6)));
+    out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else if (code_point < 0x10000) {
+    out.push_back(static_cast<char>(0xE0 | (code_point >> 12)));
+    out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  } else {
+    out.push_back(static_cast<char>(0xF0 | (code_point >> 18)));
+    out.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3F)));
+    out.push_back(static_cast<char>(0x80 | (code_point & 0x3F)));
+  }
+}
+
+/// @brief Claim bit in seen, rejecting an attribute read twice
+/// @details A repeated attribute is not well-formed XML, and reading it
+///          last-wins would let a sender smuggle a second value past a
+///          reader that takes the first.
+void claim_once(uint32_t& seen, uint32_t bit, PullParser const& parser) {
+  if ((seen & bit) != 0) {
+    malformed(parser.position());
+  }
+  seen |= bit;
+}
+
+/// @brief Read the root <event> start tag and its attributes
+void scan_event_tag(PullParser& parser, CotXmlFields& fields) {
+  parser.skip_prolog();
+
+  std::string_view name;
+  if (!parser.start_tag(name) || name != "event") {
+    throw std::invalid_argument(
+        "Expected root-level <event> element not found.");
+  }
+
+  std::string_view value;
+  uint32_t seen{0};
+  while (parser.attribute(name, value)) {
+    if (name == "uid") {
+      claim_once(seen, 1U << 0, parser);
+      fields.uid = value;
+    } else if (name == "type") {
+      claim_once(seen, 1U << 1, parser);
+      fields.cot_type = value;
+    } else if (name == "time") {
+      claim_once(seen, 1U << 2, parser);
+      fields.time = value;
+    } else if (name == "start") {
+      claim_once(seen, 1U << 3, parser);
+      fields.start = value;
+    } else if (name == "stale") {
+      claim_once(seen, 1U << 4, parser);
+      fields.stale = value;
+    }
+  }
+}
+
+/// @brief Intern a raw attribute value, decoding it only if it needs it
+InternId intern_xml(std::string_view value, StringInterner& interner) {
+  if (value.find_first_of("&\t\n\r") == std::string_view::npos) {
+    return interner.intern(value);
+  }
+  thread_local std::string decoded;
+  unescape_xml(value, decoded);
+  return interner.intern(decoded);
+}
+
+}  // namespace
+
+CotXmlFields scan_cot_event_xml(std::string_view xml) {
+  PullParser parser{xml};
+  CotXmlFields fields;
+  scan_event_tag(parser, fields);
+  return fields;
+}
+
+CotXmlFields scan_cot_xml(std::string_view xml) {
+  PullParser parser{xml};
+  CotXmlFields fields;
+  scan_event_tag(parser, fields);
+
+  std::string_view name;
+  std::string_view value;
+
+  // Only <point> is read, but the rest is still scanned to </event> so a
+  // truncated event is rejected as the DOM path rejects it.
+  bool found_point{false};
+  if (!parser.self_closing()) {
+    while (parser.next_child(name)) {
+      if (name != "point" || found_point) {
+        parser.skip_element();
+        continue;
+      }
+      found_point = true;
+      uint32_t seen{0};
+      while (parser.attribute(name, value)) {
+        if (name == "lat") {
+          claim_once(seen, 1U << 0, parser);
+          fields.lat = value;
+        } else if (name == "lon") {
+          claim_once(seen, 1U << 1, parser);
+          fields.lon = value;
+        } else if (name == "le") {
+          claim_once(seen, 1U << 2, parser);
+          fields.le = value;
+        } else if (name == "hae") {
+          claim_once(seen, 1U << 3, parser);
+          fields.hae = value;
+        } else if (name == "ce") {
+          claim_once(seen, 1U << 4, parser);
+          fields.ce = value;
+        }
+      }
+      if (!parser.self_closing()) {
+        parser.skip_children();
+      }
+    }
+    parser.skip_epilog();
+  }
+  if (!found_point) {
+    throw std::invalid_argument("Expected <point> element not found.");
+  }
+  return fields;
+}
+
+void unescape_xml(std::string_view value, std::string& out) {
+  out.clear();
+  out.reserve(value.size());
+  for (std::size_t i = 0; i < value.size(); ++i) {
+    auto const c = value[i];
+    if (c != '&') {
+      // Attribute-value normalization turns literal whitespace into spaces.
+      out.push_back(is_space(c) ? ' ' : c);
+      continue;
+    }
+    auto const end = value.find(';', i);
+    if (end == std::string_view::npos) {
+      throw std::invalid_argument("Unable to parse: unterminated entity.");
+    }
+    auto const entity = value.substr(i + 1, end - i - 1);
+    if (entity == "lt") {
+      out.push_back('<');
+    } else if (entity == "gt") {
+      out.push_back('>');
+    } else if (entity == "amp") {
+      out.push_back('&');
+    } else if (entity == "quot") {
+      out.push_back('"');
+    } else if (entity == "apos") {
+      out.push_back('\'');
+    } else if (entity.size() > 1 && entity.front() == '#') {
+      auto const hex = entity[1] == 'x';
+      auto const digits = entity.substr(hex ? 2 : 1);
+      uint32_t code_point{};
+      auto const result =
+          std::from_chars(digits.data(), digits.data() + digits.size(),
+                          code_point, hex ? 16 : 10);
+      if (digits.empty() || result.ec != std::errc{} ||
+          result.ptr != digits.data() + digits.size() ||
+          code_point > 0x10FFFF) {
+        throw std::invalid_argument("Unable to parse: bad character entity.");
+      }
+      append_utf8(code_point, out);
+    } else {
+      throw std::invalid_argument("Unable to parse: unknown entity.");
+    }
+    i = end;
+  }
+}
+
+CotType read_cot_xml(std::string_view xml) {
+  auto const fields = scan_cot_xml(xml);
+
+  if (fields.uid.empty()) {
+    throw std::invalid_argument("UID attribute is empty.");
+  }
+  std::string uid;
+  unescape_xml(fields.uid, uid);
+  auto cot = CotType(std::move(uid));
+
+  // Mirror Cot2Xml::convert so both paths report errors identically.
+  try {
+    cot.lat = to_double(fields.lat);
+    cot.lon = to_double(fields.lon);
+    cot.le = to_double(fields.le);
+    cot.hae = to_double(fields.hae);
+    cot.ce = to_double(fields.ce);
+    unescape_xml(fields.cot_type, cot.cot_type);
+    cot.time = parse_w3c_datetime(fields.time);
+    cot.start = parse_w3c_datetime(fields.start);
+    cot.stale = parse_w3c_datetime(fields.stale);
+    CotType::validate(cot);
+    return cot;
+  } catch (std::invalid_argument const& e) {
+    throw std::invalid_argument("CoT validation failed: " +
+                                std::string(e.what()));
+  } catch (std::exception const& e) {
+    throw std::invalid_argument("Unable to parse: " + std::string(e.what()));
+  }
+}
+
+CotRelaySpans scan_cot_relay_xml(std::string_view xml,
+                                 std::string_view flow_tag) {
+  PullParser parser{xml};
+  parser.skip_prolog();
+
+  std::string_view name;
+  if (!parser.start_tag(name) || name != "event") {
+    throw std::invalid_argument(
+        "Expected root-level <event> element not found.");
+  }
+
+  CotRelaySpans spans;
+  auto const offset = [&xml](std::string_view value) {
+    return static_cast<std::size_t>(value.data() - xml.data());
+  };
+  std::string_view value;
+  bool has_time = false;
+  while (parser.attribute(name, value)) {
+    if (name == "time") {
+      spans.time_begin = offset(value);
+      spans.time_end = spans.time_begin + value.size();
+      has_time = true;
+    }
+  }
+  if (!has_time) {
+    throw std::invalid_argument("Expected time attribute not found.");
+  }
+
+  bool has_point = false;
+  bool has_detail = false;
+  auto const has_children = !parser.self_closing();
+  while (has_children && parser.next_child(name)) {
+    has_point = has_point || name == "point";
+    if (name != "detail" || has_detail) {
+      parser.skip_element();
+      continue;
+    }
+    has_detail = true;
+    auto const detail_tag = parser.tag_begin();
+    while (parser.attribute(name, value)) {
+    }
+    if (parser.self_closing()) {
+      // <detail/> is replaced by a detail holding only the flow-tags.
+      spans.detail_begin = spans.detail_end = parser.position();
+      spans.flow_begin = detail_tag;
+      spans.flow_end = parser.position();
+      spans.flow_insert = CotRelaySpans::Insert::DETAIL;
+      continue;
+    }
+    spans.detail_begin = parser.position();
+    bool has_flow_tags = false;
+    while (parser.next_child(name)) {
+      if (name != "_flow-tags_" || has_flow_tags) {
+        parser.skip_element();
+        continue;
+      }
+      has_flow_tags = true;
+      auto attribute_begin = parser.position();
+      while (parser.attribute(name, value)) {
+        if (name == flow_tag && !spans.looped) {
+          // Replace this node's earlier attribute, with the space before
+          // it, rather than write a second one.
+          spans.looped = true;
+          spans.flow_begin = attribute_begin;
+          spans.flow_end = parser.position();
+        }
+        attribute_begin = parser.position();
+      }
+      if (!spans.looped) {
+        // The new attribute goes just before the "/>" or ">" that closed
+        // the tag.
+        spans.flow_begin = spans.flow_end =
+            parser.position() - (parser.self_closing() ? 2 : 1);
+      }
+      spans.flow_insert = CotRelaySpans::Insert::ATTRIBUTE;
+      if (!parser.self_closing()) {
+        parser.skip_children();
+      }
+    }
+    spans.detail_end = parser.tag_begin();
+    if (!has_flow_tags) {
+      spans.flow_begin = spans.flow_end = spans.detail_end;
+      spans.flow_insert = CotRelaySpans::Insert::ELEMENT;
+    }
+  }
+  if (!has_point) {
+    throw std::invalid_argument("Expected <point> element not found.");
+  }
+  if (!has_detail) {
+    // Just before </event>.
+    spans.flow_begin = spans.flow_end = parser.tag_begin();
+    spans.flow_insert = CotRelaySpans::Insert::DETAIL;
+  }
+  return spans;
+}
+
+CompactCot read_compact_cot_xml(std::string_view xml,
+                                StringInterner& interner) {
+  auto const fields = scan_cot_xml(xml);
+
+  if (fields.uid.empty()) {
+    throw std::invalid_argument("UID attribute is empty.");
+  }
+
+  CompactCot cot;
+  try {
+    cot.lat = to_double(fields.lat);
+    cot.lon = to_double(fields.lon);
+    cot.le = to_double(fields.le);
+    cot.hae = to_double(fields.hae);
+    cot.ce = to_double(fields.ce);
+    cot.time = parse_w3c_datetime(fields.time);
+    cot.start = parse_w3c_datetime(fields.start);
+    cot.stale = parse_w3c_datetime(fields.stale);
+    CotType::validate_point(cot.lat, cot.lon, cot.ce, cot.hae, cot.le);
+    // Decoding never empties a value, so the raw one can be checked here.
+    if (fields.cot_type.empty()) {
+      throw std::invalid_argument("CoT type must not be empty");
+    }
+  } catch (std::invalid_argument const& e) {
+    throw std::invalid_argument("CoT validation failed: " +
+                                std::string(e.what()));
+  } catch (std::exception const& e) {
+    throw std::invalid_argument("Unable to parse: " + std::string(e.what()));
+  }
+  // Intern only once the event is known to be valid, so rejected input never
+  // grows the table.
+  cot.uid = intern_xml(fields.uid, interner);
+  try {
+    cot.cot_type = intern_xml(fields.cot_type, interner);
+  } catch (std::invalid_argument const& e) {
+    throw std::invalid_argument("CoT validation failed: " +
+                                std::string(e.what()));
+  }
+  return cot;
+}
+
+}  // namespace taktile
@@ -0,0 +1,268 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include "taktile/xml_writer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "taktile/datetime.hpp"
+
+namespace taktile {
+
+std::string_view flow_tag_name() {
+  // Host ids are never freed, so a new address means a new id.
+  thread_local std::string const* host_id{nullptr};
+  thread_local std::string name;
+  auto const& current = default_host_id();
+  if (&current != host_id) {
+    name = current + "-v" + std::string(VERSION);
+    std::replace(name.begin(), name.end(), '@', '-');
+    host_id = &current;
+  }
+  return name;
+}
+
+XmlWriter::XmlWriter(std::byte* buffer, std::size_t capacity) noexcept
+    : buffer_{buffer}, capacity_{capacity} {}
+
+char* XmlWriter::cursor() noexcept {
+  return reinterpret_cast<char*>(buffer_ + size_);
+}
+
+bool XmlWriter::reserve(std::size_t count) noexcept {
+  if (overflowed_ || capacity_ - size_ < count) {
+    overflowed_ = true;
+    return false;
+  }
+  return true;
+}
+
+XmlWriter& XmlWriter::raw(std::string_view text) noexcept {
+  if (reserve(text.size())) {
+    std::memcpy(cursor(), text.data(), text.size());
+    size_ += text.size();
+  }
+  return *this;
+}
+
+XmlWriter& XmlWriter::escaped(std::string_view text) noexcept {
+  auto const* begin = text.data();
+  auto const* const end = text.data() + text.size();
+  for (auto const* it = begin; it != end; ++it) {
+    std::string_view entity;
+    switch (*it) {
+      case '"':
+        entity = "&quot;";
+        break;
+      case '&':
+        entity = "&amp;";
+        break;
+      case '<':
+        entity = "&lt;";
+        break;
+      case '>':
+        entity = "&gt;";
+        break;
+      case '\t':
+        entity = "&#9;";
+        break;
+      case '\r':
+        entity = "&#xD;";
+        break;
+      case '\n':
+        entity = "&#xA;";
+        break;
+      default:
+        continue;
+    }
+    raw({begin, static_cast<std::size_t>(it - begin)});
+    raw(entity);
+    begin = it + 1;
+  }
+  return raw({begin, static_cast<std::size_t>(end - begin)});
+}
+
+XmlWriter& XmlWriter::fixed(double value) noexcept {
+  if (overflowed_) {
+    return *this;
+  }
+  auto* const first = cursor();
+  auto const result = std::to_chars(first, first + (capacity_ - size_), value,
+                                    std::chars_format::fixed, 6);
+  if (result.ec != std::errc{}) {
+    overflowed_ = true;
+    return *this;
+  }
+  size_ += static_cast<std::size_t>(result.ptr - first);
+  return *this;
+}
+
+XmlWriter& XmlWriter::fixed(double value, std::size_t width) noexcept {
+  if (!reserve(width)) {
+    return *this;
+  }
+  // "nan" and "inf" would otherwise be zero-padded into a plausible value.
+  if (!std::isfinite(value)) {
+    overflowed_ = true;
+    return *this;
+  }
+  std::array<char, 32> digits{};
+  auto const result =
+      std::to_chars(digits.data(), digits.data() + digits.size(),
+                    std::fabs(value), std::chars_format::fixed, 6);
+  auto const count = static_cast<std::size_t>(result.ptr - digits.data());
+  // One byte for the sign, even when it is a padding zero.
+  if (result.ec != std::errc{} || count + 1 > width) {
+    overflowed_ = true;
+    return *this;
+  }
+  auto* const first = cursor();
+  std::memset(first, '0', width - count);
+  if (std::signbit(value)) {
+    *first = '-';
+  }
+  std::memcpy(first + width - count, digits.data(), count);
+  size_ += width;
+  return *this;
+}
+
+XmlWriter& XmlWriter::datetime(int64_t epoch_ms) noexcept {
+  if (reserve(W3C_DATETIME_LENGTH)) {
+    format_w3c_datetime(epoch_ms, cursor());
+    size_ += W3C_DATETIME_LENGTH;
+  }
+  return *this;
+}
+
+XmlWriter& XmlWriter::attribute(std::string_view name,
+                                std::string_view value) noexcept {
+  return raw(" ").raw(name).raw("=\"").escaped(value).raw("\"");
+}
+
+XmlWriter& XmlWriter::attribute(std::string_view name, double value) noexcept {
+  return raw(" ").raw(name).raw("=\"").fixed(value).raw("\"");
+}
+
+XmlWriter& XmlWriter::datetime_attribute(std::string_view name,
+                                         int64_t epoch_ms) noexcept {
+  return raw(" ").raw(name).raw("=\"").datetime(epoch_ms).raw("\"");
+}
+
+namespace {
+
+/// @brief Shared by the CotType, CompactCot and CotBatch writers, which
+///        differ only in where the fields come from
+/// @param layout if set, lat and lon are written at fixed width and the
+///        offsets of the mutable values are recorded here
+template <typename Cot>
+std::size_t write_event(Cot const& cot, std::string_view cot_type,
+                        std::string_view uid, int64_t flow_time,
+                        std::byte* buffer, std::size_t capacity,
+                        CotXmlLayout* layout = nullptr) {
+  XmlWriter writer{buffer, capacity};
+  // Note where the value about to be written starts.
+  auto const mark = [&writer, layout](
+                        std::size_t CotXmlLayout::*offset) -> XmlWriter& {
+    if (layout != nullptr) {
+      layout->*offset = writer.size();
+    }
+    return writer;
+  };
+  auto const position = [&writer, layout](double value,
+                                          std::size_t width) -> XmlWriter& {
+    return layout != nullptr ? writer.fixed(value, width)
+                             : writer.fixed(value);
+  };
+
+  // Poco's XMLWriter emits attributes sorted by name, so do the same here.
+  writer.raw("<event").attribute("how", "m-g").raw(" stale=\"");
+  mark(&CotXmlLayout::stale).datetime(cot.stale).raw("\" start=\"");
+  mark(&CotXmlLayout::start).datetime(cot.start).raw("\" time=\"");
+  mark(&CotXmlLayout::time)
+      .datetime(cot.time)
+      .raw("\"")
+      .attribute("type", cot_type)
+      .attribute("uid", uid)
+      .attribute("version", "2.0")
+      .raw("><point")
+      .attribute("ce", cot.ce)
+      .attribute("hae", cot.hae)
+      .raw(" lat=\"");
+  mark(&CotXmlLayout::lat);
+  position(cot.lat, FIXED_LAT_WIDTH).raw("\"").attribute("le", cot.le);
+  writer.raw(" lon=\"");
+  mark(&CotXmlLayout::lon);
+  position(cot.lon, FIXED_LON_WIDTH)
+      .raw("\"/><detail><_flow-tags_ ")
+      .raw(flow_tag_name())
+      .raw("=\"");
+  mark(&CotXmlLayout::flow_time)
+      .datetime(flow_time)
+      .raw("\"/></detail></event>");
+
+  if (writer.overflowed()) {
+    throw_oversize(capacity);
+  }
+  return writer.size();
+}
+
+}  // namespace
+
+std::size_t write_cot_xml(CotType const& cot, std::byte* buffer,
+                          std::size_t capacity) {
+  return write_event(cot, cot.cot_type, cot.uid, now_ms(), buffer, capacity);
+}
+
+std::size_t write_cot_xml(CotType const& cot, std::byte* buffer,
+                          std::size_t capacity, CotXmlLayout& layout) {
+  return write_event(cot, cot.cot_type, cot.uid, now_ms(), buffer, capacity,
+                     &layout);
+}
+
+std::size_t write_cot_xml(CompactCot const& cot,
+                          StringInterner const& interner, std::byte* buffer,
+                          std::size_t capacity) {
+  return write_event(cot, interner.view(cot.cot_type), interner.view(cot.uid),
+                     now_ms(), buffer, capacity);
+}
+
+void write_cot_xml(CotBatch const& batch, std::vector<std::byte>& out,
+                   std::vector<std::size_t>& ends, std::size_t max_event_size) {
+  struct Row {
+    double lat;
+    double lon;
+    double ce;
+    double hae;
+    double le;
+    int64_t time;
+    int64_t start;
+    int64_t stale;
+  };
+
+  auto const flow_time = now_ms();
+  ends.clear();
+  ends.reserve(batch.size());
+  // A typical event is about a quarter of a UDP datagram.
+  out.resize(std::max(out.size(), batch.size() * MAX_UDP_BLOB_SIZE / 4));
+  std::size_t used = 0;
+  for (std::size_t i = 0; i < batch.size(); ++i) {
+    if (out.size() - used < max_event_size) {
+      out.resize(std::max(out.size() * 2, used + max_event_size));
+    }
+    Row const row{batch.lat()[i],   batch.lon()[i], batch.ce()[i],
+                  batch.hae()[i],   batch.le()[i],  batch.time()[i],
+                  batch.start()[i], batch.stale()[i]};
+    used += write_event(row, batch.cot_type()[i], batch.uid()[i], flow_time,
+                        out.data() + used, max_event_size);
+    ends.push_back(used);
+  }
+  out.resize(used);
+}
+
+}  // namespace taktile
@@ -0,0 +1,181 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "taktile/bulk_load.hpp"
+#include "taktile/functions.hpp"
+#include "taktile/track_store.hpp"
+
+namespace {
+
+constexpr int UIDS{16};
+
+/// Archive of concatenated events, removed when done.
+class Archive {
+ public:
+  Archive() {
+    std::string pattern{"/tmp/taktile_archive_XXXXXX"};
+    ::close(::mkstemp(pattern.data()));
+    path_ = pattern;
+  }
+
+  ~Archive() {
+    ::unlink(path_.c_str());
+  }
+
+  [[nodiscard]] std::string const& path() const {
+    return path_;
+  }
+
+  /// Write count events cycling through UIDS uids; the i-th has lat
+  /// i / 1000, and every malformed_every-th record is broken.
+  void write(int count, int malformed_every = 0) const {
+    std::ofstream out{path_, std::ios::binary | std::ios::trunc};
+    auto serializer = taktile::CotDirectXmlSerializer();
+    for (int i = 0; i < count; ++i) {
+      if (malformed_every > 0 && i % malformed_every == 0) {
+        out << "<event uid=\"broken\"></event>\n";
+        continue;
+      }
+      auto const blob = serializer.serialize(cot(i));
+      out.write(reinterpret_cast<char const*>(blob.data()),
+                static_cast<std::streamsize>(blob.size()));
+      out << (i % 2 == 0 ? "\n" : "");
+    }
+  }
+
+  static taktile::CotType cot(int i) {
+    auto cot = taktile::CotType("track-" + std::to_string(i % UIDS));
+    cot.lat = i / 1000.0;
+    // Same time for every update, so only file order decides the winner.
+    cot.time = 1700000000000;
+    cot.start = cot.time;
+    cot.stale = cot.time + 60000;
+    return cot;
+  }
+
+ private:
+  std::string path_;
+};
+
+taktile::BulkLoadOptions options(std::size_t workers, std::size_t chunk_size,
+                                 std::size_t partitions = 1) {
+  taktile::BulkLoadOptions options;
+  options.workers = workers;
+  options.chunk_size = chunk_size;
+  options.partitions = partitions;
+  return options;
+}
+
+}  // namespace
+
+TEST(BulkLoad, vector_in_file_order) {
+  /// Test that a parallel load with small chunks decodes every event in
+  /// file order and counts malformed records
+  Archive const archive;
+  archive.write(5000, 100);
+
+  std::vector<taktile::CotType> events;
+  auto const stats =
+      taktile::bulk_load(archive.path(), options(4, 4096), events);
+  EXPECT_EQ(stats.events, 4950U);
+  EXPECT_EQ(stats.malformed, 50U);
+  EXPECT_GT(stats.chunks, 100U);
+  EXPECT_GT(stats.events_per_second(), 0.0);
+  ASSERT_EQ(events.size(), 4950U);
+
+  // A chunk size below the length of </event> still splits per event.
+  Archive const small;
+  small.write(20);
+  std::vector<taktile::CotType> tiny;
+  auto const tiny_stats = taktile::bulk_load(small.path(), options(2, 1), tiny);
+  EXPECT_EQ(tiny_stats.chunks, 20U);
+  EXPECT_EQ(tiny.size(), 20U);
+  std::size_t next{0};
+  for (int i = 0; i < 5000; ++i) {
+    if (i % 100 == 0) {
+      continue;
+    }
+    ASSERT_EQ(events[next].uid, Archive::cot(i).uid);
+    ASSERT_DOUBLE_EQ(events[next].lat, Archive::cot(i).lat);
+    ++next;
+  }
+}
+
+TEST(BulkLoad, partitions_keep_uid_order) {
+  /// Test that each partition sees its uids' events in file order, one call
+  /// at a time
+  Archive const archive;
+  constexpr int EVENTS{312 * UIDS};
+  archive.write(EVENTS);
+  constexpr std::size_t PARTITIONS{4};
+  std::vector<std::vector<double>> lats(UIDS);
+  std::vector<std::mutex> busy(PARTITIONS);
+  auto const stats = taktile::bulk_load(
+      archive.path(), options(4, 2048, PARTITIONS),
+      [&lats, &busy](std::size_t partition,
+                     std::vector<taktile::CotType>&& events) {
+        ASSERT_LT(partition, busy.size());
+        std::unique_lock const lock{busy[partition], std::try_to_lock};
+        ASSERT_TRUE(lock.owns_lock());
+        for (auto const& cot : events) {
+          lats[std::stoul(cot.uid.substr(6))].push_back(cot.lat);
+        }
+      });
+  EXPECT_EQ(stats.events, static_cast<uint64_t>(EVENTS));
+  for (int uid = 0; uid < UIDS; ++uid) {
+    ASSERT_EQ(lats[uid].size(), static_cast<std::size_t>(EVENTS / UIDS));
+    for (std::size_t i = 0; i < lats[uid].size(); ++i) {
+      EXPECT_DOUBLE_EQ(lats[uid][i], Archive::cot(uid + UIDS * i).lat);
+    }
+  }
+}
+
+TEST(BulkLoad, track_store_and_errors) {
+  /// Test that a store loaded in parallel ends with each uid's last event,
+  /// and that handler errors and missing files are reported
+  Archive const archive;
+  constexpr int EVENTS{312 * UIDS};
+  archive.write(EVENTS);
+  taktile::TrackStore store;
+  auto const stats =
+      taktile::bulk_load(archive.path(), options(4, 1024), store);
+  EXPECT_EQ(stats.events, static_cast<uint64_t>(EVENTS));
+  EXPECT_EQ(store.size(), static_cast<std::size_t>(UIDS));
+  for (int uid = 0; uid < UIDS; ++uid) {
+    auto const track = store.find("track-" + std::to_string(uid));
+    ASSERT_NE(track, nullptr);
+    EXPECT_DOUBLE_EQ(track->lat, Archive::cot(EVENTS - UIDS + uid).lat);
+  }
+
+  EXPECT_THROW(taktile::bulk_load(
+                   archive.path(), options(4, 1024),
+                   [](std::size_t, std::vector<taktile::CotType>&&) {
+                     throw std::runtime_error("handler");
+                   }),
+               std::runtime_error);
+  EXPECT_THROW(taktile::bulk_load("/nonexistent/archive", options(1, 1024),
+                                  store),
+               std::system_error);
+
+  Archive const empty;
+  std::vector<taktile::CotType> events;
+  EXPECT_EQ(taktile::bulk_load(empty.path(), {}, events).events, 0U);
+  EXPECT_TRUE(events.empty());
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
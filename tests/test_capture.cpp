@@ -0,0 +1,267 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "taktile/capture.hpp"
+#include "taktile/functions.hpp"
+#include "taktile/udp.hpp"
+
+namespace {
+
+constexpr int64_t MILLISECOND{1000000};
+
+/// Name for a capture file, removed along with its index.
+class TempFile {
+ public:
+  TempFile() {
+    std::string pattern{"/tmp/taktile_capture_XXXXXX"};
+    ::close(::mkstemp(pattern.data()));
+    path_ = pattern;
+  }
+
+  ~TempFile() {
+    ::unlink(path_.c_str());
+    ::unlink((path_ + ".idx").c_str());
+  }
+
+  [[nodiscard]] std::string const& path() const {
+    return path_;
+  }
+
+ private:
+  std::string path_;
+};
+
+std::string payload(int64_t i) {
+  return "<event uid=\"" + std::to_string(i) + "\"/>";
+}
+
+bool append(taktile::CaptureWriter& writer, int64_t time,
+            std::string_view data) {
+  return writer.append(time, "udp://127.0.0.1:6969",
+                       reinterpret_cast<std::byte const*>(data.data()),
+                       data.size());
+}
+
+std::string_view text(taktile::CaptureRecord const& record) {
+  return {reinterpret_cast<char const*>(record.data), record.size};
+}
+
+/// Write records at 0, 1, ... count - 1 milliseconds.
+void write_records(std::string const& path, int64_t count) {
+  taktile::CaptureOptions options;
+  options.max_size = std::size_t{1} << 20;
+  options.index_interval = 256;
+  taktile::CaptureWriter writer{path, options};
+  for (int64_t i = 0; i < count; ++i) {
+    ASSERT_TRUE(append(writer, i * MILLISECOND, payload(i)));
+  }
+}
+
+bool wait_for(taktile::CotUdpReceiver const& receiver, uint64_t count) {
+  auto const deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (receiver.stats().received < count) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+}  // namespace
+
+TEST(Capture, round_trip_and_seek) {
+  /// Test that records read back in order and seeking lands on the first
+  /// record at or after a time, with or without the index file
+  TempFile const file;
+  write_records(file.path(), 1000);
+
+  for (auto const with_index : {true, false}) {
+    if (!with_index) {
+      ::unlink((file.path() + ".idx").c_str());
+    }
+    taktile::CaptureReader reader{file.path()};
+    int64_t count{0};
+    while (auto const record = reader.next()) {
+      EXPECT_EQ(record->time, count * MILLISECOND);
+      EXPECT_EQ(record->source, "udp://127.0.0.1:6969");
+      EXPECT_EQ(text(*record), payload(count));
+      ++count;
+    }
+    EXPECT_EQ(count, 1000);
+
+    reader.seek(500 * MILLISECOND);
+    EXPECT_EQ(reader.next()->time, 500 * MILLISECOND);
+    reader.seek(500 * MILLISECOND - 1);
+    EXPECT_EQ(reader.next()->time, 500 * MILLISECOND);
+    reader.seek(1000 * MILLISECOND);
+    EXPECT_FALSE(reader.next());
+    reader.rewind();
+    EXPECT_EQ(reader.next()->time, 0);
+  }
+
+  EXPECT_THROW(taktile::CaptureReader("/nonexistent/capture"),
+               std::system_error);
+  TempFile const empty;
+  EXPECT_THROW(taktile::CaptureReader{empty.path()}, std::invalid_argument);
+}
+
+TEST(Capture, concurrent_writers_and_unclosed_file) {
+  /// Test that concurrent appends all land, that a full file drops, and that
+  /// a file read while still being written stops at the last complete record
+  TempFile const file;
+  taktile::CaptureOptions options;
+  options.max_size = 64 * 1024;
+  taktile::CaptureWriter writer{file.path(), options};
+  constexpr int THREADS{4};
+  constexpr int64_t RECORDS{1000};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < THREADS; ++t) {
+    threads.emplace_back([&writer] {
+      for (int64_t i = 0; i < RECORDS; ++i) {
+        append(writer, i, payload(i));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  auto const stats = writer.stats();
+  EXPECT_GT(stats.records, 0U);
+  EXPECT_GT(stats.dropped, 0U);
+  EXPECT_EQ(stats.records + stats.dropped, THREADS * RECORDS);
+
+  auto const count = [&file] {
+    taktile::CaptureReader reader{file.path()};
+    uint64_t records{0};
+    while (reader.next()) {
+      ++records;
+    }
+    return records;
+  };
+  EXPECT_EQ(count(), stats.records);
+  writer.close();
+  EXPECT_FALSE(append(writer, 0, "closed"));
+  EXPECT_EQ(count(), stats.records);
+
+  EXPECT_THROW(taktile::CaptureWriter(file.path(), {16, 1}),
+               std::invalid_argument);
+  EXPECT_THROW(taktile::CaptureWriter(file.path(), {1024, 0}),
+               std::invalid_argument);
+}
+
+TEST(Capture, replay_paces_records) {
+  /// Test that replay keeps the recorded spacing divided by speed, runs
+  /// flat out at speed 0 and honours a time range
+  TempFile const file;
+  write_records(file.path(), 11);
+  // Stretch the records to 20 ms apart by replaying at 1/20 of 1x.
+  taktile::CaptureReader reader{file.path()};
+  std::vector<int64_t> times;
+  int flushes{0};
+  taktile::ReplayOptions options;
+  options.speed = 0.05;
+  auto stats = taktile::replay(
+      reader, options,
+      [&times](taktile::CaptureRecord const& record) {
+        times.push_back(record.time);
+      },
+      [&flushes] { ++flushes; });
+  EXPECT_EQ(stats.records, 11U);
+  EXPECT_GE(stats.seconds, 0.2);
+  EXPECT_GE(flushes, 10);
+  EXPECT_EQ(times.back(), 10 * MILLISECOND);
+
+  reader.rewind();
+  options.speed = 0.5;
+  stats = taktile::replay(reader, options,
+                          [](taktile::CaptureRecord const&) {});
+  EXPECT_GE(stats.seconds, 0.02);
+  EXPECT_LT(stats.seconds, 0.2);
+
+  reader.rewind();
+  options.speed = 0.0;
+  options.from = 3 * MILLISECOND;
+  options.to = 7 * MILLISECOND;
+  times.clear();
+  stats = taktile::replay(reader, options,
+                          [&times](taktile::CaptureRecord const& record) {
+                            times.push_back(record.time);
+                          });
+  EXPECT_EQ(times, (std::vector<int64_t>{3 * MILLISECOND, 4 * MILLISECOND,
+                                         5 * MILLISECOND, 6 * MILLISECOND,
+                                         7 * MILLISECOND}));
+  EXPECT_LT(stats.seconds, 0.02);
+
+  options.speed = -1.0;
+  EXPECT_THROW(taktile::replay(reader, options,
+                               [](taktile::CaptureRecord const&) {}),
+               std::invalid_argument);
+}
+
+TEST(Capture, record_from_receiver_and_replay_over_udp) {
+  /// Test that a receiver records every datagram and that the capture
+  /// replays through a UDP sender to another receiver
+  TempFile const file;
+  auto const capture = std::make_shared<taktile::CaptureWriter>(file.path());
+  taktile::UdpReceiverOptions options;
+  options.capture = capture;
+  taktile::CotUdpReceiver recorder{
+      taktile::URL(taktile::Scheme::UDP, "127.0.0.1", 0),
+      std::make_shared<taktile::CotDirectXmlSerializer>(),
+      [](taktile::CotType&&) {}, options};
+  recorder.start();
+  taktile::CotUdpSender sender{
+      taktile::URL(taktile::Scheme::UDP, "127.0.0.1", recorder.port())};
+  auto serializer = taktile::CotDirectXmlSerializer();
+  for (int i = 0; i < 100; ++i) {
+    sender.enqueue(taktile::CotType("track-" + std::to_string(i)), serializer);
+  }
+  ASSERT_EQ(sender.flush().sent, 100U);
+  ASSERT_TRUE(wait_for(recorder, 100));
+  recorder.stop();
+  capture->close();
+  EXPECT_EQ(capture->stats().records, 100U);
+
+  std::atomic<int> decoded{0};
+  taktile::CotUdpReceiver replayed{
+      taktile::URL(taktile::Scheme::UDP, "127.0.0.1", 0),
+      std::make_shared<taktile::CotDirectXmlSerializer>(),
+      [&decoded](taktile::CotType&&) { ++decoded; }};
+  replayed.start();
+  taktile::CaptureReader reader{file.path()};
+  auto const source = reader.next()->source;
+  EXPECT_EQ(source, "udp://127.0.0.1:" + std::to_string(recorder.port()));
+  reader.rewind();
+  taktile::CotUdpSender replayer{
+      taktile::URL(taktile::Scheme::UDP, "127.0.0.1", replayed.port())};
+  taktile::ReplayOptions replay_options;
+  replay_options.speed = 0.0;
+  auto const stats = taktile::replay(reader, replay_options, replayer);
+  EXPECT_EQ(stats.records, 100U);
+  EXPECT_EQ(replayer.stats().sent, 100U);
+  ASSERT_TRUE(wait_for(replayed, 100));
+  replayed.stop();
+  EXPECT_EQ(decoded.load(), 100);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,197 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "taktile/compact_cot.hpp"
+#include "taktile/xml_parser.hpp"
+#include "taktile/xml_writer.hpp"
+
+namespace {
+
+taktile::CotType sample_cot() {
+  auto cot = taktile::CotType("taco");
+  cot.lat = -33.8688;
+  cot.lon = 151.2093;
+  cot.ce = 5.0;
+  cot.hae = 100.0;
+  cot.le = 10.0;
+  cot.cot_type = "a-f-G-U-C";
+  return cot;
+}
+
+std::string_view as_text(std::byte const* data, std::size_t size) {
+  return {reinterpret_cast<char const*>(data), size};
+}
+
+}  // namespace
+
+TEST(CompactCot, interner) {
+  /// Test that equal strings share an id and ids map back to their text
+  taktile::StringInterner interner;
+  auto const taco = interner.intern("taco");
+  auto const burrito = interner.intern(std::string("burrito"));
+  EXPECT_NE(taco, burrito);
+  EXPECT_EQ(interner.intern(std::string("ta") + "co"), taco);
+  EXPECT_EQ(interner.view(taco), "taco");
+  EXPECT_EQ(interner.view(burrito), "burrito");
+  EXPECT_EQ(interner.find("burrito"), burrito);
+  EXPECT_FALSE(interner.find("nacho").has_value());
+  EXPECT_EQ(interner.size(), 2);
+  EXPECT_THROW(static_cast<void>(interner.view(2)), std::out_of_range);
+}
+
+TEST(CompactCot, interner_empty_string) {
+  /// Test that an empty string can be interned first and round-trips
+  taktile::StringInterner interner;
+  auto const empty = interner.intern("");
+  EXPECT_EQ(interner.view(empty), "");
+  EXPECT_EQ(interner.intern(std::string()), empty);
+  EXPECT_NE(interner.intern("taco"), empty);
+
+  taktile::StringInterner fresh;
+  auto cot = sample_cot();
+  cot.uid.clear();
+  auto const compacted = taktile::compact(cot, fresh);
+  EXPECT_EQ(fresh.view(compacted.uid), "");
+  EXPECT_EQ(fresh.view(compacted.cot_type), "a-f-G-U-C");
+}
+
+TEST(CompactCot, interner_views_are_stable) {
+  /// Test that views survive growth past a chunk, including oversize strings
+  taktile::StringInterner interner;
+  auto const first = interner.view(interner.intern("first"));
+  auto const big = interner.view(interner.intern(std::string(100000, 'x')));
+  for (int i = 0; i < 20000; ++i) {
+    interner.intern("uid-" + std::to_string(i));
+  }
+  EXPECT_EQ(first, "first");
+  EXPECT_EQ(big, std::string(100000, 'x'));
+  EXPECT_EQ(interner.view(*interner.find("uid-12345")), "uid-12345");
+  EXPECT_EQ(interner.size(), 20002);
+}
+
+TEST(CompactCot, interner_is_thread_safe) {
+  /// Test that concurrent interning agrees on one id per string
+  taktile::StringInterner interner;
+  std::vector<std::vector<taktile::InternId>> ids(4);
+  std::vector<std::thread> threads;
+  for (auto& thread_ids : ids) {
+    threads.emplace_back([&interner, &thread_ids] {
+      for (int i = 0; i < 1000; ++i) {
+        thread_ids.push_back(interner.intern("uid-" + std::to_string(i)));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(interner.size(), 1000);
+  for (auto const& thread_ids : ids) {
+    EXPECT_EQ(thread_ids, ids.front());
+  }
+}
+
+TEST(CompactCot, compact_and_expand) {
+  /// Test that a CotType survives a trip through its compact form
+  taktile::StringInterner interner;
+  auto const cot = sample_cot();
+  auto const compact = taktile::compact(cot, interner);
+  EXPECT_EQ(interner.view(compact.uid), "taco");
+  EXPECT_EQ(interner.view(compact.cot_type), "a-f-G-U-C");
+
+  auto const expanded = taktile::expand(compact, interner);
+  EXPECT_EQ(expanded.uid, cot.uid);
+  EXPECT_EQ(expanded.cot_type, cot.cot_type);
+  EXPECT_EQ(expanded.lat, cot.lat);
+  EXPECT_EQ(expanded.lon, cot.lon);
+  EXPECT_EQ(expanded.ce, cot.ce);
+  EXPECT_EQ(expanded.hae, cot.hae);
+  EXPECT_EQ(expanded.le, cot.le);
+  EXPECT_EQ(expanded.time, cot.time);
+  EXPECT_EQ(expanded.start, cot.start);
+  EXPECT_EQ(expanded.stale, cot.stale);
+}
+
+TEST(CompactCot, write_matches_cot_type) {
+  /// Test that both writers produce the same bytes, up to the flow-tag time
+  taktile::StringInterner interner;
+  auto cot = sample_cot();
+  cot.uid = "taco & \"friends\"";
+  std::array<std::byte, taktile::MAX_UDP_BLOB_SIZE> expected{};
+  std::array<std::byte, taktile::MAX_UDP_BLOB_SIZE> actual{};
+  auto const expected_size =
+      taktile::write_cot_xml(cot, expected.data(), expected.size());
+  auto const actual_size =
+      taktile::write_cot_xml(taktile::compact(cot, interner), interner,
+                             actual.data(), actual.size());
+
+  // Everything before the flow-tag timestamp is deterministic.
+  auto const expected_xml = as_text(expected.data(), expected_size);
+  auto const actual_xml = as_text(actual.data(), actual_size);
+  auto const prefix = expected_xml.substr(0, expected_xml.find("<detail>"));
+  EXPECT_EQ(actual_xml.substr(0, prefix.size()), prefix);
+  EXPECT_EQ(actual_size, expected_size);
+
+  std::array<std::byte, 64> small{};
+  EXPECT_THROW(taktile::write_cot_xml(taktile::compact(cot, interner),
+                                      interner, small.data(), small.size()),
+               std::length_error);
+}
+
+TEST(CompactCot, read_round_trip) {
+  /// Test that a compact event reads back from XML with the same fields
+  taktile::StringInterner interner;
+  auto cot = sample_cot();
+  cot.uid = "taco & \"friends\"";
+  std::array<std::byte, taktile::MAX_UDP_BLOB_SIZE> buffer{};
+  auto const size = taktile::write_cot_xml(cot, buffer.data(), buffer.size());
+
+  auto const compact =
+      taktile::read_compact_cot_xml(as_text(buffer.data(), size), interner);
+  EXPECT_EQ(interner.view(compact.uid), cot.uid);
+  EXPECT_EQ(interner.view(compact.cot_type), cot.cot_type);
+  EXPECT_DOUBLE_EQ(compact.lat, cot.lat);
+  EXPECT_DOUBLE_EQ(compact.lon, cot.lon);
+  EXPECT_DOUBLE_EQ(compact.ce, cot.ce);
+  EXPECT_DOUBLE_EQ(compact.hae, cot.hae);
+  EXPECT_DOUBLE_EQ(compact.le, cot.le);
+  EXPECT_EQ(compact.time, cot.time);
+  EXPECT_EQ(compact.start, cot.start);
+  EXPECT_EQ(compact.stale, cot.stale);
+
+  // A second read of the same track interns nothing new.
+  taktile::read_compact_cot_xml(as_text(buffer.data(), size), interner);
+  EXPECT_EQ(interner.size(), 2);
+}
+
+TEST(CompactCot, read_malformed_throws) {
+  /// Test that invalid events are rejected without growing the interner
+  taktile::StringInterner interner;
+  auto const read = [&interner](std::string_view xml) {
+    return taktile::read_compact_cot_xml(xml, interner);
+  };
+  EXPECT_THROW(read(""), std::invalid_argument);
+  EXPECT_THROW(read("<foo/>"), std::invalid_argument);
+  EXPECT_THROW(read("<event uid=\"taco\"/>"), std::invalid_argument);
+  EXPECT_THROW(read("<event uid=\"\"><point/></event>"),
+               std::invalid_argument);
+  EXPECT_THROW(read("<event uid=\"taco\"><point lat=\"abc\"/></event>"),
+               std::invalid_argument);
+  EXPECT_THROW(read("<event uid=\"taco\" stale=\"1\"><point lat=\"91\" "
+                    "lon=\"0\" le=\"0\" hae=\"0\" ce=\"0\"/></event>"),
+               std::invalid_argument);
+  EXPECT_EQ(interner.size(), 0);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
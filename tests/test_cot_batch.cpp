@@ -0,0 +1,161 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "taktile/cot_batch.hpp"
+#include "taktile/xml_parser.hpp"
+#include "taktile/xml_writer.hpp"
+
+namespace {
+
+bool is_valid(taktile::CotType const& cot) {
+  try {
+    taktile::CotType::validate(cot);
+    return true;
+  } catch (std::invalid_argument const&) {
+    return false;
+  }
+}
+
+bool bit(std::vector<uint64_t> const& mask, std::size_t i) {
+  return ((mask[i / 64] >> (i % 64)) & 1) != 0;
+}
+
+}  // namespace
+
+TEST(CotBatch, columns_round_trip) {
+  /// Test that rows pushed into a batch come back out unchanged
+  taktile::CotBatch batch;
+  auto cot = taktile::CotType("taco");
+  cot.lat = 1.5;
+  cot.lon = -2.5;
+  cot.cot_type = "a-f-G";
+  batch.push_back(cot);
+  batch.resize(3);
+  EXPECT_EQ(batch.size(), 3);
+  batch.lat()[2] = 45.0;
+  batch.uid()[2] = "burrito";
+
+  auto const first = batch.row(0);
+  EXPECT_EQ(first.uid, "taco");
+  EXPECT_EQ(first.cot_type, "a-f-G");
+  EXPECT_EQ(first.lat, 1.5);
+  EXPECT_EQ(first.lon, -2.5);
+  EXPECT_EQ(first.stale, cot.stale);
+  EXPECT_EQ(batch.row(2).lat, 45.0);
+  EXPECT_EQ(batch.row(2).uid, "burrito");
+  EXPECT_EQ(batch.row(1).ce, taktile::DEFAULT_COT_VAL);
+  EXPECT_THROW(static_cast<void>(batch.row(3)), std::out_of_range);
+
+  batch.restamp(1000);
+  EXPECT_EQ(batch.time()[1], 1000);
+  EXPECT_EQ(batch.stale()[1], 1000 + taktile::DEFAULT_COT_STALE * 1000);
+  EXPECT_EQ(batch.stale()[0] - batch.start()[0], cot.stale - cot.start);
+
+  batch.clear();
+  EXPECT_EQ(batch.size(), 0);
+  EXPECT_TRUE(batch.validate().empty());
+}
+
+TEST(CotBatch, validate_matches_cot_type) {
+  /// Test that the batch mask agrees with CotType::validate row by row,
+  /// including boundary values, NaN and a tail shorter than a vector
+  std::vector<double> const values{
+      0.0,   -0.0,    1.0,   -1.0,   89.999, 90.0,
+      90.01, -90.0,   -90.1, 180.0,  -180.0, 180.5,
+      -181.0, std::numeric_limits<double>::quiet_NaN(), 1e300, -1e300};
+  std::mt19937 rng{7};
+  std::uniform_int_distribution<std::size_t> pick{0, values.size() - 1};
+  std::uniform_int_distribution<int> one_in{0, 40};
+
+  taktile::CotBatch batch;
+  std::vector<taktile::CotType> cots;
+  for (int i = 0; i < 1003; ++i) {
+    auto cot = taktile::CotType("track-" + std::to_string(i));
+    cot.lat = values[pick(rng)];
+    cot.lon = values[pick(rng)];
+    cot.ce = values[pick(rng)];
+    cot.hae = std::abs(values[pick(rng)]);
+    cot.le = std::abs(values[pick(rng)]);
+    if (one_in(rng) == 0) {
+      cot.uid.clear();
+    }
+    if (one_in(rng) == 0) {
+      cot.cot_type.clear();
+    }
+    batch.push_back(cot);
+    cots.push_back(cot);
+  }
+
+  auto const mask = batch.validate();
+  ASSERT_EQ(mask.size(), (cots.size() + 63) / 64);
+  std::size_t invalid = 0;
+  for (std::size_t i = 0; i < cots.size(); ++i) {
+    EXPECT_EQ(bit(mask, i), !is_valid(cots[i])) << "row " << i;
+    invalid += bit(mask, i) ? 1 : 0;
+  }
+  EXPECT_GT(invalid, 0);
+  EXPECT_LT(invalid, cots.size());
+}
+
+TEST(CotBatch, serialize_matches_single_events) {
+  /// Test that a batch serializes to the same events as row-by-row writes,
+  /// all sharing one flow-tag time
+  taktile::CotBatch batch;
+  for (int i = 0; i < 50; ++i) {
+    auto cot = taktile::CotType("track-" + std::to_string(i));
+    cot.lat = i * 0.5;
+    cot.lon = -i * 1.5;
+    cot.cot_type = "a-f-G-U-C";
+    batch.push_back(cot);
+  }
+  std::vector<std::byte> out;
+  std::vector<std::size_t> ends;
+  taktile::write_cot_xml(batch, out, ends);
+  ASSERT_EQ(ends.size(), batch.size());
+  EXPECT_EQ(out.size(), ends.back());
+
+  std::size_t begin = 0;
+  std::string_view flow_tags;
+  for (std::size_t i = 0; i < batch.size(); ++i) {
+    auto const xml = std::string_view(
+        reinterpret_cast<char const*>(out.data()) + begin, ends[i] - begin);
+    auto const cot = taktile::read_cot_xml(xml);
+    EXPECT_EQ(cot.uid, batch.uid()[i]);
+    EXPECT_DOUBLE_EQ(cot.lat, batch.lat()[i]);
+    EXPECT_DOUBLE_EQ(cot.lon, batch.lon()[i]);
+    EXPECT_EQ(cot.stale, batch.stale()[i]);
+
+    std::array<std::byte, taktile::MAX_UDP_BLOB_SIZE> single{};
+    auto const size =
+        taktile::write_cot_xml(batch.row(i), single.data(), single.size());
+    auto const expected =
+        std::string_view(reinterpret_cast<char const*>(single.data()), size);
+    auto const detail = expected.find("<detail>");
+    EXPECT_EQ(xml.substr(0, detail), expected.substr(0, detail));
+    if (i == 0) {
+      flow_tags = xml.substr(xml.find("<detail>"));
+    }
+    EXPECT_EQ(xml.substr(xml.find("<detail>")), flow_tags);
+    begin = ends[i];
+  }
+
+  batch.uid()[7] = std::string(taktile::MAX_UDP_BLOB_SIZE, 'x');
+  EXPECT_THROW(taktile::write_cot_xml(batch, out, ends), std::length_error);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,138 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "taktile/cot_template.hpp"
+#include "taktile/datetime.hpp"
+#include "taktile/xml_parser.hpp"
+
+namespace {
+
+using Buffer = std::array<std::byte, taktile::MAX_UDP_BLOB_SIZE>;
+
+std::string_view as_text(Buffer const& buffer, std::size_t size) {
+  return {reinterpret_cast<char const*>(buffer.data()), size};
+}
+
+std::string fixed(double value, std::size_t width) {
+  std::array<std::byte, 32> buffer{};
+  taktile::XmlWriter writer{buffer.data(), buffer.size()};
+  writer.fixed(value, width);
+  if (writer.overflowed()) {
+    return "overflow";
+  }
+  return {reinterpret_cast<char const*>(buffer.data()), writer.size()};
+}
+
+}  // namespace
+
+TEST(CotTemplate, fixed_width_numbers) {
+  /// Test zero-padded fixed-width formatting of positions
+  EXPECT_EQ(fixed(37.7749, 10), "037.774900");
+  EXPECT_EQ(fixed(-37.7749, 10), "-37.774900");
+  EXPECT_EQ(fixed(0.0, 10), "000.000000");
+  EXPECT_EQ(fixed(-90.0, 10), "-90.000000");
+  EXPECT_EQ(fixed(-122.4194, 11), "-122.419400");
+  EXPECT_EQ(fixed(5.5, 11), "0005.500000");
+  EXPECT_EQ(fixed(180.0, 10), "overflow");
+  EXPECT_EQ(fixed(NAN, 10), "overflow");
+  EXPECT_EQ(fixed(-INFINITY, 11), "overflow");
+  EXPECT_DOUBLE_EQ(std::stod(fixed(-5.5, 11)), -5.5);
+}
+
+TEST(CotTemplate, emit_restamps) {
+  /// Test that an emitted heartbeat carries the new times and keeps its
+  /// time-to-stale
+  auto const hello = taktile::hello_event("taco");
+  taktile::CotTemplate const heartbeat{hello, taktile::MAX_UDP_BLOB_SIZE};
+
+  Buffer buffer{};
+  auto const now = hello.time + 60000;
+  auto const size = heartbeat.emit(now, buffer.data(), buffer.size());
+  EXPECT_EQ(size, heartbeat.size());
+  auto const cot = taktile::read_cot_xml(as_text(buffer, size));
+  EXPECT_EQ(cot.uid, "taco");
+  EXPECT_EQ(cot.cot_type, "t-x-d-d");
+  EXPECT_EQ(cot.time, now);
+  EXPECT_EQ(cot.start, now);
+  EXPECT_EQ(cot.stale, now + (hello.stale - hello.start));
+  EXPECT_DOUBLE_EQ(cot.lat, hello.lat);
+  EXPECT_DOUBLE_EQ(cot.lon, hello.lon);
+
+  auto const text = as_text(buffer, size);
+  auto const flow_tag = text.find("<_flow-tags_ ");
+  ASSERT_NE(flow_tag, std::string_view::npos);
+  EXPECT_NE(text.find(taktile::format_w3c_datetime(now), flow_tag),
+            std::string_view::npos);
+}
+
+TEST(CotTemplate, emit_moves) {
+  /// Test that an emitted position matches a freshly serialized event,
+  /// apart from the padding of lat and lon
+  auto cot = taktile::CotType("burrito");
+  cot.lat = 1.25;
+  cot.lon = 2.5;
+  cot.cot_type = "a-f-G-U-C";
+  taktile::CotTemplate const periodic{cot};
+
+  Buffer buffer{};
+  auto const now = cot.time + 1000;
+  auto const size =
+      periodic.emit(now, -33.8688, -151.2093, buffer.data(), buffer.size());
+  EXPECT_NE(as_text(buffer, size).find("lat=\"-33.868800\""),
+            std::string_view::npos);
+  EXPECT_NE(as_text(buffer, size).find("lon=\"-151.209300\""),
+            std::string_view::npos);
+
+  cot.restamp(now);
+  cot.lat = -33.8688;
+  cot.lon = -151.2093;
+  Buffer expected{};
+  auto const expected_size =
+      taktile::write_cot_xml(cot, expected.data(), expected.size());
+  auto const fresh = as_text(expected, expected_size);
+  auto const emitted = as_text(buffer, size);
+  auto const point = fresh.find("<point");
+  EXPECT_EQ(emitted.substr(0, point), fresh.substr(0, point));
+
+  auto const moved = taktile::read_cot_xml(emitted);
+  EXPECT_DOUBLE_EQ(moved.lat, -33.8688);
+  EXPECT_DOUBLE_EQ(moved.lon, -151.2093);
+  EXPECT_EQ(moved.time, now);
+}
+
+TEST(CotTemplate, rejects_bad_input) {
+  /// Test that invalid events, positions and buffers are rejected
+  auto cot = taktile::CotType("taco");
+  cot.lat = 100.0;
+  EXPECT_THROW(taktile::CotTemplate{cot}, std::invalid_argument);
+  cot.lat = 0.0;
+  EXPECT_THROW(taktile::CotTemplate(cot, 64), std::length_error);
+
+  taktile::CotTemplate const periodic{cot};
+  Buffer buffer{};
+  EXPECT_THROW(periodic.emit(0, 91.0, 0.0, buffer.data(), buffer.size()),
+               std::invalid_argument);
+  EXPECT_THROW(periodic.emit(0, 0.0, -181.0, buffer.data(), buffer.size()),
+               std::invalid_argument);
+  EXPECT_THROW(periodic.emit(0, NAN, 0.0, buffer.data(), buffer.size()),
+               std::invalid_argument);
+  EXPECT_THROW(periodic.emit(0, 0.0, NAN, buffer.data(), buffer.size()),
+               std::invalid_argument);
+  cot.lon = NAN;
+  EXPECT_THROW(taktile::CotTemplate{cot}, std::invalid_argument);
+  EXPECT_THROW(periodic.emit(0, buffer.data(), periodic.size() - 1),
+               std::length_error);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,103 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "taktile/cot_view.hpp"
+
+namespace {
+
+std::vector<std::byte> blob(std::string_view xml) {
+  auto const* const data = reinterpret_cast<std::byte const*>(xml.data());
+  return {data, data + xml.size()};
+}
+
+std::vector<std::byte> event(std::string const& type, std::string const& uid) {
+  auto cot = taktile::CotType(uid);
+  cot.cot_type = type;
+  return taktile::CotDirectXmlSerializer().serialize(cot);
+}
+
+}  // namespace
+
+TEST(CotView, reads_event_tag_only) {
+  /// Test that uid and type are read without parsing the rest of the event
+  auto const truncated =
+      blob("<?xml version=\"1.0\"?><event type=\"a-f-G\" uid=\"taco\">"
+           "<point lat=\"not a number\"");
+  taktile::CotView const view{truncated};
+  EXPECT_EQ(view.uid(), "taco");
+  EXPECT_EQ(view.cot_type(), "a-f-G");
+  EXPECT_THROW(static_cast<void>(view.decode()), std::invalid_argument);
+
+  auto const complete = event("a-f-G-U-C", "burrito");
+  auto const cot = taktile::CotView(complete).decode();
+  EXPECT_EQ(cot.uid, "burrito");
+  EXPECT_EQ(cot.cot_type, "a-f-G-U-C");
+
+  auto const garbage = blob("<not-cot/>");
+  EXPECT_THROW(static_cast<void>(taktile::CotView(garbage).uid()),
+               std::invalid_argument);
+}
+
+TEST(CotFilter, type_hierarchy) {
+  /// Test prefix and wildcard matching over CoT type levels
+  taktile::CotFilter filter;
+  EXPECT_TRUE(filter.matches("anything", "anyone"));
+
+  filter.allow_type("a-f-*");
+  filter.allow_type("a-*-A");
+  filter.allow_type("b-m-p-s-p-i");
+  EXPECT_TRUE(filter.matches("a-f", "x"));
+  EXPECT_TRUE(filter.matches("a-f-G-U-C", "x"));
+  EXPECT_FALSE(filter.matches("a-fx-G", "x"));
+  EXPECT_FALSE(filter.matches("a", "x"));
+  EXPECT_FALSE(filter.matches("a-h-G", "x"));
+  EXPECT_TRUE(filter.matches("a-h-A-M-F", "x"));
+  EXPECT_TRUE(filter.matches("a-n-A", "x"));
+  EXPECT_FALSE(filter.matches("a-n-G-A", "x"));
+  EXPECT_TRUE(filter.matches("b-m-p-s-p-i", "x"));
+  EXPECT_FALSE(filter.matches("b-m-p-s-p", "x"));
+  EXPECT_FALSE(filter.matches("", "x"));
+  EXPECT_THROW(filter.allow_type(""), std::invalid_argument);
+}
+
+TEST(CotFilter, uids_and_views) {
+  /// Test uid following, escaped values and malformed events
+  taktile::CotFilter filter;
+  filter.follow_uid("taco");
+  filter.follow_uid("R&D");
+  filter.follow_uid(std::string("taco"));
+  EXPECT_TRUE(filter.matches("a-h-G", "taco"));
+  EXPECT_FALSE(filter.matches("a-h-G", "burrito"));
+
+  filter.allow_type("a-f");
+  EXPECT_FALSE(filter.matches("a-h-G", "taco"));
+  EXPECT_TRUE(filter.matches(taktile::CotView(event("a-f-G", "taco"))));
+  EXPECT_TRUE(filter.matches(taktile::CotView(event("a-f-G", "R&D"))));
+  EXPECT_FALSE(filter.matches(taktile::CotView(event("a-f-G", "nacho"))));
+  EXPECT_FALSE(filter.matches(taktile::CotView(event("a-h-G", "taco"))));
+  EXPECT_FALSE(filter.matches(taktile::CotView(blob("<event uid=\"taco"))));
+
+  // Literal whitespace in a value is normalized to spaces, as decode() does.
+  taktile::CotFilter spaced;
+  spaced.follow_uid("taco truck");
+  auto const tabbed = blob(
+      "<event version=\"2.0\" uid=\"taco\ttruck\" type=\"a-f-G\" "
+      "time=\"2025-01-01T00:00:00.000Z\" start=\"2025-01-01T00:00:00.000Z\" "
+      "stale=\"2025-01-01T00:02:00.000Z\"><point lat=\"0\" lon=\"0\" "
+      "hae=\"0\" ce=\"0\" le=\"0\"/></event>");
+  taktile::CotView const view{tabbed};
+  EXPECT_TRUE(spaced.matches(view));
+  EXPECT_EQ(view.decode().uid, "taco truck");
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,78 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include <gtest/gtest.h>
+
+#include <array>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "taktile/datetime.hpp"
+
+TEST(Datetime, format_epoch) {
+  /// Test that the Unix epoch is formatted as a W3C XML datetime
+  EXPECT_EQ(taktile::format_w3c_datetime(0), "1970-01-01T00:00:00.000Z");
+}
+
+TEST(Datetime, format_known_values) {
+  /// Test formatting across leap days, century boundaries and pre-epoch times
+  EXPECT_EQ(taktile::format_w3c_datetime(951782400123),
+            "2000-02-29T00:00:00.123Z");
+  EXPECT_EQ(taktile::format_w3c_datetime(1700000000999),
+            "2023-11-14T22:13:20.999Z");
+  EXPECT_EQ(taktile::format_w3c_datetime(4102444799000),
+            "2099-12-31T23:59:59.000Z");
+  EXPECT_EQ(taktile::format_w3c_datetime(-1), "1969-12-31T23:59:59.999Z");
+}
+
+TEST(Datetime, format_reuses_cached_prefix) {
+  /// Test that interleaving seconds through the per-thread cache stays correct
+  std::array<char, taktile::W3C_DATETIME_LENGTH> buffer{};
+  for (int64_t i = 0; i < 10; ++i) {
+    auto const now = 1700000000000 + i * 7;
+    auto const stale = now + 120000;
+    taktile::format_w3c_datetime(now, buffer.data());
+    EXPECT_EQ(std::string(buffer.data(), buffer.size()),
+              taktile::format_w3c_datetime(now));
+    EXPECT_EQ(taktile::parse_w3c_datetime({buffer.data(), buffer.size()}),
+              now);
+    taktile::format_w3c_datetime(stale, buffer.data());
+    EXPECT_EQ(taktile::parse_w3c_datetime({buffer.data(), buffer.size()}),
+              stale);
+  }
+}
+
+TEST(Datetime, parse_variants) {
+  /// Test that other fractional precisions and zone offsets are accepted
+  EXPECT_EQ(taktile::parse_w3c_datetime("2020-01-01T00:00:00Z"),
+            1577836800000);
+  EXPECT_EQ(taktile::parse_w3c_datetime("2020-01-01T00:00:00.5Z"),
+            1577836800500);
+  EXPECT_EQ(taktile::parse_w3c_datetime("2020-01-01T00:00:00.123456Z"),
+            1577836800123);
+  EXPECT_EQ(taktile::parse_w3c_datetime("2020-01-01T01:30:00.000+01:30"),
+            1577836800000);
+}
+
+TEST(Datetime, parse_invalid_throws) {
+  /// Test that malformed datetimes are rejected
+  for (std::string_view text :
+       {"", "2020", "2020-13-01T00:00:00Z", "2021-02-29T00:00:00Z",
+        "2020-01-01 00:00:00Z", "2020-01-01T24:00:00Z",
+        "2020-01-01T00:00:00.Z", "2020-01-01T00:00:00.000Zjunk"}) {
+    EXPECT_THROW(taktile::parse_w3c_datetime(text), std::invalid_argument)
+        << text;
+  }
+}
+
+TEST(Datetime, round_trip_now) {
+  /// Test that the current time survives a format/parse round trip
+  auto const now = taktile::now_ms();
+  EXPECT_EQ(taktile::parse_w3c_datetime(taktile::format_w3c_datetime(now)),
+            now);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
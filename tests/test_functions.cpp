@@ -7,11 +7,15 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <array>
 #include <memory>
 #include <regex>
 #include <simpleio/messages/xml.hpp>
+#include <string>
 #include <utility>
+#include <vector>
 
+#include "taktile/datetime.hpp"
 #include "taktile/functions.hpp"
 
 static std::regex const W3C_XML_DATETIME_REGEX(
@@ -107,6 +111,45 @@ TEST(Functions, construct_cot_url_invalid_scheme_throws) {
   EXPECT_THROW(taktile::URL("www.example.com"), std::invalid_argument);
 }
 
+TEST(Functions, url_round_trips_every_scheme) {
+  /// Test that each scheme's name maps back to it and that to_string output
+  /// parses back to the same URL
+  for (auto const& name : taktile::SCHEME_NAMES) {
+    auto const scheme = taktile::parse_scheme(name);
+    ASSERT_TRUE(scheme.has_value());
+    EXPECT_EQ(taktile::scheme_name(*scheme), name);
+    auto const url = taktile::URL{*scheme, "239.2.3.1", 4242};
+    auto const parsed = taktile::URL(taktile::to_string(url));
+    EXPECT_EQ(parsed.scheme, url.scheme);
+    EXPECT_EQ(parsed.net_loc, url.net_loc);
+    EXPECT_EQ(parsed.port, url.port);
+  }
+  EXPECT_FALSE(taktile::parse_scheme("udp+multicast").has_value());
+  EXPECT_FALSE(taktile::parse_scheme("").has_value());
+  EXPECT_EQ(taktile::URL("udp+wo://localhost").port,
+            taktile::DEFAULT_BROADCAST_PORT);
+  EXPECT_EQ(taktile::URL("tcp://tak-server.local:65535").port, 65535);
+}
+
+TEST(Functions, default_host_id_override) {
+  /// Test that the host id is looked up lazily and that overrides reach new
+  /// events and flow tags
+  auto const original = taktile::default_host_id();
+  EXPECT_EQ(original.rfind("taktile@", 0), 0U);
+  EXPECT_EQ(taktile::CotType().uid, original);
+
+  taktile::set_default_host_id("taktile@sensor-7");
+  EXPECT_EQ(taktile::default_host_id(), "taktile@sensor-7");
+  EXPECT_EQ(taktile::CotType().uid, "taktile@sensor-7");
+  auto const blob =
+      taktile::CotDirectXmlSerializer().serialize(taktile::CotType("x"));
+  EXPECT_TRUE(contains_substring(
+      blob, fmt::format("taktile-sensor-7-v{}=", taktile::VERSION)));
+
+  taktile::set_default_host_id(original);
+  EXPECT_EQ(taktile::CotType().uid, original);
+}
+
 TEST(Functions, cot_message_get_time) {
   /// Test that get_time returns the current system time in W3C XML datetime
   /// format
@@ -159,7 +202,7 @@ TEST(Functions, cot2xml) {
   cot.hae = 100;
   cot.ce = 5;
   cot.cot_type = "a-f-G";
-  cot.stale = 3600;
+  cot.stale = cot.time + 3600 * 1000;
   auto doc = taktile::Cot2Xml::convert(cot);
   EXPECT_NE(doc, nullptr);
   auto root = doc->documentElement();
@@ -175,6 +218,11 @@ TEST(Functions, cot2xml) {
       std::regex_match(root->getAttribute("start"), W3C_XML_DATETIME_REGEX));
   EXPECT_TRUE(
       std::regex_match(root->getAttribute("stale"), W3C_XML_DATETIME_REGEX));
+  EXPECT_EQ(root->getAttribute("time"), taktile::format_w3c_datetime(cot.time));
+  EXPECT_EQ(root->getAttribute("start"),
+            taktile::format_w3c_datetime(cot.start));
+  EXPECT_EQ(root->getAttribute("stale"),
+            taktile::format_w3c_datetime(cot.stale));
 
   auto point_element = root->getChildElement("point");
   EXPECT_NE(point_element, nullptr);
@@ -189,13 +237,215 @@ TEST(Functions, cot2xml) {
   auto flow_tags_element = detail_element->getChildElement("_flow-tags_");
   EXPECT_NE(flow_tags_element, nullptr);
   auto const _ft_tag =
-      fmt::format("{}-v{}", taktile::DEFAULT_HOST_ID, taktile::VERSION);
+      fmt::format("{}-v{}", taktile::default_host_id(), taktile::VERSION);
   auto const _ft_tag_replaced =
       std::regex_replace(_ft_tag, std::regex("@"), "-");
   // Check that the flow tags element contains the expected tag
   EXPECT_NE(flow_tags_element->getAttribute(_ft_tag_replaced), "");
 }
 
+TEST(Functions, direct_xml_serializer_matches_dom) {
+  // Test that the direct serializer produces the same bytes as the DOM path,
+  // up to the timestamps.
+  auto cot = taktile::CotType("test_uid&<\"quoted\">");
+  cot.lat = 37.7749;
+  cot.lon = -122.4194;
+  cot.le = 10;
+  cot.hae = 100;
+  cot.ce = 5;
+  cot.cot_type = "a-f-G";
+  auto dom_serializer = taktile::CotXmlSerializer(
+      std::make_shared<simpleio::messages::XmlSerializer>());
+  auto direct_serializer = taktile::CotDirectXmlSerializer();
+
+  auto const as_string = [](std::vector<std::byte> const& blob) {
+    auto const text = std::string(reinterpret_cast<char const*>(blob.data()),
+                                  blob.size());
+    return std::regex_replace(
+        text,
+        std::regex(R"(\d{4}-\d{2}-\d{2}T\d{2}:\d{2}:\d{2}\.\d{3}Z)"),
+        "<datetime>");
+  };
+  EXPECT_EQ(as_string(direct_serializer.serialize(cot)),
+            as_string(dom_serializer.serialize(cot)));
+}
+
+TEST(Functions, direct_xml_serializer_round_trip) {
+  auto cot = taktile::CotType("taco");
+  cot.lat = -33.8688;
+  cot.lon = 151.2093;
+  auto strategy = std::make_shared<taktile::CotDirectXmlSerializer>(
+      taktile::MAX_UDP_BLOB_SIZE);
+  auto cot_msg =
+      taktile::CotMessage<taktile::MAX_UDP_BLOB_SIZE>(std::move(cot), strategy);
+  EXPECT_TRUE(contains_substring(cot_msg.blob(), "uid=\"taco\""));
+  EXPECT_TRUE(contains_substring(cot_msg.blob(), "lat=\"-33.868800\""));
+  EXPECT_TRUE(contains_substring(cot_msg.blob(), "lon=\"151.209300\""));
+
+  // Decoding in place reads only the given length of a larger buffer.
+  std::array<std::byte, taktile::MAX_UDP_BLOB_SIZE> slot{};
+  slot.fill(std::byte{'x'});
+  auto const& blob = cot_msg.blob();
+  std::copy(blob.begin(), blob.end(), slot.begin());
+  auto const decoded = strategy->deserialize_from(slot.data(), blob.size());
+  EXPECT_EQ(decoded.uid, "taco");
+  EXPECT_DOUBLE_EQ(decoded.lat, -33.8688);
+}
+
+TEST(Functions, direct_xml_serializer_oversize_throws) {
+  // Test that exceeding the message bound fails cleanly instead of writing
+  // past the end of the buffer.
+  auto const cot =
+      taktile::CotType(std::string(taktile::MAX_UDP_BLOB_SIZE, 'x'));
+  auto serializer =
+      taktile::CotDirectXmlSerializer(taktile::MAX_UDP_BLOB_SIZE);
+  EXPECT_THROW(serializer.serialize(cot), std::length_error);
+
+  std::array<std::byte, 64> buffer{};
+  EXPECT_THROW(serializer.serialize_into(taktile::CotType("taco"),
+                                         buffer.data(), buffer.size()),
+               std::length_error);
+}
+
+TEST(Functions, direct_xml_serializer_deserialize_matches_dom) {
+  // Test that the pull parser decodes the same CoT message as the DOM path.
+  auto cot = taktile::CotType("test_uid&<\"quoted\">");
+  cot.lat = 37.7749;
+  cot.lon = -122.4194;
+  cot.le = 10;
+  cot.hae = 100;
+  cot.ce = 5;
+  cot.cot_type = "a-f-G";
+  auto dom_serializer = taktile::CotXmlSerializer(
+      std::make_shared<simpleio::messages::XmlSerializer>());
+  auto direct_serializer = taktile::CotDirectXmlSerializer();
+  auto const blob = dom_serializer.serialize(cot);
+
+  auto const expected = dom_serializer.deserialize(blob);
+  auto const result = direct_serializer.deserialize(blob);
+  EXPECT_EQ(result.uid, expected.uid);
+  EXPECT_EQ(result.cot_type, expected.cot_type);
+  EXPECT_DOUBLE_EQ(result.lat, expected.lat);
+  EXPECT_DOUBLE_EQ(result.lon, expected.lon);
+  EXPECT_DOUBLE_EQ(result.le, expected.le);
+  EXPECT_DOUBLE_EQ(result.hae, expected.hae);
+  EXPECT_DOUBLE_EQ(result.ce, expected.ce);
+  EXPECT_EQ(result.time, expected.time);
+  EXPECT_EQ(result.start, expected.start);
+  EXPECT_EQ(result.stale, expected.stale);
+}
+
+TEST(Functions, timestamps_round_trip) {
+  // Test that time, start and stale survive an encode/decode round trip.
+  auto cot = taktile::CotType("taco");
+  cot.time = 1700000000123;
+  cot.start = 1700000000456;
+  cot.stale = 1700000120789;
+  auto serializer = taktile::CotDirectXmlSerializer();
+  auto const result = serializer.deserialize(serializer.serialize(cot));
+  EXPECT_EQ(result.time, cot.time);
+  EXPECT_EQ(result.start, cot.start);
+  EXPECT_EQ(result.stale, cot.stale);
+}
+
+TEST(Functions, cot_message_restamp) {
+  // Test that restamping keeps the time-to-stale of the message.
+  auto cot = taktile::CotType("taco");
+  EXPECT_EQ(cot.time, cot.start);
+  EXPECT_EQ(cot.stale - cot.time, int64_t{taktile::DEFAULT_COT_STALE} * 1000);
+  cot.stale = cot.start + 5000;
+  cot.restamp(cot.time + 1000);
+  EXPECT_EQ(cot.time, cot.start);
+  EXPECT_EQ(cot.stale - cot.start, 5000);
+}
+
+TEST(Functions, direct_xml_serializer_deserialize_malformed_throws) {
+  // Test that malformed events raise std::invalid_argument, as in the DOM
+  // path.
+  auto serializer = taktile::CotDirectXmlSerializer();
+  auto const deserialize = [&serializer](std::string_view xml) {
+    auto const* const data = reinterpret_cast<std::byte const*>(xml.data());
+    return serializer.deserialize({data, data + xml.size()});
+  };
+  EXPECT_THROW(deserialize(""), std::invalid_argument);
+  EXPECT_THROW(deserialize("<foo/>"), std::invalid_argument);
+  EXPECT_THROW(deserialize("<event uid=\"taco\"/>"), std::invalid_argument);
+  EXPECT_THROW(deserialize("<event uid=\"\"><point/></event>"),
+               std::invalid_argument);
+  EXPECT_THROW(deserialize("<event uid=\"taco\"><point lat=\"abc\"/>"
+                           "</event>"),
+               std::invalid_argument);
+  EXPECT_THROW(deserialize("<event uid=\"taco\" stale=\"1\"><point "
+                           "lat=\"91\" lon=\"0\" le=\"0\" hae=\"0\" "
+                           "ce=\"0\"/></event>"),
+               std::invalid_argument);
+  EXPECT_THROW(deserialize("<event uid=\"taco"), std::invalid_argument);
+  // Truncated after <point>, and an unclosed <point>.
+  EXPECT_THROW(deserialize("<event uid=\"taco\"><point lat=\"0\" lon=\"0\" "
+                           "le=\"0\" hae=\"0\" ce=\"0\"/>"),
+               std::invalid_argument);
+  EXPECT_THROW(deserialize("<event uid=\"taco\"><point lat=\"0\" lon=\"0\" "
+                           "le=\"0\" hae=\"0\" ce=\"0\">garbage"),
+               std::invalid_argument);
+
+  // Only comments, processing instructions and space may follow the root,
+  // and no attribute that is read may repeat.
+  auto const blob = serializer.serialize(taktile::CotType("taco"));
+  auto const xml =
+      std::string(reinterpret_cast<char const*>(blob.data()), blob.size());
+  EXPECT_NO_THROW(deserialize(xml + "\n<!-- trailer -->\n<?pi?>\n"));
+  EXPECT_THROW(deserialize(xml + "garbage"), std::invalid_argument);
+  EXPECT_THROW(deserialize(xml + "<event/>"), std::invalid_argument);
+  auto const repeat = [&xml](std::string const& tag,
+                             std::string const& attribute) {
+    auto copy = xml;
+    auto const at = copy.find(tag) + tag.size();
+    return copy.insert(at, " " + attribute);
+  };
+  EXPECT_THROW(deserialize(repeat("<event", "uid=\"spoof\"")),
+               std::invalid_argument);
+  EXPECT_THROW(deserialize(repeat("<event", "stale=\"0\"")),
+               std::invalid_argument);
+  EXPECT_THROW(deserialize(repeat("<point", "lat=\"1\"")),
+               std::invalid_argument);
+}
+
+TEST(Functions, inline_cot_message) {
+  // Test that an inline message holds the same payload as a CotMessage.
+  auto cot = taktile::CotType("taco");
+  cot.lat = -33.8688;
+  cot.lon = 151.2093;
+  auto serializer = std::make_shared<taktile::CotDirectXmlSerializer>(
+      taktile::MAX_UDP_BLOB_SIZE);
+  auto const message =
+      taktile::InlineCotMessage<taktile::MAX_UDP_BLOB_SIZE>(cot, *serializer);
+  EXPECT_NE(message.view().find("uid=\"taco\""), std::string_view::npos);
+  EXPECT_NE(message.view().find("lat=\"-33.868800\""), std::string_view::npos);
+
+  auto const decoded = serializer->deserialize(
+      {message.data(), message.data() + message.size()});
+  EXPECT_EQ(decoded.uid, cot.uid);
+  EXPECT_EQ(decoded.time, cot.time);
+  EXPECT_DOUBLE_EQ(decoded.lon, cot.lon);
+
+  auto copy = message;
+  EXPECT_EQ(copy.view(), message.view());
+  copy.assign(message.data(), 10);
+  EXPECT_EQ(copy.view(), message.view().substr(0, 10));
+}
+
+TEST(Functions, inline_cot_message_oversize_throws) {
+  // Test that a message larger than the inline capacity is rejected.
+  auto serializer = taktile::CotDirectXmlSerializer();
+  auto message = taktile::InlineCotMessage<64>();
+  EXPECT_THROW(message.assign(taktile::CotType("taco"), serializer),
+               std::length_error);
+  EXPECT_EQ(message.size(), 0);
+  std::array<std::byte, 65> bytes{};
+  EXPECT_THROW(message.assign(bytes.data(), bytes.size()), std::length_error);
+  EXPECT_EQ(message.capacity(), 64);
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,108 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "taktile/functions.hpp"
+#include "taktile/loadgen.hpp"
+#include "taktile/tak_proto.hpp"
+
+TEST(LoadGen, tracks_are_deterministic) {
+  /// Test that a seed fixes every track's path, that paths stay valid, and
+  /// that updates are stamped with their sequence and send time
+  taktile::SyntheticTracks first{8, 42};
+  taktile::SyntheticTracks second{8, 42};
+  taktile::SyntheticTracks other{8, 43};
+  ASSERT_EQ(first.size(), 8U);
+  bool differs{false};
+  for (int step = 0; step < 1000; ++step) {
+    for (std::size_t track = 0; track < first.size(); ++track) {
+      auto const& a = first.next(track, step * 1.5);
+      auto const& b = second.next(track, step * 1.5);
+      auto const& c = other.next(track, step * 1.5);
+      ASSERT_EQ(a.uid, "loadgen-" + std::to_string(track));
+      ASSERT_EQ(a.lat, b.lat);
+      ASSERT_EQ(a.lon, b.lon);
+      ASSERT_EQ(a.hae, b.hae);
+      ASSERT_EQ(a.ce, static_cast<double>(step));
+      ASSERT_EQ(a.le, step * 1.5);
+      ASSERT_NO_THROW(taktile::CotType::validate(a));
+      differs = differs || a.lat != c.lat;
+    }
+  }
+  EXPECT_TRUE(differs);
+}
+
+TEST(LoadGen, monitor_counts_loss_and_reordering) {
+  /// Test latency, loss, reordering and foreign traffic accounting,
+  /// including through both encodings
+  taktile::SyntheticTracks tracks{2, 1};
+  taktile::LoadMonitor monitor{2, std::chrono::steady_clock::now()};
+  std::vector<taktile::CotType> sent;
+  for (int i = 0; i < 6; ++i) {
+    sent.push_back(tracks.next(i % 2, 10.0 * i));
+  }
+  auto xml = taktile::CotDirectXmlSerializer();
+  auto proto = taktile::CotProtoSerializer();
+  // Track 0 sends 0, 1, 2 and track 1 sends 0, 1, 2; receive
+  // 0:0, 0:2, 0:1 (late), 1:0, 1:2 (1:1 lost).
+  for (auto const index : {0, 4, 2, 1, 5}) {
+    taktile::CotSerializer& serializer =
+        index % 2 == 0 ? static_cast<taktile::CotSerializer&>(xml) : proto;
+    auto const cot = serializer.deserialize(serializer.serialize(sent[index]));
+    monitor.record(cot, 10.0 * index + 0.25);
+  }
+  monitor.record(taktile::CotType("someone-else"), 0.0);
+  monitor.record(tracks.next(1, 0.0), 0.0);
+
+  auto const report = monitor.report(6);
+  EXPECT_EQ(report.received, 6U);
+  EXPECT_EQ(report.lost, 0U);
+  EXPECT_EQ(report.reordered, 1U);
+  EXPECT_EQ(report.foreign, 1U);
+  EXPECT_EQ(monitor.report(8).lost, 2U);
+  // 250 us, give or take a bucket; the straggler at 0 lands below.
+  EXPECT_GE(report.p50_ns, 250000U);
+  EXPECT_LE(report.p50_ns, 250000U * 9 / 8);
+}
+
+TEST(LoadGen, run_over_loopback) {
+  /// Test an end-to-end run over UDP on this host with each encoding
+  for (auto const protocol : {0, 1}) {
+    taktile::LoadOptions options;
+    options.tracks = 20;
+    options.rate_hz = 50.0;
+    options.seconds = 0.5;
+    if (protocol == 1) {
+      options.serializer = std::make_shared<taktile::CotProtoSerializer>(
+          taktile::TakFraming::MESH, taktile::MAX_UDP_BLOB_SIZE);
+    }
+    auto const report = taktile::run_load(options);
+    EXPECT_EQ(report.sent, 500U);
+    EXPECT_EQ(report.received, 500U);
+    EXPECT_EQ(report.lost, 0U);
+    EXPECT_EQ(report.foreign, 0U);
+    EXPECT_EQ(report.send_drops, 0U);
+    EXPECT_GT(report.p50_ns, 0U);
+    EXPECT_LE(report.p50_ns, report.p99_ns);
+    EXPECT_LE(report.p99_ns, report.p999_ns);
+    EXPECT_NEAR(report.seconds, 0.5, 0.25);
+    EXPECT_GT(report.events_per_second(), 500.0);
+  }
+
+  taktile::LoadOptions invalid;
+  invalid.rate_hz = 0.0;
+  EXPECT_THROW(taktile::run_load(invalid), std::invalid_argument);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
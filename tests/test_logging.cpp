@@ -0,0 +1,150 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include <dirent.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <boost/log/core.hpp>
+#include <boost/log/trivial.hpp>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "taktile/logging.hpp"
+#include "taktile/metrics.hpp"
+
+namespace {
+
+/// Fresh directory for log files, removed with everything in it.
+class TempDir {
+ public:
+  TempDir() {
+    std::string pattern{"/tmp/taktile_log_XXXXXX"};
+    path_ = ::mkdtemp(pattern.data());
+  }
+
+  ~TempDir() {
+    for (auto const& file : files()) {
+      ::unlink((path_ + "/" + file).c_str());
+    }
+    ::rmdir(path_.c_str());
+  }
+
+  [[nodiscard]] std::string const& path() const {
+    return path_;
+  }
+
+  [[nodiscard]] std::vector<std::string> files() const {
+    std::vector<std::string> names;
+    if (auto* dir = ::opendir(path_.c_str())) {
+      while (auto const* entry = ::readdir(dir)) {
+        std::string const name{entry->d_name};
+        if (name != "." && name != "..") {
+          names.push_back(name);
+        }
+      }
+      ::closedir(dir);
+    }
+    return names;
+  }
+
+  [[nodiscard]] std::vector<std::string> lines(std::string const& file) const {
+    std::ifstream in{path_ + "/" + file};
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(in, line);) {
+      lines.push_back(line);
+    }
+    return lines;
+  }
+
+ private:
+  std::string path_;
+};
+
+uint64_t dropped() {
+  return taktile::metrics().counter("taktile_log_dropped_total").value();
+}
+
+}  // namespace
+
+TEST(Logging, asynchronous_file) {
+  /// Test that asynchronous records reach the file, filtered by severity
+  /// and formatted like the synchronous sink
+  TempDir const dir;
+  taktile::LoggerOptions options;
+  options.severity = boost::log::trivial::info;
+  options.console = false;
+  options.file = dir.path() + "/taktile.log";
+  options.asynchronous = true;
+  options.flush_interval = std::chrono::milliseconds(1);
+  taktile::init_logger(options);
+
+  for (int i = 0; i < 100; ++i) {
+    BOOST_LOG_TRIVIAL(debug) << "hidden " << i;
+    BOOST_LOG_TRIVIAL(info) << "shown " << i;
+  }
+  taktile::stop_logger();
+
+  auto const lines = dir.lines("taktile.log");
+  ASSERT_EQ(lines.size(), 100U);
+  EXPECT_EQ(lines.front().front(), '[');
+  EXPECT_NE(lines.front().find("] [info] shown 0"), std::string::npos);
+  EXPECT_NE(lines.back().find("] [info] shown 99"), std::string::npos);
+}
+
+TEST(Logging, drops_when_full) {
+  /// Test that a full queue drops and counts records instead of blocking
+  TempDir const dir;
+  taktile::LoggerOptions options;
+  options.console = false;
+  options.file = dir.path() + "/taktile.log";
+  options.asynchronous = true;
+  options.queue_capacity = 4;
+  options.flush_interval = std::chrono::milliseconds(200);
+  auto const before = dropped();
+  taktile::init_logger(options);
+
+  constexpr uint64_t RECORDS{1000};
+  for (uint64_t i = 0; i < RECORDS; ++i) {
+    BOOST_LOG_TRIVIAL(warning) << "record " << i;
+  }
+  taktile::stop_logger();
+
+  auto const written = dir.lines("taktile.log").size();
+  EXPECT_GE(written, 4U);
+  EXPECT_GT(dropped() - before, 0U);
+  EXPECT_EQ(written + (dropped() - before), RECORDS);
+}
+
+TEST(Logging, rotates_files) {
+  /// Test that the file sink rotates by size and keeps max_files old files
+  TempDir const dir;
+  taktile::LoggerOptions options;
+  options.console = false;
+  options.file = dir.path() + "/taktile_%N.log";
+  options.rotation_size = 256;
+  options.max_files = 2;
+  taktile::init_logger(options);
+
+  for (int i = 0; i < 100; ++i) {
+    BOOST_LOG_TRIVIAL(error) << "rotated record " << i;
+  }
+  boost::log::core::get()->remove_all_sinks();
+
+  auto const files = dir.files();
+  EXPECT_GE(files.size(), 2U);
+  EXPECT_LE(files.size(), 3U);
+
+  options.queue_capacity = 0;
+  options.asynchronous = true;
+  EXPECT_THROW(taktile::init_logger(options), std::invalid_argument);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,205 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "taktile/functions.hpp"
+#include "taktile/metrics.hpp"
+
+namespace {
+
+/// Send an HTTP GET to the exporter and return the whole response.
+std::string http_get(uint16_t port, std::string const& path) {
+  auto const fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  EXPECT_EQ(::connect(fd, reinterpret_cast<sockaddr*>(&address),
+                      sizeof(address)),
+            0);
+  auto const request = "GET " + path + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+  EXPECT_EQ(::send(fd, request.data(), request.size(), 0),
+            static_cast<ssize_t>(request.size()));
+  std::string response;
+  std::array<char, 4096> buffer{};
+  ssize_t n{0};
+  while ((n = ::recv(fd, buffer.data(), buffer.size(), 0)) > 0) {
+    response.append(buffer.data(), static_cast<std::size_t>(n));
+  }
+  ::close(fd);
+  return response;
+}
+
+}  // namespace
+
+TEST(Metrics, histogram_buckets) {
+  /// Test that buckets cover every value exactly once and are never wider
+  /// than 12.5% of the values in them
+  using Buckets = taktile::HistogramBuckets;
+  for (uint64_t value : {0ULL, 1ULL, 15ULL, 16ULL, 17ULL, 31ULL, 32ULL, 999ULL,
+                         1000000ULL, 123456789ULL, 1ULL << 62, ~0ULL}) {
+    auto const bucket = Buckets::of(value);
+    ASSERT_LT(bucket, Buckets::COUNT);
+    EXPECT_LE(Buckets::lowest(bucket), value);
+    EXPECT_GE(Buckets::highest(bucket), value);
+  }
+  for (std::size_t bucket = 1; bucket < Buckets::COUNT; ++bucket) {
+    EXPECT_EQ(Buckets::lowest(bucket), Buckets::highest(bucket - 1) + 1);
+    EXPECT_EQ(Buckets::of(Buckets::lowest(bucket)), bucket);
+    if (bucket + 1 < Buckets::COUNT) {
+      auto const width = Buckets::highest(bucket) - Buckets::lowest(bucket);
+      EXPECT_LE(width, Buckets::lowest(bucket) / 8);
+    }
+  }
+}
+
+TEST(Metrics, aggregates_threads) {
+  /// Test that counts recorded by more threads than there are stripes add
+  /// up exactly, and that percentiles fall within a bucket of the truth
+  taktile::MetricsRegistry registry;
+  auto& counter = registry.counter("test_events_total");
+  auto& histogram = registry.histogram("test_latency_seconds");
+  constexpr int THREADS{2 * taktile::METRIC_STRIPES};
+  constexpr uint64_t SAMPLES{10000};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < THREADS; ++t) {
+    threads.emplace_back([&counter, &histogram] {
+      for (uint64_t i = 1; i <= SAMPLES; ++i) {
+        counter.add();
+        histogram.record(i * 100);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  auto const snapshot = registry.snapshot();
+  EXPECT_EQ(snapshot.counters.at("test_events_total"), THREADS * SAMPLES);
+  auto const& latency = snapshot.histograms.at("test_latency_seconds");
+  EXPECT_EQ(latency.count, THREADS * SAMPLES);
+  EXPECT_EQ(latency.sum, THREADS * 100 * SAMPLES * (SAMPLES + 1) / 2);
+  EXPECT_NEAR(static_cast<double>(latency.percentile(0.5)), 500000.0, 62500);
+  EXPECT_NEAR(static_cast<double>(latency.percentile(0.99)), 990000.0,
+              123750);
+  EXPECT_GE(latency.percentile(1.0), 1000000U);
+  EXPECT_EQ(taktile::HistogramSnapshot{}.percentile(0.5), 0U);
+}
+
+TEST(Metrics, registry_and_exposition) {
+  /// Test metric lookup, name checks and the Prometheus text format
+  taktile::MetricsRegistry registry;
+  auto& counter = registry.counter("test_total", "Things\nthat happened");
+  EXPECT_EQ(&registry.counter("test_total"), &counter);
+  counter.add(3);
+  auto& histogram = registry.histogram("test_seconds");
+  histogram.record(100);
+  histogram.record(1000);
+  EXPECT_THROW(registry.counter("test_seconds"), std::invalid_argument);
+  EXPECT_THROW(registry.histogram("test_total"), std::invalid_argument);
+  EXPECT_THROW(registry.counter("1st"), std::invalid_argument);
+  EXPECT_THROW(registry.counter("with space"), std::invalid_argument);
+
+  auto const text = registry.prometheus();
+  EXPECT_NE(text.find("# HELP test_total Things\\nthat happened\n"
+                      "# TYPE test_total counter\ntest_total 3\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("# TYPE test_seconds histogram\n"), std::string::npos);
+  EXPECT_NE(text.find("test_seconds_bucket{le=\"6.4e-08\"} 0\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("test_seconds_bucket{le=\"1.28e-07\"} 1\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("test_seconds_bucket{le=\"1.024e-06\"} 2\n"),
+            std::string::npos);
+  EXPECT_NE(text.find("test_seconds_bucket{le=\"+Inf\"} 2\n"
+                      "test_seconds_sum 1.1e-06\ntest_seconds_count 2\n"),
+            std::string::npos);
+}
+
+TEST(Metrics, library_hot_paths) {
+  /// Test that validation failures, oversize messages and metered
+  /// serializer calls are recorded
+  auto const counter = [](std::string const& name) {
+    auto const snapshot = taktile::metrics().snapshot();
+    auto const found = snapshot.counters.find(name);
+    return found == snapshot.counters.end() ? 0 : found->second;
+  };
+  auto const invalid = counter("taktile_validation_failures_total");
+  auto const oversize = counter("taktile_oversize_total");
+
+  auto cot = taktile::CotType("metrics");
+  cot.lat = 91.0;
+  EXPECT_THROW(taktile::CotType::validate(cot), std::invalid_argument);
+  EXPECT_EQ(counter("taktile_validation_failures_total"), invalid + 1);
+
+  taktile::InlineCotMessage<8> small;
+  std::array<std::byte, 16> bytes{};
+  EXPECT_THROW(small.assign(bytes.data(), bytes.size()), std::length_error);
+  EXPECT_EQ(counter("taktile_oversize_total"), oversize + 1);
+
+  taktile::MeteredCotSerializer serializer{
+      std::make_shared<taktile::CotDirectXmlSerializer>()};
+  auto const blob = serializer.serialize(taktile::CotType("metrics"));
+  static_cast<void>(serializer.deserialize(blob));
+  EXPECT_THROW(static_cast<void>(serializer.deserialize({std::byte{'<'}})),
+               std::invalid_argument);
+  auto const snapshot = taktile::metrics().snapshot();
+  EXPECT_EQ(snapshot.histograms.at("taktile_serialize_seconds").count, 1U);
+  EXPECT_EQ(snapshot.histograms.at("taktile_deserialize_seconds").count, 1U);
+  EXPECT_EQ(snapshot.counters.at("taktile_deserialize_failures_total"), 1U);
+}
+
+TEST(Metrics, exporter) {
+  /// Test scraping over HTTP and dumping on a signal
+  taktile::MetricsRegistry registry;
+  registry.counter("test_scraped_total").add(7);
+  std::array<int, 2> pipe{};
+  ASSERT_EQ(::pipe(pipe.data()), 0);
+
+  taktile::MetricsExporterOptions options;
+  options.dump_signal = SIGUSR1;
+  options.dump_fd = pipe[1];
+  taktile::MetricsExporter const exporter{registry, options};
+  ASSERT_NE(exporter.port(), 0);
+  EXPECT_THROW(taktile::MetricsExporter(registry, options),
+               std::invalid_argument);
+
+  auto const response = http_get(exporter.port(), "/metrics");
+  EXPECT_EQ(response.rfind("HTTP/1.1 200 OK\r\n", 0), 0U);
+  EXPECT_NE(response.find("\r\n\r\n# TYPE test_scraped_total counter\n"
+                          "test_scraped_total 7\n"),
+            std::string::npos);
+  EXPECT_EQ(http_get(exporter.port(), "/").rfind("HTTP/1.1 404", 0), 0U);
+
+  ASSERT_EQ(::raise(SIGUSR1), 0);
+  pollfd pfd{pipe[0], POLLIN, 0};
+  ASSERT_EQ(::poll(&pfd, 1, 5000), 1);
+  std::array<char, 4096> dump{};
+  auto const n = ::read(pipe[0], dump.data(), dump.size());
+  ASSERT_GT(n, 0);
+  EXPECT_NE(std::string(dump.data(), static_cast<std::size_t>(n))
+                .find("test_scraped_total 7\n"),
+            std::string::npos);
+  ::close(pipe[0]);
+  ::close(pipe[1]);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,240 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "taktile/pipeline.hpp"
+
+namespace {
+
+// Wait for a condition set by pipeline workers, failing after 10 s.
+template <typename Condition>
+bool eventually(Condition condition) {
+  auto const deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (!condition()) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+taktile::StageOptions options(std::string name, std::size_t threads = 1,
+                              std::size_t batch_size = 64,
+                              std::size_t queue_capacity = 1024) {
+  taktile::StageOptions options;
+  options.name = std::move(name);
+  options.threads = threads;
+  options.batch_size = batch_size;
+  options.queue_capacity = queue_capacity;
+  return options;
+}
+
+}  // namespace
+
+TEST(Ring, bounded_fifo) {
+  /// Test that both rings keep order, round capacity up and refuse pushes
+  /// when full
+  taktile::SpscRing<int> spsc{5};
+  taktile::MpmcRing<int> mpmc{5};
+  EXPECT_EQ(spsc.capacity(), 8U);
+  EXPECT_EQ(mpmc.capacity(), 8U);
+
+  std::vector<int> values{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+  EXPECT_EQ(spsc.push(values.data(), values.size()), 8U);
+  EXPECT_EQ(mpmc.push(values.data(), values.size()), 8U);
+  EXPECT_FALSE(spsc.push(10));
+  EXPECT_FALSE(mpmc.push(10));
+  EXPECT_EQ(spsc.size(), 8U);
+  EXPECT_EQ(mpmc.size(), 8U);
+
+  std::vector<int> out;
+  EXPECT_EQ(spsc.pop(out, 3), 3U);
+  EXPECT_EQ(mpmc.pop(out, 3), 3U);
+  EXPECT_TRUE(spsc.push(10));
+  EXPECT_TRUE(mpmc.push(10));
+  EXPECT_EQ(spsc.pop(out, 100), 6U);
+  EXPECT_EQ(mpmc.pop(out, 100), 6U);
+  EXPECT_EQ(out, (std::vector<int>{0, 1, 2, 0, 1, 2, 3, 4, 5, 6, 7, 10, 3, 4,
+                                   5, 6, 7, 10}));
+  EXPECT_EQ(spsc.pop(out, 1), 0U);
+  EXPECT_EQ(mpmc.pop(out, 1), 0U);
+
+  EXPECT_THROW(taktile::SpscRing<int>{0}, std::invalid_argument);
+  EXPECT_THROW(taktile::MpmcRing<int>{0}, std::invalid_argument);
+}
+
+TEST(Ring, mpmc_concurrent) {
+  /// Test that every value pushed by several producers is popped exactly
+  /// once by several consumers
+  constexpr int PRODUCERS{4};
+  constexpr int CONSUMERS{3};
+  constexpr int64_t PER_PRODUCER{20000};
+  taktile::MpmcRing<int64_t> ring{64};
+  std::atomic<int64_t> popped{0};
+  std::atomic<int64_t> sum{0};
+
+  std::vector<std::thread> threads;
+  for (int p = 0; p < PRODUCERS; ++p) {
+    threads.emplace_back([&ring, p] {
+      for (int64_t i = 1; i <= PER_PRODUCER; ++i) {
+        while (!ring.push(i * PRODUCERS + p)) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (int c = 0; c < CONSUMERS; ++c) {
+    threads.emplace_back([&] {
+      std::vector<int64_t> out;
+      while (popped.load() < PRODUCERS * PER_PRODUCER) {
+        out.clear();
+        if (ring.pop(out, 16) == 0) {
+          std::this_thread::yield();
+        }
+        for (auto const value : out) {
+          sum += value;
+        }
+        popped += static_cast<int64_t>(out.size());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  int64_t expected{0};
+  for (int p = 0; p < PRODUCERS; ++p) {
+    for (int64_t i = 1; i <= PER_PRODUCER; ++i) {
+      expected += i * PRODUCERS + p;
+    }
+  }
+  EXPECT_EQ(popped.load(), PRODUCERS * PER_PRODUCER);
+  EXPECT_EQ(sum.load(), expected);
+}
+
+TEST(Pipeline, decode_and_encode) {
+  /// Test a receive -> decode -> encode -> send pipeline built from the
+  /// serializer stages, with a malformed message counted as a failure
+  constexpr int MESSAGES{500};
+  auto serializer = std::make_shared<taktile::CotDirectXmlSerializer>();
+  std::vector<std::vector<std::byte>> blobs;
+  for (int i = 0; i < MESSAGES; ++i) {
+    blobs.push_back(serializer->serialize(taktile::CotType(std::to_string(i))));
+  }
+  blobs[MESSAGES / 2] = {std::byte{'<'}};
+
+  taktile::Pipeline pipeline;
+  std::size_t next{0};
+  auto received = pipeline.source<std::vector<std::byte>>(
+      options("receive"), [&blobs, &next](auto& out, std::size_t max) {
+        while (out.size() < max && next < blobs.size()) {
+          out.push_back(blobs[next++]);
+        }
+      });
+  auto decoded = pipeline.stage<taktile::CotType>(
+      received, options("decode", 2), taktile::decode_stage(serializer));
+  auto encoded = pipeline.stage<taktile::SharedBlob>(
+      decoded, options("encode", 2), taktile::encode_stage(serializer));
+  std::atomic<std::size_t> sent{0};
+  std::atomic<std::size_t> bytes{0};
+  pipeline.sink(encoded, options("send"),
+                [&sent, &bytes](std::vector<taktile::SharedBlob>& batch) {
+                  for (auto const& blob : batch) {
+                    bytes += blob->size();
+                  }
+                  sent += batch.size();
+                });
+
+  pipeline.start();
+  EXPECT_TRUE(eventually([&sent] { return sent == MESSAGES - 1; }));
+  pipeline.stop();
+
+  auto const stats = pipeline.stats();
+  ASSERT_EQ(stats.size(), 4U);
+  EXPECT_EQ(stats[0].name, "receive");
+  EXPECT_EQ(stats[0].processed, static_cast<uint64_t>(MESSAGES));
+  EXPECT_EQ(stats[0].queue_capacity, 0U);
+  EXPECT_EQ(stats[1].processed, static_cast<uint64_t>(MESSAGES - 1));
+  EXPECT_EQ(stats[1].failures, 1U);
+  EXPECT_EQ(stats[1].queue_capacity, 1024U);
+  EXPECT_EQ(stats[1].queue_depth, 0U);
+  EXPECT_EQ(stats[3].processed, static_cast<uint64_t>(MESSAGES - 1));
+  EXPECT_GT(stats[3].throughput, 0.0);
+  EXPECT_GT(bytes.load(), 0U);
+}
+
+TEST(Pipeline, backpressure_and_drain) {
+  /// Test that a slow stage holds back the source through a small queue,
+  /// and that stop() delivers everything already produced
+  taktile::Pipeline pipeline;
+  int next{0};
+  auto numbers = pipeline.source<int>(
+      options("count", 1, 4), [&next](std::vector<int>& out, std::size_t max) {
+        while (out.size() < max) {
+          out.push_back(next++);
+        }
+      });
+  std::vector<int> seen;
+  pipeline.sink(numbers, options("slow", 1, 2, 4),
+                [&seen](std::vector<int>& batch) {
+                  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                  seen.insert(seen.end(), batch.begin(), batch.end());
+                });
+
+  pipeline.start();
+  EXPECT_TRUE(eventually([&pipeline] {
+    return pipeline.stats()[0].stalls > 0 &&
+           pipeline.stats()[1].queue_depth > 0;
+  }));
+  pipeline.stop();
+
+  auto const stats = pipeline.stats();
+  EXPECT_EQ(stats[1].queue_capacity, 4U);
+  EXPECT_EQ(stats[1].queue_depth, 0U);
+  EXPECT_EQ(stats[0].processed, static_cast<uint64_t>(next));
+  ASSERT_EQ(seen.size(), static_cast<std::size_t>(next));
+  for (int i = 0; i < next; ++i) {
+    EXPECT_EQ(seen[i], i);
+  }
+}
+
+TEST(Pipeline, rejects_bad_wiring) {
+  /// Test that invalid options, a port consumed twice, an unconsumed output
+  /// and late stages are rejected
+  auto produce = [](std::vector<int>&, std::size_t) {};
+  auto consume = [](std::vector<int>&) {};
+  taktile::Pipeline pipeline;
+  EXPECT_THROW(pipeline.source<int>(options("none", 0), produce),
+               std::invalid_argument);
+  EXPECT_THROW(pipeline.source<int>(options("empty", 1, 0), produce),
+               std::invalid_argument);
+
+  auto numbers = pipeline.source<int>(options("numbers"), produce);
+  EXPECT_THROW(pipeline.start(), std::invalid_argument);
+  pipeline.sink(numbers, options("sink"), consume);
+  EXPECT_THROW(pipeline.sink(numbers, options("again"), consume),
+               std::invalid_argument);
+
+  pipeline.start();
+  EXPECT_THROW(pipeline.source<int>(options("late"), produce),
+               std::invalid_argument);
+  pipeline.stop();
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,139 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "taktile/datetime.hpp"
+#include "taktile/relay.hpp"
+#include "taktile/xml_writer.hpp"
+
+namespace {
+
+constexpr std::string_view EVENT_TAG{
+    "<event version=\"2.0\" uid=\"ANDROID-1\" type=\"a-f-G-U-C\" how=\"h-e\" "
+    "time=\"2025-01-01T00:00:00.000Z\" start=\"2025-01-01T00:00:00.000Z\" "
+    "stale=\"2025-01-01T00:02:00.000Z\">"
+    "<point lat=\"1.5\" lon=\"2.5\" hae=\"0\" ce=\"9\" le=\"9\"/>"};
+
+constexpr std::string_view DETAIL{
+    "<contact callsign=\"TACO-1\" endpoint=\"*:-1:stcp\"/>"
+    "<__group name=\"Cyan\" role=\"Team Member\"/>"
+    "<remarks>Nested <b>markup</b> &amp; text</remarks>"};
+
+std::string relay(std::string_view xml, int64_t now) {
+  taktile::CotRelayEvent const event{xml};
+  std::array<std::byte, taktile::MAX_TCP_BLOB_SIZE> buffer{};
+  auto const size = event.write(now, buffer.data(), buffer.size());
+  EXPECT_EQ(size, event.size());
+  return {reinterpret_cast<char const*>(buffer.data()), size};
+}
+
+std::string flow_tag(int64_t now) {
+  return " " + std::string(taktile::flow_tag_name()) + "=\"" +
+         taktile::format_w3c_datetime(now) + "\"";
+}
+
+}  // namespace
+
+TEST(Relay, preserves_detail) {
+  /// Test that detail content is passed through byte for byte, with the
+  /// flow-tag added to the existing element
+  auto const xml = std::string(EVENT_TAG) + "<detail>" + std::string(DETAIL) +
+                   "<_flow-tags_ other-node=\"2025-01-01T00:00:00.000Z\"/>"
+                   "</detail></event>";
+  taktile::CotRelayEvent const event{xml};
+  EXPECT_EQ(event.detail(),
+            std::string(DETAIL) +
+                "<_flow-tags_ other-node=\"2025-01-01T00:00:00.000Z\"/>");
+  EXPECT_FALSE(event.looped());
+
+  auto const now = taktile::parse_w3c_datetime("2025-06-01T12:00:00.000Z");
+  auto const out = relay(xml, now);
+  auto expected = xml;
+  expected.replace(expected.find("time=\"2025-01-01T00:00:00.000Z\"") + 6, 24,
+                   "2025-06-01T12:00:00.000Z");
+  expected.insert(expected.find("\"/></detail>") + 1, flow_tag(now));
+  EXPECT_EQ(out, expected);
+
+  auto const cot = taktile::CotRelayEvent(out).decode();
+  EXPECT_EQ(cot.uid, "ANDROID-1");
+  EXPECT_EQ(cot.time, now);
+  EXPECT_EQ(cot.start, taktile::parse_w3c_datetime("2025-01-01T00:00:00.000Z"));
+  EXPECT_TRUE(taktile::CotRelayEvent(out).looped());
+}
+
+TEST(Relay, adds_flow_tags) {
+  /// Test that the flow-tag is added when the event has no <_flow-tags_>,
+  /// an empty <detail/> or no <detail> at all
+  auto const now = taktile::parse_w3c_datetime("2025-06-01T12:00:00.000Z");
+  auto const element = "<_flow-tags_" + flow_tag(now) + "/>";
+
+  auto const without_flow_tags = std::string(EVENT_TAG) + "<detail>" +
+                                 std::string(DETAIL) + "</detail></event>";
+  auto out = relay(without_flow_tags, now);
+  EXPECT_NE(out.find(std::string(DETAIL) + element + "</detail></event>"),
+            std::string::npos);
+
+  out = relay(std::string(EVENT_TAG) + "<detail/></event>", now);
+  EXPECT_NE(out.find("<detail>" + element + "</detail></event>"),
+            std::string::npos);
+
+  out = relay(std::string(EVENT_TAG) + "</event>", now);
+  EXPECT_NE(out.find("/><detail>" + element + "</detail></event>"),
+            std::string::npos);
+  EXPECT_EQ(taktile::CotRelayEvent(out).decode().time, now);
+
+  // An open <_flow-tags_> element with content is extended too.
+  out = relay(std::string(EVENT_TAG) +
+                  "<detail><_flow-tags_ a=\"1\"><x/></_flow-tags_></detail>"
+                  "</event>",
+              now);
+  EXPECT_NE(out.find("<_flow-tags_ a=\"1\"" + flow_tag(now) + "><x/>"),
+            std::string::npos);
+}
+
+TEST(Relay, rewrites_looped_flow_tag) {
+  /// Test that relaying an event that already carries this node's flow-tag
+  /// rewrites that attribute instead of adding a duplicate
+  auto const then = taktile::parse_w3c_datetime("2025-01-01T00:00:00.000Z");
+  auto const now = taktile::parse_w3c_datetime("2025-06-01T12:00:00.000Z");
+  auto const xml = std::string(EVENT_TAG) + "<detail><_flow-tags_ a=\"1\"" +
+                   flow_tag(then) + " b=\"2\"/></detail></event>";
+  taktile::CotRelayEvent const event{xml};
+  EXPECT_TRUE(event.looped());
+
+  auto const out = relay(xml, now);
+  EXPECT_NE(out.find("<_flow-tags_ a=\"1\"" + flow_tag(now) + " b=\"2\"/>"),
+            std::string::npos);
+  EXPECT_EQ(out.find(flow_tag(then)), std::string::npos);
+  taktile::CotRelayEvent const again{out};
+  EXPECT_TRUE(again.looped());
+  EXPECT_EQ(again.decode().time, now);
+  EXPECT_EQ(relay(out, now), out);
+}
+
+TEST(Relay, rejects_bad_input) {
+  /// Test that malformed events and small buffers are rejected
+  EXPECT_THROW(taktile::CotRelayEvent{"<foo/>"}, std::invalid_argument);
+  EXPECT_THROW(taktile::CotRelayEvent{"<event uid=\"a\"><point/></event>"},
+               std::invalid_argument);
+  EXPECT_THROW(taktile::CotRelayEvent{"<event time=\"x\"><detail/></event>"},
+               std::invalid_argument);
+  EXPECT_THROW(taktile::CotRelayEvent{std::string(EVENT_TAG) + "<detail>"},
+               std::invalid_argument);
+
+  auto const xml = std::string(EVENT_TAG) + "</event>";
+  taktile::CotRelayEvent const event{xml};
+  std::array<std::byte, 64> small{};
+  EXPECT_THROW(event.write(0, small.data(), small.size()), std::length_error);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
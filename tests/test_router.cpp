@@ -0,0 +1,232 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "taktile/functions.hpp"
+#include "taktile/router.hpp"
+
+namespace {
+
+/// Serializer that counts how often it is asked to serialize.
+class CountingSerializer : public taktile::CotDirectXmlSerializer {
+ public:
+  std::vector<std::byte> serialize(taktile::CotType const& cot) override {
+    ++calls;
+    return CotDirectXmlSerializer::serialize(cot);
+  }
+
+  std::size_t calls{0};
+};
+
+/// Bound socket that the tests read back from: UDP, or a TCP listener that
+/// accepts but never reads.
+class Listener {
+ public:
+  explicit Listener(int type = SOCK_DGRAM) {
+    fd_ = ::socket(AF_INET, type, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ::bind(fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+    socklen_t size = sizeof(address);
+    ::getsockname(fd_, reinterpret_cast<sockaddr*>(&address), &size);
+    port_ = ntohs(address.sin_port);
+    if (type == SOCK_STREAM) {
+      ::listen(fd_, 1);
+    }
+  }
+
+  ~Listener() {
+    ::close(fd_);
+  }
+
+  Listener(Listener const&) = delete;
+  Listener(Listener&&) = delete;
+  Listener& operator=(Listener const&) = delete;
+  Listener& operator=(Listener&&) = delete;
+
+  [[nodiscard]] uint16_t port() const {
+    return port_;
+  }
+
+  /// Receive one datagram, or an empty string after a timeout.
+  std::string receive() {
+    pollfd pfd{fd_, POLLIN, 0};
+    if (::poll(&pfd, 1, 1000) != 1) {
+      return {};
+    }
+    std::array<char, taktile::MAX_UDP_BLOB_SIZE> buffer{};
+    auto const size = ::recv(fd_, buffer.data(), buffer.size(), 0);
+    return {buffer.data(), size > 0 ? static_cast<std::size_t>(size) : 0};
+  }
+
+ private:
+  int fd_{-1};
+  uint16_t port_{0};
+};
+
+taktile::URL udp_url(Listener const& listener) {
+  return {taktile::Scheme::UDP, "127.0.0.1", listener.port()};
+}
+
+}  // namespace
+
+TEST(Router, rejects_https_url) {
+  /// Test that a URL without a transport is rejected
+  taktile::CotRouter router{
+      std::make_shared<taktile::CotDirectXmlSerializer>()};
+  auto const url = taktile::URL(taktile::Scheme::HTTPS, "example.com", 8443);
+  EXPECT_THROW(router.add_route(url), std::invalid_argument);
+  EXPECT_EQ(router.size(), 0);
+}
+
+TEST(Router, serializes_once) {
+  /// Test that one serialized buffer is shared by every destination
+  Listener first;
+  Listener second;
+  auto serializer = std::make_shared<CountingSerializer>();
+  auto const log = taktile::URL(taktile::Scheme::LOG, "localhost", 0);
+  taktile::CotRouter router{serializer,
+                            {udp_url(first), udp_url(second), log}};
+  ASSERT_EQ(router.size(), 3);
+
+  EXPECT_EQ(router.route(taktile::hello_event("taco")), 3);
+  EXPECT_EQ(serializer->calls, 1);
+  router.flush();
+
+  auto const datagram = first.receive();
+  EXPECT_NE(datagram.find("uid=\"taco\""), std::string::npos);
+  EXPECT_EQ(second.receive(), datagram);
+  for (std::size_t i = 0; i < router.size(); ++i) {
+    EXPECT_EQ(router.stats(i).sent, 1);
+    EXPECT_EQ(router.stats(i).dropped, 0);
+  }
+}
+
+TEST(Router, shared_buffer_is_released) {
+  /// Test that destinations drop their references once the event is sent
+  Listener listener;
+  taktile::CotRouter router{std::make_shared<CountingSerializer>(),
+                            {udp_url(listener), udp_url(listener)}};
+  auto const blob = std::make_shared<std::vector<std::byte> const>(
+      taktile::CotDirectXmlSerializer().serialize(
+          taktile::hello_event("taco")));
+  router.route(blob);
+  EXPECT_EQ(blob.use_count(), 3);
+  router.flush();
+  EXPECT_EQ(blob.use_count(), 1);
+}
+
+TEST(Router, drop_policies) {
+  /// Test that a full queue drops the oldest or the newest message
+  Listener oldest;
+  Listener newest;
+  taktile::RouteOptions options;
+  options.queue_capacity = 2;
+  taktile::CotRouter router{std::make_shared<CountingSerializer>()};
+  router.add_route(udp_url(oldest), options);
+  options.drop_policy = taktile::DropPolicy::NEWEST;
+  router.add_route(udp_url(newest), options);
+
+  EXPECT_EQ(router.route(taktile::CotType("a")), 2);
+  EXPECT_EQ(router.route(taktile::CotType("b")), 2);
+  EXPECT_EQ(router.route(taktile::CotType("c")), 1);
+  router.flush();
+
+  EXPECT_NE(oldest.receive().find("uid=\"b\""), std::string::npos);
+  EXPECT_NE(oldest.receive().find("uid=\"c\""), std::string::npos);
+  EXPECT_NE(newest.receive().find("uid=\"a\""), std::string::npos);
+  EXPECT_NE(newest.receive().find("uid=\"b\""), std::string::npos);
+  EXPECT_EQ(router.stats(0).dropped, 1);
+  EXPECT_EQ(router.stats(1).dropped, 1);
+}
+
+TEST(Router, udp_counts_each_drop_once) {
+  /// Test that messages a full sender refuses are retried rather than
+  /// dropped, and that an oversize message is counted once
+  Listener listener;
+  taktile::RouteOptions options;
+  options.udp.queue_capacity = 2;
+  taktile::CotRouter router{std::make_shared<CountingSerializer>(),
+                            {udp_url(listener)}, options};
+  for (int i = 0; i < 5; ++i) {
+    router.route(taktile::CotType("uid-" + std::to_string(i)));
+  }
+  router.flush();
+  EXPECT_EQ(router.stats(0).sent, 5);
+  EXPECT_EQ(router.stats(0).dropped, 0);
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_NE(listener.receive().find("uid=\"uid-" + std::to_string(i)),
+              std::string::npos);
+  }
+
+  router.route(std::make_shared<std::vector<std::byte> const>(
+      taktile::MAX_UDP_BLOB_SIZE + 1, std::byte{'x'}));
+  router.flush();
+  router.route(taktile::CotType("after"));
+  router.flush();
+  EXPECT_EQ(router.stats(0).sent, 6);
+  EXPECT_EQ(router.stats(0).dropped, 1);
+}
+
+TEST(Router, stream_drops_empty_blob) {
+  /// Test that an empty blob is dropped by a TCP route instead of blocking
+  /// the messages queued behind it
+  Listener tcp{SOCK_STREAM};
+  taktile::CotRouter router{
+      std::make_shared<CountingSerializer>(),
+      {{taktile::Scheme::TCP, "127.0.0.1", tcp.port()}}};
+  router.route(std::make_shared<std::vector<std::byte> const>());
+  router.route(taktile::CotType("after"));
+  router.flush();
+  EXPECT_EQ(router.stats(0).dropped, 1);
+  EXPECT_EQ(router.stats(0).sent, 1);
+}
+
+TEST(Router, slow_peer_does_not_stall_others) {
+  /// Test that a TCP peer that never reads only drops its own messages
+  Listener udp;
+  Listener tcp{SOCK_STREAM};
+  taktile::RouteOptions options;
+  options.queue_capacity = 16;
+  options.stream.max_queued_bytes = 4096;
+  taktile::CotRouter router{std::make_shared<CountingSerializer>(),
+                            {udp_url(udp),
+                             {taktile::Scheme::TCP, "127.0.0.1", tcp.port()}},
+                            options};
+
+  // Enough to fill the socket buffers of a peer that never reads.
+  auto const cot = taktile::CotType(std::string(1000, 'x'));
+  std::size_t received{0};
+  for (int round = 0; round < 500; ++round) {
+    for (int i = 0; i < 8; ++i) {
+      router.route(cot);
+    }
+    router.flush();
+    while (received < router.stats(0).sent && !udp.receive().empty()) {
+      ++received;
+    }
+  }
+  EXPECT_EQ(router.stats(0).sent, 4000);
+  EXPECT_EQ(router.stats(0).dropped, 0);
+  EXPECT_EQ(received, 4000);
+  EXPECT_GT(router.stats(1).dropped, 0);
+  EXPECT_FALSE(router.stats(1).failed);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,138 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "taktile/spatial_index.hpp"
+
+namespace {
+
+std::vector<std::string> sorted(std::vector<std::string> uids) {
+  std::sort(uids.begin(), uids.end());
+  return uids;
+}
+
+}  // namespace
+
+TEST(SpatialIndex, haversine) {
+  /// Test great-circle distances against known values
+  EXPECT_NEAR(taktile::haversine_m(0.0, 0.0, 0.0, 1.0), 111195.0, 1.0);
+  EXPECT_NEAR(taktile::haversine_m(0.0, 179.5, 0.0, -179.5), 111195.0, 1.0);
+  EXPECT_NEAR(taktile::haversine_m(90.0, 0.0, -90.0, 0.0),
+              taktile::EARTH_RADIUS_M * 3.14159265358979, 1.0);
+}
+
+TEST(SpatialIndex, rejects_bad_input) {
+  /// Test that out-of-range cells and coordinates are rejected
+  EXPECT_THROW(taktile::SpatialIndex{0.0}, std::invalid_argument);
+  taktile::SpatialIndex index;
+  EXPECT_THROW(index.update("a", 91.0, 0.0), std::invalid_argument);
+  EXPECT_THROW(index.update("a", 0.0, -181.0), std::invalid_argument);
+  EXPECT_EQ(index.size(), 0);
+}
+
+TEST(SpatialIndex, box_query) {
+  /// Test box queries, including one across the antimeridian
+  taktile::SpatialIndex index;
+  index.update("sf", 37.7749, -122.4194);
+  index.update("oakland", 37.8044, -122.2712);
+  index.update("la", 34.0522, -118.2437);
+  index.update("fiji", -17.7, 178.0);
+  index.update("samoa", -13.8, -172.1);
+
+  EXPECT_EQ(sorted(index.within(taktile::GeoBox{37.0, -123.0, 38.0, -122.0})),
+            (std::vector<std::string>{"oakland", "sf"}));
+  EXPECT_EQ(sorted(index.within(taktile::GeoBox{-20.0, 170.0, -10.0, -170.0})),
+            (std::vector<std::string>{"fiji", "samoa"}));
+  EXPECT_EQ(index.within(taktile::GeoBox{}).size(), 5);
+}
+
+TEST(SpatialIndex, radius_query) {
+  /// Test radius queries near the antimeridian and a pole
+  taktile::SpatialIndex index;
+  // 0.05 degrees of latitude is about 5.56 km.
+  for (int i = 0; i < 10; ++i) {
+    index.update("m-" + std::to_string(i), i * 0.05, 0.0);
+  }
+  EXPECT_EQ(index.within(0.0, 0.0, 10000.0).size(), 2);
+  EXPECT_EQ(index.within(0.0, 0.0, 12000.0).size(), 3);
+
+  index.update("west", 0.0, -179.99);
+  index.update("east", 0.0, 179.99);
+  EXPECT_EQ(sorted(index.within(0.0, 180.0, 5000.0)),
+            (std::vector<std::string>{"east", "west"}));
+
+  index.update("pole-a", 89.99, 0.0);
+  index.update("pole-b", 89.99, 180.0);
+  EXPECT_EQ(sorted(index.within(90.0, 0.0, 2000.0)),
+            (std::vector<std::string>{"pole-a", "pole-b"}));
+}
+
+TEST(SpatialIndex, moves_and_removes) {
+  /// Test that moved and removed tracks are found only where they are
+  taktile::SpatialIndex index;
+  index.update("a", 10.0, 10.0);
+  index.update("b", 10.0, 10.01);
+  index.update("c", 20.0, 20.0);
+  index.update("a", 20.0, 20.01);
+  EXPECT_EQ(index.size(), 3);
+  EXPECT_EQ(index.within(10.0, 10.0, 5000.0),
+            (std::vector<std::string>{"b"}));
+  EXPECT_EQ(sorted(index.within(20.0, 20.0, 5000.0)),
+            (std::vector<std::string>{"a", "c"}));
+
+  EXPECT_TRUE(index.remove("a"));
+  EXPECT_FALSE(index.remove("a"));
+  EXPECT_EQ(index.size(), 2);
+  EXPECT_EQ(index.within(20.0, 20.0, 5000.0),
+            (std::vector<std::string>{"c"}));
+  EXPECT_EQ(index.within(10.0, 10.0, 5000.0),
+            (std::vector<std::string>{"b"}));
+}
+
+TEST(SpatialIndex, matches_linear_scan) {
+  /// Test random moves and queries against a brute-force scan
+  taktile::SpatialIndex index{0.5};
+  std::unordered_map<std::string, std::pair<double, double>> positions;
+  std::mt19937 rng{42};
+  std::uniform_real_distribution<double> lat{-60.0, 60.0};
+  std::uniform_real_distribution<double> lon{-180.0, 180.0};
+  std::uniform_real_distribution<double> step{-1.0, 1.0};
+  std::uniform_real_distribution<double> radius{1000.0, 500000.0};
+
+  for (int i = 0; i < 2000; ++i) {
+    auto const uid = "track-" + std::to_string(i);
+    positions[uid] = {lat(rng), lon(rng)};
+    index.update(uid, positions[uid].first, positions[uid].second);
+  }
+  for (int round = 0; round < 20; ++round) {
+    for (auto& [uid, position] : positions) {
+      position.first = std::clamp(position.first + step(rng), -90.0, 90.0);
+      position.second = std::clamp(position.second + step(rng), -180.0, 180.0);
+      index.update(uid, position.first, position.second);
+    }
+    auto const center_lat = lat(rng);
+    auto const center_lon = lon(rng);
+    auto const r = radius(rng);
+    std::vector<std::string> expected;
+    for (auto const& [uid, position] : positions) {
+      if (taktile::haversine_m(center_lat, center_lon, position.first,
+                               position.second) <= r) {
+        expected.push_back(uid);
+      }
+    }
+    EXPECT_EQ(sorted(index.within(center_lat, center_lon, r)),
+              sorted(expected));
+  }
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,345 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "taktile/functions.hpp"
+#include "taktile/stream.hpp"
+
+namespace {
+
+std::vector<std::byte> to_bytes(std::string_view text) {
+  auto const* const data = reinterpret_cast<std::byte const*>(text.data());
+  return {data, data + text.size()};
+}
+
+std::string event(int i) {
+  return "<event uid=\"track-" + std::to_string(i) + "\"><point/></event>";
+}
+
+/// Self-signed certificate for "localhost", generated per test run.
+class Certificate {
+ public:
+  Certificate() : key_{::EVP_EC_gen("P-256")}, cert_{::X509_new()} {
+    ::X509_set_version(cert_, 2);
+    ::ASN1_INTEGER_set(::X509_get_serialNumber(cert_), 1);
+    ::X509_gmtime_adj(X509_getm_notBefore(cert_), 0);
+    ::X509_gmtime_adj(X509_getm_notAfter(cert_), 3600);
+    ::X509_set_pubkey(cert_, key_);
+    auto* const name = ::X509_get_subject_name(cert_);
+    ::X509_NAME_add_entry_by_txt(
+        name, "CN", MBSTRING_ASC,
+        reinterpret_cast<unsigned char const*>("localhost"), -1, -1, 0);
+    ::X509_set_issuer_name(cert_, name);
+    ::X509_sign(cert_, key_, ::EVP_sha256());
+  }
+
+  ~Certificate() {
+    ::X509_free(cert_);
+    ::EVP_PKEY_free(key_);
+    if (!path_.empty()) {
+      std::remove(path_.c_str());
+    }
+  }
+
+  Certificate(Certificate const&) = delete;
+  Certificate(Certificate&&) = delete;
+  Certificate& operator=(Certificate const&) = delete;
+  Certificate& operator=(Certificate&&) = delete;
+
+  [[nodiscard]] EVP_PKEY* key() const {
+    return key_;
+  }
+
+  [[nodiscard]] X509* cert() const {
+    return cert_;
+  }
+
+  /// Write the certificate as PEM, for use as a trusted CA file.
+  std::string const& pem_file() {
+    if (path_.empty()) {
+      std::array<char, 32> path{"/tmp/taktile_ca_XXXXXX"};
+      auto const fd = ::mkstemp(path.data());
+      auto* const file = ::fdopen(fd, "w");
+      ::PEM_write_X509(file, cert_);
+      std::fclose(file);
+      path_ = path.data();
+    }
+    return path_;
+  }
+
+ private:
+  EVP_PKEY* key_;
+  X509* cert_;
+  std::string path_;
+};
+
+/// Loopback server that echoes everything back, over TCP or TLS.
+class EchoServer {
+ public:
+  explicit EchoServer(Certificate const* certificate = nullptr) {
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ::bind(listen_fd_, reinterpret_cast<sockaddr*>(&address),
+           sizeof(address));
+    ::listen(listen_fd_, 1);
+    socklen_t size = sizeof(address);
+    ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&address), &size);
+    port_ = ntohs(address.sin_port);
+    thread_ = std::thread([this, certificate] { run(certificate); });
+  }
+
+  ~EchoServer() {
+    ::shutdown(listen_fd_, SHUT_RDWR);
+    thread_.join();
+    ::close(listen_fd_);
+  }
+
+  EchoServer(EchoServer const&) = delete;
+  EchoServer(EchoServer&&) = delete;
+  EchoServer& operator=(EchoServer const&) = delete;
+  EchoServer& operator=(EchoServer&&) = delete;
+
+  [[nodiscard]] uint16_t port() const {
+    return port_;
+  }
+
+ private:
+  void run(Certificate const* certificate) {
+    auto const fd = ::accept(listen_fd_, nullptr, nullptr);
+    if (fd < 0) {
+      return;
+    }
+    std::array<char, 4096> buffer{};
+    if (certificate == nullptr) {
+      for (;;) {
+        auto const count = ::recv(fd, buffer.data(), buffer.size(), 0);
+        if (count <= 0 || ::send(fd, buffer.data(), count, 0) != count) {
+          break;
+        }
+      }
+    } else {
+      auto* const context = ::SSL_CTX_new(::TLS_server_method());
+      ::SSL_CTX_use_certificate(context, certificate->cert());
+      ::SSL_CTX_use_PrivateKey(context, certificate->key());
+      auto* const ssl = ::SSL_new(context);
+      ::SSL_set_fd(ssl, fd);
+      if (::SSL_accept(ssl) == 1) {
+        for (;;) {
+          auto const count = ::SSL_read(ssl, buffer.data(), buffer.size());
+          if (count <= 0 || ::SSL_write(ssl, buffer.data(), count) != count) {
+            break;
+          }
+        }
+      }
+      ::SSL_free(ssl);
+      ::SSL_CTX_free(context);
+    }
+    ::close(fd);
+  }
+
+  int listen_fd_{-1};
+  uint16_t port_{0};
+  std::thread thread_;
+};
+
+/// Send count events and read them back through the echo server.
+std::vector<std::string> round_trip(taktile::CotStream& stream, int count) {
+  for (int i = 0; i < count; ++i) {
+    EXPECT_TRUE(stream.send(to_bytes(event(i)), 1000));
+  }
+  EXPECT_TRUE(stream.drain(1000));
+  std::vector<std::string> received;
+  while (received.size() < static_cast<std::size_t>(count)) {
+    auto const events = stream.receive(
+        [&received](std::string_view xml) { received.emplace_back(xml); },
+        1000);
+    if (events == 0) {
+      break;
+    }
+  }
+  return received;
+}
+
+}  // namespace
+
+TEST(Stream, framer_splits_reads) {
+  /// Test that an event split across reads is handed out once complete
+  taktile::CotEventFramer framer;
+  auto const xml = event(1);
+  auto const bytes = to_bytes(xml);
+  for (std::size_t i = 0; i + 1 < bytes.size(); ++i) {
+    framer.append(&bytes[i], 1);
+    EXPECT_FALSE(framer.next().has_value());
+  }
+  framer.append(&bytes.back(), 1);
+  auto const complete = framer.next();
+  ASSERT_TRUE(complete.has_value());
+  EXPECT_EQ(*complete, xml);
+  EXPECT_EQ(framer.buffered(), 0);
+}
+
+TEST(Stream, framer_multiple_events_per_read) {
+  /// Test that several events in one read come out in order
+  taktile::CotEventFramer framer;
+  auto const bytes = to_bytes("<?xml version=\"1.0\"?>" + event(0) + "\n" +
+                              event(1) + "\r\n" + event(2).substr(0, 10));
+  framer.append(bytes.data(), bytes.size());
+  EXPECT_EQ(framer.next().value(), "<?xml version=\"1.0\"?>" + event(0));
+  EXPECT_EQ(framer.next().value(), event(1));
+  EXPECT_FALSE(framer.next().has_value());
+  EXPECT_EQ(framer.buffered(), 10);
+}
+
+TEST(Stream, framer_rejects_oversize_event) {
+  /// Test that a stream without </event> cannot grow without bound
+  taktile::CotEventFramer framer{64};
+  auto const bytes = to_bytes("<event>" + std::string(64, 'x'));
+  framer.append(bytes.data(), bytes.size());
+  EXPECT_THROW(framer.next(), std::length_error);
+}
+
+TEST(Stream, rejects_non_stream_url) {
+  /// Test that a UDP URL is rejected
+  auto const url = taktile::URL(taktile::Scheme::UDP, "127.0.0.1", 6969);
+  EXPECT_THROW(taktile::CotStream{url}, std::invalid_argument);
+}
+
+TEST(Stream, tcp_round_trip) {
+  /// Test that queued events are coalesced into writev and read back
+  EchoServer server;
+  taktile::CotStream stream{
+      taktile::URL(taktile::Scheme::TCP, "127.0.0.1", server.port())};
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_TRUE(stream.enqueue(to_bytes(event(i))));
+  }
+  EXPECT_TRUE(stream.drain(1000));
+  EXPECT_EQ(stream.queued_bytes(), 0);
+  EXPECT_EQ(stream.stats().messages_sent, 100);
+  EXPECT_LT(stream.stats().write_calls, 100);
+
+  std::vector<std::string> events;
+  while (events.size() < 100 &&
+         stream.receive(
+             [&events](std::string_view xml) { events.emplace_back(xml); },
+             1000) > 0) {
+  }
+  ASSERT_EQ(events.size(), 100);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(events[i], event(i));
+  }
+  EXPECT_EQ(stream.stats().events_received, 100);
+}
+
+TEST(Stream, queue_is_bounded) {
+  /// Test that enqueue refuses messages beyond max_queued_bytes
+  EchoServer server;
+  taktile::StreamOptions options;
+  options.max_queued_bytes = 2 * event(0).size();
+  taktile::CotStream stream{
+      taktile::URL(taktile::Scheme::TCP, "127.0.0.1", server.port()), options};
+  EXPECT_TRUE(stream.enqueue(to_bytes(event(0))));
+  EXPECT_TRUE(stream.enqueue(to_bytes(event(1))));
+  EXPECT_FALSE(stream.enqueue(to_bytes(event(2))));
+  EXPECT_EQ(stream.stats().refused, 1);
+  EXPECT_TRUE(stream.send(to_bytes(event(2)), 1000));
+  EXPECT_TRUE(stream.drain(1000));
+}
+
+TEST(Stream, rejects_empty_payload) {
+  /// Test that an empty payload is not queued, so drain() does not wait on it
+  EchoServer server;
+  taktile::CotStream stream{
+      taktile::URL(taktile::Scheme::TCP, "127.0.0.1", server.port())};
+  EXPECT_FALSE(stream.enqueue(std::vector<std::byte>{}));
+  EXPECT_FALSE(stream.enqueue(nullptr, 0));
+  EXPECT_FALSE(stream.send(std::vector<std::byte>{}, 1000));
+  EXPECT_EQ(stream.queued_bytes(), 0);
+  EXPECT_EQ(stream.stats().refused, 0);
+  auto const start = std::chrono::steady_clock::now();
+  EXPECT_TRUE(stream.drain(1000));
+  EXPECT_LT(std::chrono::steady_clock::now() - start,
+            std::chrono::milliseconds(500));
+}
+
+TEST(Stream, receive_rejects_endless_event) {
+  /// Test that a peer streaming without </event> is cut off at the limit
+  EchoServer server;
+  taktile::CotStream stream{
+      taktile::URL(taktile::Scheme::TCP, "127.0.0.1", server.port())};
+  auto const endless =
+      "<event>" + std::string(4 * taktile::MAX_TCP_BLOB_SIZE, 'x');
+  EXPECT_TRUE(stream.send(to_bytes(endless), 1000));
+  EXPECT_TRUE(stream.drain(1000));
+  EXPECT_THROW(
+      {
+        for (int i = 0; i < 100; ++i) {
+          stream.receive([](std::string_view) {}, 100);
+        }
+      },
+      std::length_error);
+  EXPECT_LE(stream.stats().bytes_received,
+            taktile::MAX_TCP_BLOB_SIZE + 2 * 16384);
+}
+
+TEST(Stream, tls_round_trip) {
+  /// Test that events round trip over TLS without peer verification
+  Certificate certificate;
+  EchoServer server{&certificate};
+  taktile::StreamOptions options;
+  options.verify_peer = false;
+  taktile::CotStream stream{
+      taktile::URL(taktile::Scheme::TLS, "127.0.0.1", server.port()), options};
+  auto const received = round_trip(stream, 50);
+  ASSERT_EQ(received.size(), 50);
+  for (int i = 0; i < 50; ++i) {
+    EXPECT_EQ(received[i], event(i));
+  }
+}
+
+TEST(Stream, tls_verifies_peer) {
+  /// Test that the server certificate is checked against the CA file
+  Certificate certificate;
+  {
+    EchoServer server{&certificate};
+    taktile::StreamOptions options;
+    options.ca_file = certificate.pem_file();
+    taktile::CotStream stream{
+        taktile::URL(taktile::Scheme::TLS, "localhost", server.port()),
+        options};
+    EXPECT_EQ(round_trip(stream, 1).size(), 1);
+  }
+  {
+    EchoServer server{&certificate};
+    EXPECT_THROW(
+        taktile::CotStream(
+            taktile::URL(taktile::Scheme::TLS, "localhost", server.port())),
+        std::system_error);
+  }
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
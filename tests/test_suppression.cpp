@@ -0,0 +1,176 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "taktile/functions.hpp"
+#include "taktile/suppression.hpp"
+
+namespace {
+
+constexpr int64_t NOW{1700000000000};
+// About 1.1 m of latitude.
+constexpr double METER{1.0e-5};
+
+taktile::CotType track(std::string uid, double lat, int64_t stale_s = 120) {
+  auto cot = taktile::CotType(std::move(uid));
+  cot.lat = lat;
+  cot.lon = -122.4194;
+  cot.time = NOW;
+  cot.start = NOW;
+  cot.stale = NOW + stale_s * 1000;
+  return cot;
+}
+
+taktile::SuppressionOptions options() {
+  taktile::SuppressionOptions options;
+  options.min_distance_m = 5.0;
+  options.ce_fraction = 0.5;
+  options.max_interval_ms = 10000;
+  options.stale_margin_ms = 5000;
+  options.min_interval_ms = 0;
+  return options;
+}
+
+}  // namespace
+
+TEST(CotSuppressor, drops_unchanged_updates) {
+  /// Test that jitter below the threshold is dropped and that movement, a
+  /// type change, the max interval and approaching stale let updates through
+  taktile::CotSuppressor suppressor{options()};
+  auto cot = track("sensor", 37.0);
+  EXPECT_TRUE(suppressor.admit(cot, NOW));
+  cot.lat += 3 * METER;
+  EXPECT_FALSE(suppressor.admit(cot, NOW + 50));
+  cot.lat += 3 * METER;
+  EXPECT_TRUE(suppressor.admit(cot, NOW + 100));
+
+  // A wide error radius raises the threshold to half of it.
+  cot.ce = 100.0;
+  cot.lat += 40 * METER;
+  EXPECT_FALSE(suppressor.admit(cot, NOW + 150));
+  cot.lat += 10 * METER;
+  EXPECT_TRUE(suppressor.admit(cot, NOW + 200));
+
+  cot.cot_type = "a-h-G";
+  EXPECT_TRUE(suppressor.admit(cot, NOW + 250));
+  EXPECT_FALSE(suppressor.admit(cot, NOW + 300));
+  EXPECT_TRUE(suppressor.admit(cot, NOW + 250 + 10000));
+
+  auto const last = suppressor.last_sent("sensor");
+  ASSERT_TRUE(last.has_value());
+  EXPECT_EQ(last->sent, NOW + 250 + 10000);
+  EXPECT_DOUBLE_EQ(last->lat, cot.lat);
+  EXPECT_FALSE(suppressor.last_sent("other").has_value());
+
+  // The copy receivers hold goes stale before max_interval_ms comes round.
+  auto short_lived = track("short", 37.0, 6);
+  EXPECT_TRUE(suppressor.admit(short_lived, NOW));
+  EXPECT_FALSE(suppressor.admit(short_lived, NOW + 500));
+  EXPECT_TRUE(suppressor.admit(short_lived, NOW + 1000));
+
+  auto const stats = suppressor.stats();
+  EXPECT_EQ(stats.passed, 7U);
+  EXPECT_EQ(stats.suppressed, 4U);
+  EXPECT_EQ(stats.rate_limited, 0U);
+  EXPECT_EQ(stats.untracked, 0U);
+}
+
+TEST(CotSuppressor, rate_limits_each_uid) {
+  /// Test that changed updates closer together than min_interval_ms are
+  /// dropped per uid
+  auto limited = options();
+  limited.min_interval_ms = 1000;
+  taktile::CotSuppressor suppressor{limited};
+  for (int i = 0; i < 40; ++i) {
+    auto const now = NOW + i * 50;
+    suppressor.admit(track("fast", 37.0 + i * 100 * METER), now);
+    suppressor.admit(track("other", 38.0 + i * 100 * METER), now);
+  }
+  auto const stats = suppressor.stats();
+  // Each uid gets through at 0 and 1000 ms.
+  EXPECT_EQ(stats.passed, 4U);
+  EXPECT_EQ(stats.rate_limited, 76U);
+  EXPECT_EQ(stats.suppressed, 0U);
+}
+
+TEST(CotSuppressor, reuses_stale_slots) {
+  /// Test that a full table lets new uids through untracked until tracked
+  /// uids go stale
+  auto small = options();
+  small.capacity = 1;
+  taktile::CotSuppressor suppressor{small};
+  for (int i = 0; i < 16; ++i) {
+    EXPECT_TRUE(suppressor.admit(track("uid-" + std::to_string(i), 37.0, 10),
+                                 NOW));
+  }
+  auto const newcomer = track("newcomer", 37.0);
+  EXPECT_TRUE(suppressor.admit(newcomer, NOW + 100));
+  EXPECT_TRUE(suppressor.admit(newcomer, NOW + 200));
+  EXPECT_EQ(suppressor.stats().untracked, 2U);
+
+  EXPECT_TRUE(suppressor.admit(newcomer, NOW + 11000));
+  EXPECT_FALSE(suppressor.admit(newcomer, NOW + 11100));
+  EXPECT_EQ(suppressor.stats().untracked, 2U);
+  EXPECT_TRUE(suppressor.last_sent("newcomer").has_value());
+}
+
+TEST(CotSuppressor, concurrent_admit) {
+  /// Test that concurrent writers account for every update while readers
+  /// see consistent state
+  taktile::CotSuppressor suppressor{options()};
+  constexpr int THREADS{4};
+  constexpr int UPDATES{20000};
+  std::atomic<bool> done{false};
+  std::thread reader{[&suppressor, &done] {
+    while (!done) {
+      auto const last = suppressor.last_sent("shared");
+      if (last) {
+        // Written together, so the pair is never torn.
+        EXPECT_DOUBLE_EQ(last->lon, -last->lat);
+      }
+    }
+  }};
+  std::vector<std::thread> writers;
+  for (int t = 0; t < THREADS; ++t) {
+    writers.emplace_back([&suppressor, t] {
+      for (int i = 0; i < UPDATES; ++i) {
+        auto cot = track(i % 2 == 0 ? "shared" : "own-" + std::to_string(t),
+                         (i / 1000) * 0.01);
+        cot.lon = -cot.lat;
+        suppressor.admit(cot, NOW + i);
+      }
+    });
+  }
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  done = true;
+  reader.join();
+  auto const stats = suppressor.stats();
+  EXPECT_EQ(stats.passed + stats.suppressed + stats.rate_limited,
+            static_cast<uint64_t>(THREADS * UPDATES));
+  EXPECT_GT(stats.suppressed, 0U);
+}
+
+TEST(CotSuppressor, stage) {
+  /// Test that the stage function forwards only admitted updates
+  auto stage =
+      taktile::suppress_stage(std::make_shared<taktile::CotSuppressor>());
+  std::vector<taktile::CotType> out;
+  stage(taktile::CotType("staged"), out);
+  stage(taktile::CotType("staged"), out);
+  ASSERT_EQ(out.size(), 1U);
+  EXPECT_EQ(out[0].uid, "staged");
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,238 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "taktile/functions.hpp"
+#include "taktile/tak_proto.hpp"
+#include "taktile/xml_parser.hpp"
+
+namespace {
+
+taktile::CotType sample_cot() {
+  auto cot = taktile::CotType("ANDROID-589520ccfcd20f01");
+  cot.lat = 37.7749;
+  cot.lon = -122.4194;
+  cot.ce = 5;
+  cot.hae = 100;
+  cot.le = 10;
+  cot.cot_type = "a-f-G-U-C";
+  return cot;
+}
+
+void expect_same(taktile::CotType const& actual,
+                 taktile::CotType const& expected) {
+  EXPECT_EQ(actual.uid, expected.uid);
+  EXPECT_EQ(actual.cot_type, expected.cot_type);
+  EXPECT_EQ(actual.time, expected.time);
+  EXPECT_EQ(actual.start, expected.start);
+  EXPECT_EQ(actual.stale, expected.stale);
+  EXPECT_EQ(actual.lat, expected.lat);
+  EXPECT_EQ(actual.lon, expected.lon);
+  EXPECT_EQ(actual.hae, expected.hae);
+  EXPECT_EQ(actual.ce, expected.ce);
+  EXPECT_EQ(actual.le, expected.le);
+}
+
+std::string_view view(std::vector<std::byte> const& blob) {
+  return {reinterpret_cast<char const*>(blob.data()), blob.size()};
+}
+
+std::vector<std::byte> bytes(std::vector<uint8_t> const& values) {
+  std::vector<std::byte> out;
+  for (auto const value : values) {
+    out.push_back(std::byte{value});
+  }
+  return out;
+}
+
+}  // namespace
+
+TEST(TakProto, round_trip) {
+  /// Test that both framings decode to the encoded event, at well under
+  /// half the size of the XML encoding
+  auto const cot = sample_cot();
+  auto const xml = taktile::CotDirectXmlSerializer().serialize(cot);
+  for (auto const framing :
+       {taktile::TakFraming::MESH, taktile::TakFraming::STREAM}) {
+    taktile::CotProtoSerializer serializer{framing};
+    auto const blob = serializer.serialize(cot);
+    EXPECT_EQ(blob[0], taktile::TAK_MAGIC);
+    EXPECT_LT(blob.size() * 2, xml.size());
+    expect_same(serializer.deserialize(blob), cot);
+    expect_same(taktile::read_cot_proto(view(blob), framing), cot);
+  }
+  auto const mesh =
+      taktile::CotProtoSerializer(taktile::TakFraming::MESH).serialize(cot);
+  EXPECT_EQ(mesh[1], std::byte{taktile::TAK_PROTOCOL_VERSION});
+  EXPECT_EQ(mesh[2], taktile::TAK_MAGIC);
+
+  // Peers move over one at a time, so XML still decodes.
+  taktile::CotProtoSerializer serializer;
+  expect_same(serializer.deserialize(xml), taktile::read_cot_xml(view(xml)));
+}
+
+TEST(TakProto, decodes_reference_message) {
+  /// Test decoding a mesh message encoded by protoc, with takControl,
+  /// detail and submissionTime fields this decoder skips
+  auto const blob = bytes(
+      {0xbf, 0x01, 0xbf, 0x0a, 0x07, 0x08, 0x01, 0x10, 0x01, 0x1a, 0x01, 0x63,
+       0x12, 0x71, 0x0a, 0x05, 0x61, 0x2d, 0x66, 0x2d, 0x47, 0x2a, 0x06, 0x70,
+       0x65, 0x65, 0x72, 0x2d, 0x31, 0x30, 0x80, 0xd0, 0x95, 0xff, 0xbc, 0x31,
+       0x38, 0x80, 0xd0, 0x95, 0xff, 0xbc, 0x31, 0x40, 0xc0, 0xf9, 0x9c, 0xff,
+       0xbc, 0x31, 0x4a, 0x03, 0x68, 0x2d, 0x65, 0x51, 0x00, 0x00, 0x00, 0x00,
+       0x00, 0x00, 0xf8, 0x3f, 0x59, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02,
+       0xc0, 0x61, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x08, 0x40, 0x69, 0x00,
+       0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0x40, 0x71, 0x00, 0x00, 0x00, 0x00,
+       0x00, 0x00, 0x14, 0x40, 0x7a, 0x19, 0x0a, 0x17, 0x3c, 0x63, 0x6f, 0x6e,
+       0x74, 0x61, 0x63, 0x74, 0x20, 0x63, 0x61, 0x6c, 0x6c, 0x73, 0x69, 0x67,
+       0x6e, 0x3d, 0x22, 0x78, 0x22, 0x2f, 0x3e, 0x18, 0x81, 0xd0, 0x95, 0xff,
+       0xbc, 0x31});
+  auto const cot =
+      taktile::read_cot_proto(view(blob), taktile::TakFraming::MESH);
+  EXPECT_EQ(cot.uid, "peer-1");
+  EXPECT_EQ(cot.cot_type, "a-f-G");
+  EXPECT_EQ(cot.time, 1700000000000);
+  EXPECT_EQ(cot.start, 1700000000000);
+  EXPECT_EQ(cot.stale, 1700000120000);
+  EXPECT_EQ(cot.lat, 1.5);
+  EXPECT_EQ(cot.lon, -2.25);
+  EXPECT_EQ(cot.hae, 3.0);
+  EXPECT_EQ(cot.ce, 4.0);
+  EXPECT_EQ(cot.le, 5.0);
+}
+
+TEST(TakProto, rejects_malformed) {
+  /// Test that bad headers, truncation, missing events and invalid values
+  /// raise invalid_argument, and that a small buffer raises length_error
+  using taktile::TakFraming;
+  auto const mesh =
+      taktile::CotProtoSerializer(TakFraming::MESH).serialize(sample_cot());
+  auto const frame = view(mesh);
+  for (std::size_t size = 0; size < frame.size(); ++size) {
+    EXPECT_THROW(taktile::read_cot_proto(frame.substr(0, size),
+                                         TakFraming::MESH),
+                 std::invalid_argument)
+        << size;
+  }
+  auto version = mesh;
+  version[1] = std::byte{2};
+  EXPECT_THROW(taktile::read_cot_proto(view(version), TakFraming::MESH),
+               std::invalid_argument);
+  EXPECT_THROW(taktile::read_cot_proto(frame, TakFraming::STREAM),
+               std::invalid_argument);
+  // A TakMessage holding only submissionTime.
+  auto const empty = bytes({0xbf, 0x01, 0xbf, 0x18, 0x01});
+  EXPECT_THROW(taktile::read_cot_proto(view(empty), TakFraming::MESH),
+               std::invalid_argument);
+
+  auto cot = sample_cot();
+  cot.lat = 91.0;
+  auto const invalid =
+      taktile::CotProtoSerializer(TakFraming::STREAM).serialize(cot);
+  EXPECT_THROW(taktile::read_cot_proto(view(invalid), TakFraming::STREAM),
+               std::invalid_argument);
+
+  std::vector<std::byte> small(32);
+  EXPECT_THROW(taktile::write_cot_proto(sample_cot(), TakFraming::MESH,
+                                        small.data(), small.size()),
+               std::length_error);
+  EXPECT_THROW(taktile::CotProtoSerializer(TakFraming::MESH, 32)
+                   .serialize(sample_cot()),
+               std::length_error);
+
+  // Mesh messages are bounded by a datagram, stream messages are not.
+  auto const large = taktile::CotType(std::string(2000, 'x'));
+  EXPECT_THROW(taktile::CotProtoSerializer(TakFraming::MESH).serialize(large),
+               std::length_error);
+  EXPECT_NO_THROW(
+      taktile::CotProtoSerializer(TakFraming::STREAM).serialize(large));
+}
+
+TEST(TakProto, stream_framer) {
+  /// Test that frames split across arbitrary reads come out whole and in
+  /// order, and that corrupt streams are reported
+  taktile::CotProtoSerializer serializer{taktile::TakFraming::STREAM};
+  std::vector<std::byte> stream;
+  for (int i = 0; i < 3; ++i) {
+    auto cot = sample_cot();
+    cot.uid = "uid-" + std::to_string(i);
+    auto const blob = serializer.serialize(cot);
+    stream.insert(stream.end(), blob.begin(), blob.end());
+  }
+
+  taktile::TakStreamFramer framer;
+  std::vector<std::string> uids;
+  for (auto const& byte : stream) {
+    framer.append(&byte, 1);
+    while (auto const frame = framer.next()) {
+      uids.push_back(
+          taktile::read_cot_proto(*frame, taktile::TakFraming::STREAM).uid);
+    }
+  }
+  EXPECT_EQ(uids, (std::vector<std::string>{"uid-0", "uid-1", "uid-2"}));
+  EXPECT_EQ(framer.buffered(), 0U);
+
+  taktile::TakStreamFramer small{16};
+  small.append(stream.data(), stream.size());
+  EXPECT_THROW(small.next(), std::length_error);
+  taktile::TakStreamFramer xml;
+  auto const event = bytes({'<', 'e'});
+  xml.append(event.data(), event.size());
+  EXPECT_THROW(xml.next(), std::invalid_argument);
+}
+
+TEST(TakProto, negotiator) {
+  /// Test that peers start on XML and move to protobuf once they show
+  /// support, with framing chosen by scheme
+  taktile::TakProtocolNegotiator negotiator;
+  auto const mesh = taktile::URL(taktile::Scheme::UDP, "239.2.3.1", 6969);
+  auto const server = taktile::URL(taktile::Scheme::TLS, "tak.example", 8089);
+  EXPECT_EQ(negotiator.protocol(mesh), taktile::TakProtocol::XML);
+  EXPECT_EQ(negotiator.serializer(mesh)->serialize(sample_cot())[0],
+            std::byte{'<'});
+
+  auto const xml = taktile::CotDirectXmlSerializer().serialize(sample_cot());
+  EXPECT_EQ(negotiator.observe(mesh, xml.data(), xml.size()),
+            taktile::TakProtocol::XML);
+  EXPECT_EQ(negotiator.protocol(mesh), taktile::TakProtocol::XML);
+  auto const proto = taktile::CotProtoSerializer().serialize(sample_cot());
+  EXPECT_EQ(negotiator.observe(mesh, proto.data(), proto.size()),
+            taktile::TakProtocol::PROTOBUF);
+  EXPECT_EQ(negotiator.protocol(mesh), taktile::TakProtocol::PROTOBUF);
+  auto const blob = negotiator.serializer(mesh)->serialize(sample_cot());
+  EXPECT_EQ(blob[1], std::byte{taktile::TAK_PROTOCOL_VERSION});
+  EXPECT_THROW(negotiator.serializer(mesh)->serialize(
+                   taktile::CotType(std::string(2000, 'x'))),
+               std::length_error);
+
+  std::string_view const advert{
+      "<event version=\"2.0\" uid=\"protouid\" type=\"t-x-takp-v\"><detail>"
+      "<TakControl><TakProtocolSupport version=\"1\"/></TakControl>"
+      "</detail></event>"};
+  negotiator.observe(server,
+                     reinterpret_cast<std::byte const*>(advert.data()),
+                     advert.size());
+  EXPECT_EQ(negotiator.protocol(server), taktile::TakProtocol::PROTOBUF);
+  auto const framed = negotiator.serializer(server)->serialize(sample_cot());
+  EXPECT_NO_THROW(
+      taktile::read_cot_proto(view(framed), taktile::TakFraming::STREAM));
+  negotiator.set(server, taktile::TakProtocol::XML);
+  EXPECT_EQ(negotiator.protocol(server), taktile::TakProtocol::XML);
+
+  taktile::TakProtocolNegotiator xml_only{taktile::TakProtocol::XML};
+  xml_only.observe(mesh, proto.data(), proto.size());
+  EXPECT_EQ(xml_only.protocol(mesh), taktile::TakProtocol::XML);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,207 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "taktile/datetime.hpp"
+#include "taktile/functions.hpp"
+#include "taktile/track_store.hpp"
+
+namespace {
+
+/// Track that goes stale stale_ms after now.
+taktile::CotType track(std::string const& uid, int64_t now, int64_t stale_ms) {
+  auto cot = taktile::CotType(uid);
+  cot.time = now;
+  cot.start = now;
+  cot.stale = now + stale_ms;
+  return cot;
+}
+
+}  // namespace
+
+TEST(TrackStore, keeps_newest) {
+  /// Test that an older event never replaces a newer one
+  taktile::TrackStore store;
+  auto const now = taktile::now_ms();
+  auto newer = track("alpha", now, 60000);
+  newer.lat = 2.0;
+  auto older = track("alpha", now - 1000, 60000);
+  older.lat = 1.0;
+
+  EXPECT_TRUE(store.upsert(newer));
+  EXPECT_FALSE(store.upsert(older));
+  EXPECT_EQ(store.size(), 1);
+  ASSERT_NE(store.find("alpha"), nullptr);
+  EXPECT_EQ(store.find("alpha")->lat, 2.0);
+  EXPECT_EQ(store.find("bravo"), nullptr);
+}
+
+TEST(TrackStore, expires_at_stale) {
+  /// Test that tracks are removed at their stale time and not before
+  taktile::TrackStore store;
+  auto const now = taktile::now_ms();
+  store.upsert(track("alpha", now, 1000));
+  store.upsert(track("bravo", now, 2000));
+
+  EXPECT_EQ(store.expire(now + 999), 0);
+  EXPECT_EQ(store.size(), 2);
+  EXPECT_EQ(store.expire(now + 1100), 1);
+  EXPECT_EQ(store.find("alpha"), nullptr);
+  EXPECT_NE(store.find("bravo"), nullptr);
+  EXPECT_EQ(store.expire(now + 2100), 1);
+  EXPECT_EQ(store.size(), 0);
+}
+
+TEST(TrackStore, update_reschedules_expiry) {
+  /// Test that a newer event moves the track's stale deadline
+  taktile::TrackStore store;
+  auto const now = taktile::now_ms();
+  store.upsert(track("alpha", now, 1000));
+  store.upsert(track("alpha", now + 500, 10000));
+  EXPECT_EQ(store.expire(now + 5000), 0);
+  EXPECT_EQ(store.expire(now + 10600), 1);
+}
+
+TEST(TrackStore, expires_across_wheel_levels) {
+  /// Test deadlines on every wheel level and beyond its horizon
+  taktile::TrackStoreOptions options;
+  options.shards = 1;
+  taktile::TrackStore store{options};
+  auto const now = taktile::now_ms();
+  // 100 ms ticks: level 0 spans 6.4 s, the whole wheel about 19 days.
+  std::vector<int64_t> const stale_ms{
+      50, 3000, 7000, 300000, 500000, 20000000, 40000000, 3000000000};
+  for (std::size_t i = 0; i < stale_ms.size(); ++i) {
+    store.upsert(track("track-" + std::to_string(i), now, stale_ms[i]));
+  }
+  for (std::size_t i = 0; i < stale_ms.size(); ++i) {
+    EXPECT_EQ(store.expire(now + stale_ms[i] - 1), 0) << stale_ms[i];
+    EXPECT_EQ(store.expire(now + stale_ms[i] + 100), 1) << stale_ms[i];
+  }
+  EXPECT_EQ(store.size(), 0);
+}
+
+TEST(TrackStore, many_tracks) {
+  /// Test that 100k tracks expire in batches without a full scan per call
+  taktile::TrackStore store;
+  auto const now = taktile::now_ms();
+  for (int i = 0; i < 100000; ++i) {
+    store.upsert(track("track-" + std::to_string(i), now, 1000 + i % 100));
+  }
+  EXPECT_EQ(store.size(), 100000);
+  std::size_t removed{0};
+  for (int64_t t = now; t <= now + 1200; t += 10) {
+    removed += store.expire(t);
+  }
+  EXPECT_EQ(removed, 100000);
+  EXPECT_EQ(store.size(), 0);
+}
+
+TEST(TrackStore, snapshot_is_published_on_expire) {
+  /// Test that a snapshot is immutable and refreshed by expire
+  taktile::TrackStore store;
+  auto const now = taktile::now_ms();
+  store.upsert(track("alpha", now, 60000));
+  EXPECT_EQ(store.snapshot().size(), 0);
+  store.expire(now);
+  auto const before = store.snapshot();
+  EXPECT_EQ(before.size(), 1);
+
+  store.upsert(track("bravo", now, 60000));
+  store.expire(now);
+  EXPECT_EQ(before.size(), 1);
+  std::set<std::string> uids;
+  store.snapshot().for_each(
+      [&uids](taktile::Track const& track) { uids.insert(track->uid); });
+  EXPECT_EQ(uids, (std::set<std::string>{"alpha", "bravo"}));
+}
+
+TEST(TrackStore, snapshot_follows_churn_across_chunks) {
+  /// Test that republishing only changed chunks still yields every live track
+  taktile::TrackStore store{taktile::TrackStoreOptions{1, 100}};
+  auto const now = taktile::now_ms();
+  for (int i = 0; i < 2000; ++i) {
+    // Every third track goes stale early.
+    auto const stale_ms = i % 3 == 0 ? 1000 : 60000;
+    store.upsert(track("uid-" + std::to_string(i), now, stale_ms));
+  }
+  store.expire(now);
+  auto const full = store.snapshot();
+  EXPECT_EQ(full.size(), 2000);
+
+  auto update = track("uid-1", now + 500, 60000);
+  update.lat = 5.0;
+  store.upsert(update);
+  EXPECT_EQ(store.expire(now + 1100), 667);
+  EXPECT_EQ(full.size(), 2000);
+
+  std::set<std::string> uids;
+  double lat{0.0};
+  store.snapshot().for_each([&](taktile::Track const& track) {
+    uids.insert(track->uid);
+    if (track->uid == "uid-1") {
+      lat = track->lat;
+    }
+  });
+  std::set<std::string> expected;
+  for (int i = 0; i < 2000; ++i) {
+    if (i % 3 != 0) {
+      expected.insert("uid-" + std::to_string(i));
+    }
+  }
+  EXPECT_EQ(uids, expected);
+  EXPECT_EQ(lat, 5.0);
+}
+
+TEST(TrackStore, concurrent_readers_and_writers) {
+  /// Test that snapshots stay consistent while writers update
+  taktile::TrackStore store;
+  auto const now = taktile::now_ms();
+  std::atomic<bool> done{false};
+  std::atomic<bool> consistent{true};
+  std::thread reader([&] {
+    while (!done) {
+      std::size_t count{0};
+      store.snapshot().for_each([&count, &consistent](auto const& track) {
+        ++count;
+        if (track->uid.rfind("track-", 0) != 0) {
+          consistent = false;
+        }
+      });
+      if (count > 1000) {
+        consistent = false;
+      }
+    }
+  });
+  std::vector<std::thread> writers;
+  for (int w = 0; w < 4; ++w) {
+    writers.emplace_back([&store, now, w] {
+      for (int i = 0; i < 10000; ++i) {
+        store.upsert(
+            track("track-" + std::to_string(i % 1000), now + w + i, 60000));
+      }
+    });
+  }
+  for (int i = 0; i < 100; ++i) {
+    store.expire(now);
+  }
+  for (auto& writer : writers) {
+    writer.join();
+  }
+  done = true;
+  reader.join();
+  EXPECT_TRUE(consistent);
+  EXPECT_EQ(store.size(), 1000);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
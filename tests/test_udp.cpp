@@ -0,0 +1,347 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "taktile/functions.hpp"
+#include "taktile/udp.hpp"
+
+static char const* const MULTICAST_GROUP{"239.255.42.99"};
+
+/// Bound UDP socket that the tests read datagrams back from.
+class Listener {
+ public:
+  explicit Listener(char const* group = nullptr) {
+    fd_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr =
+        htonl(group == nullptr ? INADDR_LOOPBACK : INADDR_ANY);
+    ::bind(fd_, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+    socklen_t size = sizeof(address);
+    ::getsockname(fd_, reinterpret_cast<sockaddr*>(&address), &size);
+    port_ = ntohs(address.sin_port);
+    if (group != nullptr) {
+      ip_mreq request{};
+      ::inet_pton(AF_INET, group, &request.imr_multiaddr);
+      ::inet_pton(AF_INET, "127.0.0.1", &request.imr_interface);
+      joined_ = ::setsockopt(fd_, IPPROTO_IP, IP_ADD_MEMBERSHIP, &request,
+                             sizeof(request)) == 0;
+    }
+  }
+
+  ~Listener() {
+    ::close(fd_);
+  }
+
+  Listener(Listener const&) = delete;
+  Listener(Listener&&) = delete;
+  Listener& operator=(Listener const&) = delete;
+  Listener& operator=(Listener&&) = delete;
+
+  [[nodiscard]] uint16_t port() const {
+    return port_;
+  }
+
+  [[nodiscard]] bool joined() const {
+    return joined_;
+  }
+
+  /// Receive one datagram, or an empty string after a timeout.
+  std::string receive() {
+    pollfd pfd{fd_, POLLIN, 0};
+    if (::poll(&pfd, 1, 1000) != 1) {
+      return {};
+    }
+    std::array<char, taktile::MAX_UDP_BLOB_SIZE> buffer{};
+    auto const size = ::recv(fd_, buffer.data(), buffer.size(), 0);
+    return {buffer.data(), size > 0 ? static_cast<std::size_t>(size) : 0};
+  }
+
+ private:
+  int fd_{-1};
+  uint16_t port_{0};
+  bool joined_{false};
+};
+
+TEST(Udp, sender_rejects_non_udp_url) {
+  /// Test that a non-UDP URL is rejected
+  auto const url = taktile::URL(taktile::Scheme::TCP, "127.0.0.1", 8087);
+  EXPECT_THROW(taktile::CotUdpSender{url}, std::invalid_argument);
+}
+
+TEST(Udp, sender_batches_unicast) {
+  /// Test that queued messages go out in batches and arrive intact
+  Listener listener;
+  auto const url =
+      taktile::URL(taktile::Scheme::UDP, "127.0.0.1", listener.port());
+  taktile::UdpSenderOptions options;
+  options.batch_size = 4;
+  taktile::CotUdpSender sender{url, options};
+  auto serializer = taktile::CotDirectXmlSerializer();
+
+  for (int i = 0; i < 10; ++i) {
+    auto const cot = taktile::CotType("track-" + std::to_string(i));
+    EXPECT_TRUE(sender.enqueue(cot, serializer));
+  }
+  EXPECT_EQ(sender.queued(), 10);
+  auto const result = sender.flush();
+  EXPECT_EQ(result.sent, 10);
+  EXPECT_EQ(result.dropped, 0);
+  EXPECT_EQ(result.syscalls, 3);
+  EXPECT_EQ(sender.queued(), 0);
+
+  for (int i = 0; i < 10; ++i) {
+    auto const datagram = listener.receive();
+    EXPECT_NE(datagram.find("uid=\"track-" + std::to_string(i) + "\""),
+              std::string::npos);
+  }
+}
+
+TEST(Udp, sender_drops_when_full_or_oversize) {
+  /// Test that a full queue and oversize payloads are counted as drops
+  Listener listener;
+  auto const url =
+      taktile::URL(taktile::Scheme::UDP, "127.0.0.1", listener.port());
+  taktile::UdpSenderOptions options;
+  options.queue_capacity = 2;
+  taktile::CotUdpSender sender{url, options};
+  auto serializer = taktile::CotDirectXmlSerializer();
+
+  EXPECT_FALSE(sender.enqueue(
+      taktile::CotType(std::string(taktile::MAX_UDP_BLOB_SIZE, 'x')),
+      serializer));
+  EXPECT_TRUE(sender.enqueue(taktile::CotType("a"), serializer));
+  EXPECT_TRUE(sender.enqueue(taktile::CotType("b"), serializer));
+  EXPECT_FALSE(sender.enqueue(taktile::CotType("c"), serializer));
+  EXPECT_EQ(sender.stats().dropped, 2);
+  auto const result = sender.flush();
+  EXPECT_EQ(result.sent, 2);
+  EXPECT_EQ(result.dropped, 0);
+  EXPECT_EQ(result.refused, 2);
+  EXPECT_EQ(sender.stats().sent, 2);
+  EXPECT_EQ(sender.stats().dropped, 2);
+  EXPECT_EQ(sender.stats().batches, 1);
+
+  // A flush with nothing queued reports nothing and is not a batch.
+  auto const empty = sender.flush();
+  EXPECT_EQ(empty.sent, 0);
+  EXPECT_EQ(empty.dropped, 0);
+  EXPECT_EQ(empty.refused, 0);
+  EXPECT_EQ(empty.syscalls, 0);
+  EXPECT_EQ(sender.stats().batches, 1);
+}
+
+TEST(Udp, sender_sends_inline_message) {
+  /// Test that an inline message is sent as-is
+  Listener listener;
+  auto const url =
+      taktile::URL(taktile::Scheme::UDP, "127.0.0.1", listener.port());
+  taktile::CotUdpSender sender{url};
+  auto serializer = taktile::CotDirectXmlSerializer();
+  auto const message = taktile::InlineCotMessage<taktile::MAX_UDP_BLOB_SIZE>(
+      taktile::hello_event("taco"), serializer);
+  EXPECT_TRUE(sender.enqueue(message));
+  EXPECT_EQ(sender.flush().sent, 1);
+  EXPECT_EQ(listener.receive(), message.view());
+}
+
+TEST(Udp, sender_multicast_loopback) {
+  /// Test sending to a multicast group over the loopback interface
+  Listener listener{MULTICAST_GROUP};
+  if (!listener.joined()) {
+    GTEST_SKIP() << "Multicast is not available on the loopback interface";
+  }
+  auto const url =
+      taktile::URL(taktile::Scheme::UDP, MULTICAST_GROUP, listener.port());
+  taktile::UdpSenderOptions options;
+  options.interface = "127.0.0.1";
+  taktile::CotUdpSender sender{url, options};
+  auto serializer = taktile::CotDirectXmlSerializer();
+
+  EXPECT_TRUE(sender.enqueue(taktile::hello_event("taco"), serializer));
+  EXPECT_EQ(sender.flush().sent, 1);
+  EXPECT_NE(listener.receive().find("uid=\"taco\""), std::string::npos);
+}
+
+/// Wait until the receiver has seen at least count datagrams.
+static bool wait_for(taktile::CotUdpReceiver const& receiver, uint64_t count) {
+  auto const deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (receiver.stats().received < count) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+TEST(Udp, receiver_rejects_write_only_url) {
+  /// Test that a write-only URL cannot be received on
+  auto const url = taktile::URL();
+  EXPECT_THROW(
+      taktile::CotUdpReceiver(
+          url, std::make_shared<taktile::CotDirectXmlSerializer>(),
+          [](taktile::CotType&&) {}),
+      std::invalid_argument);
+}
+
+TEST(Udp, receiver_decodes_on_workers) {
+  /// Test that datagrams are decoded across sharded workers
+  std::mutex mutex;
+  std::set<std::string> uids;
+  taktile::UdpReceiverOptions options;
+  options.workers = 2;
+  taktile::CotUdpReceiver receiver{
+      taktile::URL(taktile::Scheme::UDP, "127.0.0.1", 0),
+      std::make_shared<taktile::CotDirectXmlSerializer>(),
+      [&mutex, &uids](taktile::CotType&& cot) {
+        std::lock_guard<std::mutex> const lock{mutex};
+        uids.insert(cot.uid);
+      },
+      options};
+  receiver.start();
+
+  auto const url =
+      taktile::URL(taktile::Scheme::UDP, "127.0.0.1", receiver.port());
+  taktile::CotUdpSender sender{url};
+  auto serializer = taktile::CotDirectXmlSerializer();
+  for (int i = 0; i < 100; ++i) {
+    sender.enqueue(taktile::CotType("track-" + std::to_string(i)), serializer);
+  }
+  std::string_view const garbage = "<not-cot/>";
+  sender.enqueue(reinterpret_cast<std::byte const*>(garbage.data()),
+                 garbage.size());
+  EXPECT_EQ(sender.flush().sent, 101);
+
+  ASSERT_TRUE(wait_for(receiver, 101));
+  receiver.stop();
+  auto const stats = receiver.stats();
+  EXPECT_EQ(stats.received, 101);
+  EXPECT_EQ(stats.decode_failures, 1);
+  EXPECT_EQ(stats.kernel_drops, 0);
+  EXPECT_EQ(uids.size(), 100);
+}
+
+TEST(Udp, receiver_counts_oversize_apart_from_decode_failures) {
+  /// Test that a datagram too large for a receive slot is counted as
+  /// oversize and never decoded from its truncated prefix
+  std::atomic<int> handled{0};
+  taktile::CotUdpReceiver receiver{
+      taktile::URL(taktile::Scheme::UDP, "127.0.0.1", 0),
+      std::make_shared<taktile::CotDirectXmlSerializer>(),
+      [&handled](taktile::CotType&&) { ++handled; }};
+  receiver.start();
+
+  auto serializer = taktile::CotDirectXmlSerializer();
+  auto const blob = serializer.serialize(
+      taktile::CotType(std::string(taktile::MAX_UDP_BLOB_SIZE, 'x')));
+  auto const fd = ::socket(AF_INET, SOCK_DGRAM, 0);
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  address.sin_port = htons(receiver.port());
+  ::sendto(fd, blob.data(), blob.size(), 0,
+           reinterpret_cast<sockaddr const*>(&address), sizeof(address));
+  ::close(fd);
+
+  ASSERT_TRUE(wait_for(receiver, 1));
+  receiver.stop();
+  auto const stats = receiver.stats();
+  EXPECT_EQ(stats.oversize, 1);
+  EXPECT_EQ(stats.decode_failures, 0);
+  EXPECT_EQ(handled, 0);
+}
+
+TEST(Udp, receiver_filters_before_decoding) {
+  /// Test that datagrams the filter rejects are counted and never decoded
+  std::mutex mutex;
+  std::set<std::string> uids;
+  auto filter = std::make_shared<taktile::CotFilter>();
+  filter->allow_type("a-f");
+  taktile::UdpReceiverOptions options;
+  options.filter = filter;
+  taktile::CotUdpReceiver receiver{
+      taktile::URL(taktile::Scheme::UDP, "127.0.0.1", 0),
+      std::make_shared<taktile::CotDirectXmlSerializer>(),
+      [&mutex, &uids](taktile::CotType&& cot) {
+        std::lock_guard<std::mutex> const lock{mutex};
+        uids.insert(cot.uid);
+      },
+      options};
+  receiver.start();
+
+  taktile::CotUdpSender sender{
+      taktile::URL(taktile::Scheme::UDP, "127.0.0.1", receiver.port())};
+  auto serializer = taktile::CotDirectXmlSerializer();
+  for (int i = 0; i < 10; ++i) {
+    auto cot = taktile::CotType("track-" + std::to_string(i));
+    cot.cot_type = i % 2 == 0 ? "a-f-G-U-C" : "a-h-G";
+    sender.enqueue(cot, serializer);
+  }
+  EXPECT_EQ(sender.flush().sent, 10);
+
+  ASSERT_TRUE(wait_for(receiver, 10));
+  receiver.stop();
+  auto const stats = receiver.stats();
+  EXPECT_EQ(stats.filtered, 5);
+  EXPECT_EQ(stats.decode_failures, 0);
+  EXPECT_EQ(uids, (std::set<std::string>{"track-0", "track-2", "track-4",
+                                         "track-6", "track-8"}));
+}
+
+TEST(Udp, receiver_multicast_loopback) {
+  /// Test that workers sharing a multicast socket see each datagram once
+  Listener probe{MULTICAST_GROUP};
+  if (!probe.joined()) {
+    GTEST_SKIP() << "Multicast is not available on the loopback interface";
+  }
+  std::atomic<int> handled{0};
+  taktile::UdpReceiverOptions options;
+  options.workers = 3;
+  options.interface = "127.0.0.1";
+  taktile::CotUdpReceiver receiver{
+      taktile::URL(taktile::Scheme::UDP, MULTICAST_GROUP, 0),
+      std::make_shared<taktile::CotDirectXmlSerializer>(),
+      [&handled](taktile::CotType&&) { ++handled; }, options};
+  receiver.start();
+
+  taktile::UdpSenderOptions sender_options;
+  sender_options.interface = "127.0.0.1";
+  taktile::CotUdpSender sender{
+      taktile::URL(taktile::Scheme::UDP, MULTICAST_GROUP, receiver.port()),
+      sender_options};
+  auto serializer = taktile::CotDirectXmlSerializer();
+  for (int i = 0; i < 20; ++i) {
+    sender.enqueue(taktile::hello_event("taco"), serializer);
+  }
+  EXPECT_EQ(sender.flush().sent, 20);
+
+  ASSERT_TRUE(wait_for(receiver, 20));
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  receiver.stop();
+  EXPECT_EQ(receiver.stats().received, 20);
+  EXPECT_EQ(handled, 20);
+}
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
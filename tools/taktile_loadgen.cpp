@@ -0,0 +1,116 @@
+// Copyright (c) 2025, Joe Dinius, Ph.D.
+// SPDX-License-Identifier: Apache-2.0
+//
+// Push N synthetic tracks at M Hz through taktile's serialize, UDP and
+// decode path on this host and report latency, loss and throughput.  Exits
+// with 1 if any update was lost, so runs can gate a change.
+//
+//   taktile_loadgen --tracks 1000 --rate 10 --seconds 30 --protocol proto
+#include <fmt/core.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include "taktile/functions.hpp"
+#include "taktile/loadgen.hpp"
+#include "taktile/tak_proto.hpp"
+
+namespace {
+
+constexpr std::string_view USAGE{
+    "Usage: taktile_loadgen [options]\n"
+    "  --tracks N       synthetic tracks (default 100)\n"
+    "  --rate HZ        updates per track per second (default 1)\n"
+    "  --seconds S      how long to send for (default 10)\n"
+    "  --seed N         random-walk seed (default 1)\n"
+    "  --step M         largest move per update, in meters (default 10)\n"
+    "  --url URL        UDP URL to receive on (default udp://127.0.0.1:0,\n"
+    "                   a free port)\n"
+    "  --protocol P     xml or proto (default xml)\n"
+    "  --workers N      receiver worker threads (default 1)\n"
+    "  --drain-ms N     longest wait for stragglers (default 500)\n"};
+
+double to_us(uint64_t nanoseconds) {
+  return static_cast<double>(nanoseconds) / 1e3;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  taktile::LoadOptions options;
+  std::string protocol{"xml"};
+  try {
+    for (int i = 1; i < argc; ++i) {
+      std::string_view const name{argv[i]};
+      if (name == "--help" || name == "-h") {
+        fmt::print("{}", USAGE);
+        return 0;
+      }
+      if (i + 1 == argc) {
+        throw std::invalid_argument("Missing value for " + std::string(name));
+      }
+      std::string const value{argv[++i]};
+      if (name == "--tracks") {
+        options.tracks = std::stoul(value);
+      } else if (name == "--rate") {
+        options.rate_hz = std::stod(value);
+      } else if (name == "--seconds") {
+        options.seconds = std::stod(value);
+      } else if (name == "--seed") {
+        options.seed = std::stoull(value);
+      } else if (name == "--step") {
+        options.step_m = std::stod(value);
+      } else if (name == "--url") {
+        options.url = taktile::URL(value);
+      } else if (name == "--protocol") {
+        protocol = value;
+      } else if (name == "--workers") {
+        options.workers = std::stoul(value);
+      } else if (name == "--drain-ms") {
+        options.drain = std::chrono::milliseconds(std::stol(value));
+      } else {
+        throw std::invalid_argument("Unknown option " + std::string(name));
+      }
+    }
+    if (protocol == "proto") {
+      options.serializer = std::make_shared<taktile::CotProtoSerializer>(
+          taktile::TakFraming::MESH, taktile::MAX_UDP_BLOB_SIZE);
+    } else if (protocol != "xml") {
+      throw std::invalid_argument("Unknown protocol " + protocol);
+    }
+  } catch (std::exception const& e) {
+    fmt::print(stderr, "{}\n{}", e.what(), USAGE);
+    return 2;
+  }
+
+  fmt::print("tracks={} rate_hz={} seconds={} seed={} protocol={} url={}\n",
+             options.tracks, options.rate_hz, options.seconds, options.seed,
+             protocol, taktile::to_string(options.url));
+  try {
+    auto const report = taktile::run_load(options);
+    auto const percent = [&report](uint64_t count) {
+      return report.sent == 0 ? 0.0 : 100.0 * static_cast<double>(count) /
+                                           static_cast<double>(report.sent);
+    };
+    fmt::print("sent={} received={} lost={} ({:.3f}%) reordered={} "
+               "send_drops={} kernel_drops={} foreign={}\n",
+               report.sent, report.received, report.lost,
+               percent(report.lost), report.reordered, report.send_drops,
+               report.kernel_drops, report.foreign);
+    fmt::print("events_per_second={:.1f} seconds={:.3f}\n",
+               report.events_per_second(), report.seconds);
+    fmt::print("latency_us p50={:.1f} p99={:.1f} p999={:.1f}\n",
+               to_us(report.p50_ns), to_us(report.p99_ns),
+               to_us(report.p999_ns));
+    return report.lost == 0 ? 0 : 1;
+  } catch (std::exception const& e) {
+    fmt::print(stderr, "taktile_loadgen: {}\n", e.what());
+    return 2;
+  }
+}